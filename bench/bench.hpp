@@ -0,0 +1,142 @@
+/*!
+ * @file bench/bench.hpp
+ * @brief 基准测试使用的简单计时与指令计数工具
+ *
+ * 每个基准测试将被测量的函数命名为kernel_*并标记为[[gnu::noinline]]，
+ * 使bench/Makefile中的size目标可以列出它们生成的代码大小，与手写的参照版本比较。
+ *
+ * 至少需要C++20
+ *
+ * @since Oct 14, 2026
+ */
+
+#ifndef C163Q_MY_CPP_UTILS_BENCH_BENCH_HPP
+#define C163Q_MY_CPP_UTILS_BENCH_BENCH_HPP
+
+#include"../include/core/config.hpp"
+#ifndef MY_CXX20
+    static_assert(false, "Require C++20!");
+#else
+
+#include<chrono>
+#include<cstddef>
+#include<cstdint>
+#include<cstdio>
+#include<string_view>
+#if defined(__linux__)
+#include<linux/perf_event.h>
+#include<sys/ioctl.h>
+#include<sys/syscall.h>
+#include<unistd.h>
+#endif
+
+namespace C163q::bench {
+
+    /**
+     * @brief 阻止编译器将value的计算优化掉
+     */
+    template<typename T>
+    inline void do_not_optimize(T const& value) {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        static volatile const void* sink;
+        sink = &value;
+#endif
+    }
+
+    /**
+     * @brief 统计当前线程在用户态执行的指令数
+     *
+     * Linux下使用perf_event_open，其他平台或没有权限（例如perf_event_paranoid过高、在容器中）时不可用。
+     */
+    class instruction_counter {
+    public:
+        instruction_counter() noexcept {
+#if defined(__linux__)
+            perf_event_attr attr{};
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.size = sizeof(attr);
+            attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            m_fd = int(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+        }
+
+        instruction_counter(const instruction_counter&) = delete;
+        instruction_counter& operator=(const instruction_counter&) = delete;
+
+        ~instruction_counter() {
+#if defined(__linux__)
+            if (m_fd >= 0) ::close(m_fd);
+#endif
+        }
+
+        [[nodiscard]] bool available() const noexcept {
+            return m_fd >= 0;
+        }
+
+        void start() noexcept {
+#if defined(__linux__)
+            if (m_fd < 0) return;
+            ::ioctl(m_fd, PERF_EVENT_IOC_RESET, 0);
+            ::ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+        }
+
+        /**
+         * @brief 停止计数，返回自start()以来执行的指令数，不可用时返回0
+         */
+        std::uint64_t stop() noexcept {
+            std::uint64_t count = 0;
+#if defined(__linux__)
+            if (m_fd < 0) return 0;
+            ::ioctl(m_fd, PERF_EVENT_IOC_DISABLE, 0);
+            if (::read(m_fd, &count, sizeof(count)) != ssize_t(sizeof(count))) count = 0;
+#endif
+            return count;
+        }
+
+    private:
+        int m_fd = -1;
+    };
+
+    /**
+     * @brief 运行func共iterations次，并打印每次调用的平均耗时（ns/op）以及平均执行的指令数（instr/op）
+     *
+     * 指令数不可用时（见instruction_counter）打印"n/a"。
+     *
+     * @param name       打印时使用的名称
+     * @param iterations 调用次数
+     * @param func       被测量的可调用对象，参数为当前的迭代次数
+     *
+     * @return 每次调用的平均耗时，单位为纳秒
+     */
+    template<typename F>
+    double run(std::string_view name, size_t iterations, F&& func) {
+        // 预热
+        for (size_t i = 0; i < iterations / 10; ++i) func(i);
+
+        instruction_counter counter;
+        counter.start();
+        auto begin = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; ++i) func(i);
+        auto end = std::chrono::steady_clock::now();
+        const std::uint64_t instructions = counter.stop();
+
+        double ns = std::chrono::duration<double, std::nano>(end - begin).count() / double(iterations);
+        if (counter.available()) {
+            std::printf("%-48.*s %10.3f ns/op %12.1f instr/op\n", int(name.size()), name.data(), ns,
+                    double(instructions) / double(iterations));
+        } else {
+            std::printf("%-48.*s %10.3f ns/op %12s instr/op\n", int(name.size()), name.data(), ns, "n/a");
+        }
+        return ns;
+    }
+
+}
+
+#endif // MY_CXX20
+#endif // !C163Q_MY_CPP_UTILS_BENCH_BENCH_HPP
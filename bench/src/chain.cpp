@@ -0,0 +1,91 @@
+#include"../bench.hpp"
+#include"../../include/rs/option.hpp"
+#include"../../include/rs/result.hpp"
+#include<array>
+#include<cstddef>
+#include<cstdio>
+#include<functional>
+#include<string>
+#include<utility>
+
+// 比较map链式调用在可调用对象返回值直接构造（当前实现）与先物化为临时对象再移动（legacy_map）
+// 两种方式下的耗时与移动次数。payload为只能复制的4KB缓冲区，每次移动都是一次4KB的复制。
+
+namespace {
+
+    using C163q::bench::do_not_optimize;
+
+    struct payload {
+        static inline size_t moves = 0;
+        std::array<char, 4096> data;
+
+        payload() : data{} {}
+        payload(payload&& other) noexcept : data(other.data) { ++moves; }
+        payload(const payload& other) : data(other.data) { ++moves; }
+        payload& operator=(const payload&) = default;
+    };
+
+    template<typename U, typename T, typename E, typename F>
+    C163q::Result<U, E> legacy_map(C163q::Result<T, E>&& r, F&& f) {
+        if (r.is_err()) return C163q::Result<U, E>(std::in_place_index<1>, std::move(r.template get<1>()));
+        return C163q::Result<U, E>(std::in_place_index<0>,
+                std::invoke(std::forward<F>(f), std::move(r.template get<0>())));
+    }
+
+    [[gnu::noinline]] payload step(payload&& p) {
+        payload ret;
+        ret.data[0] = char(p.data[0] + 1);
+        return ret;
+    }
+
+    [[gnu::noinline]] std::string append(std::string&& s) {
+        s.push_back('x');
+        return std::move(s);
+    }
+
+    using result_t = C163q::Result<payload, int>;
+    using string_result_t = C163q::Result<std::string, int>;
+
+}
+
+int main() {
+    constexpr size_t iterations = 2'000'000;
+
+    auto legacy_chain = [] {
+        return legacy_map<payload>(legacy_map<payload>(legacy_map<payload>(legacy_map<payload>(
+                            legacy_map<payload>(result_t(std::in_place_index<0>), step), step), step), step), step);
+    };
+    auto chain = [] {
+        return result_t(std::in_place_index<0>)
+            .map<payload>(step).map<payload>(step).map<payload>(step).map<payload>(step).map<payload>(step);
+    };
+    auto option_chain = [] {
+        return C163q::Option<payload>(std::in_place)
+            .map<payload>(step).map<payload>(step).map<payload>(step).map<payload>(step).map<payload>(step);
+    };
+
+    payload::moves = 0;
+    do_not_optimize(legacy_chain());
+    std::printf("moves per 5-step chain: legacy %zu, ", payload::moves);
+    payload::moves = 0;
+    do_not_optimize(chain());
+    std::printf("Result::map %zu, ", payload::moves);
+    payload::moves = 0;
+    do_not_optimize(option_chain());
+    std::printf("Option::map %zu\n", payload::moves);
+
+    C163q::bench::run("legacy map chain (4KB payload)", iterations, [&](size_t) { do_not_optimize(legacy_chain()); });
+    C163q::bench::run("Result::map chain (4KB payload)", iterations, [&](size_t) { do_not_optimize(chain()); });
+    C163q::bench::run("Option::map chain (4KB payload)", iterations, [&](size_t) { do_not_optimize(option_chain()); });
+
+    C163q::bench::run("legacy map chain (std::string)", iterations, [](size_t) {
+        do_not_optimize(legacy_map<std::string>(legacy_map<std::string>(legacy_map<std::string>(
+                            string_result_t(std::in_place_index<0>, "abc"), append), append), append));
+    });
+    C163q::bench::run("Result::map chain (std::string)", iterations, [](size_t) {
+        do_not_optimize(string_result_t(std::in_place_index<0>, "abc")
+                .map<std::string>(append).map<std::string>(append).map<std::string>(append));
+    });
+}
+
+// USAGE: g++ -std=c++20 -O2 -o build/bench_chain bench/src/chain.cpp src/rs/panic.cpp
@@ -0,0 +1,59 @@
+#include"../bench.hpp"
+#include"../../include/rs/coroutine.hpp"
+#include"../../include/rs/result.hpp"
+#include<cstddef>
+#include<string_view>
+
+// 比较co_await传播Err与手写的if (is_err()) return的耗时，分别测量全部成功以及在第二步失败的情况
+
+namespace {
+
+    using C163q::bench::do_not_optimize;
+    using result_t = C163q::Result<int, int>;
+
+    [[gnu::noinline]] result_t parse(std::string_view s) {
+        int value = 0;
+        for (char c : s) {
+            if (c < '0' || c > '9') return result_t(std::in_place_index<1>, int(c));
+            value = value * 10 + (c - '0');
+        }
+        return result_t(std::in_place_index<0>, value);
+    }
+
+    [[gnu::noinline]] result_t kernel_handwritten(std::string_view a, std::string_view b, std::string_view c) {
+        auto x = parse(a);
+        if (x.is_err()) return result_t(std::in_place_index<1>, x.get_uncheck<1>());
+        auto y = parse(b);
+        if (y.is_err()) return result_t(std::in_place_index<1>, y.get_uncheck<1>());
+        auto z = parse(c);
+        if (z.is_err()) return result_t(std::in_place_index<1>, z.get_uncheck<1>());
+        return result_t(std::in_place_index<0>, x.get_uncheck<0>() + y.get_uncheck<0>() + z.get_uncheck<0>());
+    }
+
+    [[gnu::noinline]] result_t kernel_coroutine(std::string_view a, std::string_view b, std::string_view c) {
+        int x = co_await parse(a);
+        int y = co_await parse(b);
+        int z = co_await parse(c);
+        co_return x + y + z;
+    }
+
+}
+
+int main() {
+    constexpr size_t iterations = 10'000'000;
+
+    C163q::bench::run("handwritten if (ok)", iterations, [](size_t) {
+        do_not_optimize(kernel_handwritten("12", "34", "56"));
+    });
+    C163q::bench::run("co_await (ok)", iterations, [](size_t) {
+        do_not_optimize(kernel_coroutine("12", "34", "56"));
+    });
+    C163q::bench::run("handwritten if (err)", iterations, [](size_t) {
+        do_not_optimize(kernel_handwritten("12", "3x", "56"));
+    });
+    C163q::bench::run("co_await (err)", iterations, [](size_t) {
+        do_not_optimize(kernel_coroutine("12", "3x", "56"));
+    });
+}
+
+// USAGE: g++ -std=c++20 -O2 -o build/bench_coroutine bench/src/coroutine.cpp src/rs/panic.cpp
@@ -0,0 +1,102 @@
+#include"../bench.hpp"
+#include"../../include/format/span.hpp"
+#include"../../include/format/spec.hpp"
+#include"../../include/format/vector.hpp"
+#include<cstddef>
+#include<cstdint>
+#include<cstdio>
+#include<format>
+#include<iterator>
+#include<random>
+#include<ranges>
+#include<span>
+#include<string>
+#include<vector>
+
+// 比较逐个元素经过std::formatter<T>与默认格式下批量std::to_chars的吞吐量。
+// 整数使用"{:|d}"强制走逐个元素的路径，其输出与"{}"完全相同。
+// C++23下标准库提供范围的格式化时，额外给出std::format("{}", range)作为参照。
+// 最后比较小vector在每次调用都解析格式与使用编译期解析好的format_spec时的耗时。
+
+namespace {
+
+    template<typename T, typename Gen>
+    std::vector<T> make_values(size_t n, Gen&& gen) {
+        std::vector<T> v;
+        v.reserve(n);
+        for (size_t i = 0; i < n; ++i) v.push_back(gen());
+        return v;
+    }
+
+    template<typename T>
+    void compare(const char* name, const std::vector<T>& values, size_t iterations) {
+        std::string out;
+        std::printf("%s, %zu elements (ns per element):\n", name, values.size());
+        double per_element = C163q::bench::run("  per element formatter", iterations, [&](size_t) {
+            out.clear();
+            auto iter = std::back_inserter(out);
+            *iter++ = '[';
+            for (size_t i = 0; i < values.size(); ++i) {
+                if (i != 0) iter = std::format_to(iter, ", ");
+                iter = std::format_to(iter, "{}", values[i]);
+            }
+            *iter++ = ']';
+            C163q::bench::do_not_optimize(out.data());
+        });
+#ifdef __cpp_lib_format_ranges
+        C163q::bench::run("  std range formatter (baseline)", iterations, [&](size_t) {
+            out.clear();
+            std::format_to(std::back_inserter(out), "{}", std::views::all(values));
+            C163q::bench::do_not_optimize(out.data());
+        });
+#endif
+        double batched = C163q::bench::run("  span formatter (batched to_chars)", iterations, [&](size_t) {
+            out.clear();
+            std::format_to(std::back_inserter(out), "{}", std::span<const T>(values));
+            C163q::bench::do_not_optimize(out.data());
+        });
+        std::printf("  (%.3f vs %.3f ns/element, %.1f MB/s)\n",
+                per_element / double(values.size()), batched / double(values.size()),
+                double(out.size()) / batched * 1e3);
+    }
+
+}
+
+int main() {
+    constexpr size_t n = 100'000;
+    constexpr size_t iterations = 50;
+    std::mt19937 gen(42);
+
+    auto ints = make_values<std::int32_t>(n, [&] { return std::int32_t(gen()); });
+    compare("int32_t", ints, iterations);
+
+    std::string out;
+    C163q::bench::run("  vector formatter \"{:|d}\" (per element)", iterations, [&](size_t) {
+        out.clear();
+        std::format_to(std::back_inserter(out), "{:|d}", ints);
+        C163q::bench::do_not_optimize(out.data());
+    });
+
+    std::uniform_real_distribution<float> dist(-1e6f, 1e6f);
+    auto floats = make_values<float>(n, [&] { return dist(gen); });
+    compare("float", floats, iterations);
+
+    auto doubles = make_values<double>(n, [&] { return double(dist(gen)) / 3.0; });
+    compare("double", doubles, iterations);
+
+    static constexpr C163q::format_spec<std::vector<double>> spec("<[\n\t<v\n\tv>\n]>|.6f");
+    std::vector small { 1.0, 2.0, 3.0 };
+    std::printf("small vector with a long spec:\n");
+    C163q::bench::run("  std::format_to with spec string", n, [&](size_t) {
+        out.clear();
+        std::format_to(std::back_inserter(out), "{:<[\n\t<v\n\tv>\n]>|.6f}", small);
+        C163q::bench::do_not_optimize(out.data());
+    });
+    C163q::bench::run("  std::format_to with format_spec", n, [&](size_t) {
+        out.clear();
+        std::format_to(std::back_inserter(out), "{}", C163q::with_spec(spec, small));
+        C163q::bench::do_not_optimize(out.data());
+    });
+}
+
+// USAGE: g++ -std=c++20 -O2 -o build/bench_format bench/src/format.cpp
@@ -0,0 +1,92 @@
+#include"../bench.hpp"
+#include"../../include/rs/match.hpp"
+#include<algorithm>
+#include<cstddef>
+#include<cstdint>
+#include<cstdio>
+#include<random>
+#include<variant>
+#include<vector>
+
+// 比较逐个match与match_range（分桶）在随机顺序和按类型排序的输入上的耗时，
+// 以及直接使用std::visit的参照版本。
+// 随机顺序时逐个match的间接跳转几乎无法预测，分桶后每个桶内只有一个直接调用。
+
+namespace {
+
+    template<int N>
+    struct msg {
+        std::uint32_t value;
+    };
+
+    using message = std::variant<msg<0>, msg<1>, msg<2>, msg<3>, msg<4>, msg<5>, msg<6>, msg<7>>;
+
+    std::vector<message> make_messages(size_t n, bool sorted) {
+        std::mt19937 gen(42);
+        std::uniform_int_distribution<int> kind(0, 7);
+        std::vector<message> v;
+        v.reserve(n);
+        for (size_t i = 0; i < n; ++i) {
+            auto value = std::uint32_t(gen());
+            switch (kind(gen)) {
+                case 0: v.emplace_back(msg<0>{ value }); break;
+                case 1: v.emplace_back(msg<1>{ value }); break;
+                case 2: v.emplace_back(msg<2>{ value }); break;
+                case 3: v.emplace_back(msg<3>{ value }); break;
+                case 4: v.emplace_back(msg<4>{ value }); break;
+                case 5: v.emplace_back(msg<5>{ value }); break;
+                case 6: v.emplace_back(msg<6>{ value }); break;
+                default: v.emplace_back(msg<7>{ value }); break;
+            }
+        }
+        if (sorted) std::stable_sort(v.begin(), v.end(),
+                [](const message& a, const message& b) { return a.index() < b.index(); });
+        return v;
+    }
+
+    // 每种消息的处理方式不同，避免编译器将所有分支合并
+    template<typename Sum>
+    auto handlers(Sum& sum) {
+        return C163q::overload{
+            [&](const msg<0>& m) { sum += m.value; },
+            [&](const msg<1>& m) { sum += m.value * 3; },
+            [&](const msg<2>& m) { sum ^= m.value; },
+            [&](const msg<3>& m) { sum += m.value >> 3; },
+            [&](const msg<4>& m) { sum -= m.value; },
+            [&](const msg<5>& m) { sum += m.value & 0xff; },
+            [&](const msg<6>& m) { sum += m.value * 7; },
+            [&](const msg<7>& m) { sum |= m.value & 1; },
+        };
+    }
+
+}
+
+int main() {
+    constexpr size_t n = 1'000'000;
+    constexpr size_t iterations = 20;
+
+    for (bool sorted : { false, true }) {
+        auto messages = make_messages(n, sorted);
+        std::printf("%s input, %zu messages (ns per message):\n", sorted ? "sorted" : "random", n);
+        C163q::bench::run("  std::visit per element (baseline)", iterations, [&](size_t) {
+            std::uint64_t sum = 0;
+            auto h = handlers(sum);
+            for (const auto& m : messages) std::visit(h, m);
+            C163q::bench::do_not_optimize(sum);
+        });
+        double per_element = C163q::bench::run("  match per element", iterations, [&](size_t) {
+            std::uint64_t sum = 0;
+            auto h = handlers(sum);
+            for (const auto& m : messages) C163q::match(m, h);
+            C163q::bench::do_not_optimize(sum);
+        });
+        double bucketed = C163q::bench::run("  match_range (bucketed)", iterations, [&](size_t) {
+            std::uint64_t sum = 0;
+            C163q::match_range(messages, handlers(sum));
+            C163q::bench::do_not_optimize(sum);
+        });
+        std::printf("  (%.3f vs %.3f ns/message)\n", per_element / n, bucketed / n);
+    }
+}
+
+// USAGE: g++ -std=c++20 -O2 -o build/bench_match bench/src/match.cpp
@@ -0,0 +1,79 @@
+#include"../bench.hpp"
+#include"../../include/rs/option.hpp"
+#include<cstddef>
+#include<cstdint>
+#include<cstdio>
+#include<optional>
+
+// 比较同一条map/and_then/map/unwrap_or链使用Option与std::optional（手写的分支）的耗时，
+// 以及Option<T&>与裸指针的比较。
+
+namespace {
+
+    [[gnu::noinline]] C163q::Option<std::uint64_t> find(std::uint64_t v) {
+        if (v % 97 == 0) return C163q::None<std::uint64_t>();
+        return C163q::Some(v);
+    }
+
+    [[gnu::noinline]] std::uint64_t kernel_option_chain(std::uint64_t v) {
+        return find(v)
+            .map<std::uint64_t>([](std::uint64_t x) { return x * 3; })
+            .and_then<std::uint64_t>([](std::uint64_t x) {
+                if (x > (std::uint64_t(1) << 62)) return C163q::None<std::uint64_t>();
+                return C163q::Some(x + 1);
+            })
+            .map<std::uint64_t>([](std::uint64_t x) { return x ^ 0x5a5a; })
+            .unwrap_or(0);
+    }
+
+    [[gnu::noinline]] std::optional<std::uint64_t> find_optional(std::uint64_t v) {
+        if (v % 97 == 0) return std::nullopt;
+        return v;
+    }
+
+    [[gnu::noinline]] std::uint64_t kernel_optional_chain(std::uint64_t v) {
+        auto o = find_optional(v);
+        if (!o) return 0;
+        std::uint64_t x = *o * 3;
+        if (x > (std::uint64_t(1) << 62)) return 0;
+        return (x + 1) ^ 0x5a5a;
+    }
+
+    std::uint64_t table[97];
+
+    [[gnu::noinline]] C163q::Option<std::uint64_t&> find_ref(std::uint64_t v) {
+        if (v % 97 == 0) return C163q::Option<std::uint64_t&>();
+        return C163q::Option<std::uint64_t&>(std::in_place, table[v % 97]);
+    }
+
+    [[gnu::noinline]] std::uint64_t kernel_option_ref(std::uint64_t v) {
+        return find_ref(v).map<std::uint64_t>([](std::uint64_t& x) { return x + 1; }).unwrap_or(0);
+    }
+
+    [[gnu::noinline]] std::uint64_t* find_pointer(std::uint64_t v) {
+        if (v % 97 == 0) return nullptr;
+        return &table[v % 97];
+    }
+
+    [[gnu::noinline]] std::uint64_t kernel_pointer(std::uint64_t v) {
+        auto p = find_pointer(v);
+        return p ? *p + 1 : 0;
+    }
+
+}
+
+int main() {
+    constexpr size_t iterations = 50'000'000;
+    for (size_t i = 0; i < 97; ++i) table[i] = i * i;
+
+    C163q::bench::run("std::optional + branches (baseline)", iterations,
+            [](size_t i) { C163q::bench::do_not_optimize(kernel_optional_chain(i)); });
+    C163q::bench::run("Option map/and_then/map/unwrap_or", iterations,
+            [](size_t i) { C163q::bench::do_not_optimize(kernel_option_chain(i)); });
+    C163q::bench::run("raw pointer (baseline)", iterations,
+            [](size_t i) { C163q::bench::do_not_optimize(kernel_pointer(i)); });
+    C163q::bench::run("Option<T&> map/unwrap_or", iterations,
+            [](size_t i) { C163q::bench::do_not_optimize(kernel_option_ref(i)); });
+}
+
+// USAGE: g++ -std=c++20 -O2 -o build/bench_option bench/src/option.cpp src/rs/panic.cpp
@@ -0,0 +1,79 @@
+#include"../bench.hpp"
+#include"../../include/rs/option_vector.hpp"
+#include<algorithm>
+#include<cstddef>
+#include<vector>
+
+// 比较std::vector<Option<double>>与option_vector<double>上统计Some的个数、对Some求和以及填充None的耗时
+
+namespace {
+
+    using C163q::bench::do_not_optimize;
+
+    [[gnu::noinline]] size_t kernel_count_aos(const std::vector<C163q::Option<double>>& v) {
+        size_t n = 0;
+        for (const auto& o : v) n += o.is_some();
+        return n;
+    }
+
+    [[gnu::noinline]] size_t kernel_count_soa(const C163q::option_vector<double>& v) {
+        return v.count_some();
+    }
+
+    [[gnu::noinline]] double kernel_sum_aos(const std::vector<C163q::Option<double>>& v) {
+        double sum = 0;
+        for (const auto& o : v) sum += o.unwrap_or(0.0);
+        return sum;
+    }
+
+    [[gnu::noinline]] double kernel_sum_soa(const C163q::option_vector<double>& v) {
+        // 直接使用值数组与位图，内层循环没有分支
+        auto values = v.values();
+        auto words = v.validity();
+        double sum = 0;
+        for (size_t k = 0; k < words.size(); ++k) {
+            size_t len = std::min<size_t>(64, values.size() - k * 64);
+            for (size_t j = 0; j < len; ++j) sum += ((words[k] >> j) & 1) ? values[k * 64 + j] : 0.0;
+        }
+        return sum;
+    }
+
+    [[gnu::noinline]] std::vector<double> kernel_unwrap_or_aos(const std::vector<C163q::Option<double>>& v) {
+        std::vector<double> ret(v.size());
+        for (size_t i = 0; i < v.size(); ++i) ret[i] = v[i].unwrap_or(0.0);
+        return ret;
+    }
+
+    [[gnu::noinline]] std::vector<double> kernel_unwrap_or_soa(const C163q::option_vector<double>& v) {
+        return v.unwrap_or(0.0);
+    }
+
+}
+
+int main() {
+    constexpr size_t iterations = 200;
+    constexpr size_t n = 1 << 20;
+    std::vector<C163q::Option<double>> aos;
+    C163q::option_vector<double> soa;
+    aos.reserve(n);
+    soa.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        // 大段连续的Some中夹杂少量None
+        auto o = (i % 1000 < 990) ? C163q::Some(double(i)) : C163q::None<double>();
+        aos.push_back(o);
+        soa.push_back(o);
+    }
+
+    C163q::bench::run("count_some vector<Option>", iterations, [&](size_t) { do_not_optimize(kernel_count_aos(aos)); });
+    C163q::bench::run("count_some option_vector", iterations, [&](size_t) { do_not_optimize(kernel_count_soa(soa)); });
+    C163q::bench::run("sum vector<Option>", iterations, [&](size_t) { do_not_optimize(kernel_sum_aos(aos)); });
+    C163q::bench::run("sum option_vector", iterations, [&](size_t) { do_not_optimize(kernel_sum_soa(soa)); });
+    C163q::bench::run("unwrap_or vector<Option>", iterations, [&](size_t) {
+        do_not_optimize(kernel_unwrap_or_aos(aos));
+    });
+    C163q::bench::run("unwrap_or option_vector", iterations, [&](size_t) {
+        do_not_optimize(kernel_unwrap_or_soa(soa));
+    });
+}
+
+// USAGE: g++ -std=c++20 -O2 -o build/bench_option_vector bench/src/option_vector.cpp src/rs/panic.cpp
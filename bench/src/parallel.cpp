@@ -0,0 +1,61 @@
+#include"../bench.hpp"
+#include"../../include/rs/parallel.hpp"
+#include"../../include/rs/ranges.hpp"
+#include"../../include/rs/result.hpp"
+#include<cstddef>
+#include<numeric>
+#include<ranges>
+#include<vector>
+
+// 比较串行的collect_result与try_transform（seq/par），以及在中间出现Err时par的提前停止
+
+namespace {
+
+    using C163q::bench::do_not_optimize;
+    using result_t = C163q::Result<int, int>;
+
+    result_t check(int x) {
+        // 模拟每条记录少量的处理
+        int h = x;
+        for (int i = 0; i < 16; ++i) h = h * 31 + i;
+        if (x < 0) return result_t(std::in_place_index<1>, x);
+        return result_t(std::in_place_index<0>, h);
+    }
+
+    [[gnu::noinline]] auto kernel_collect(const std::vector<int>& in) {
+        return C163q::collect_result(in | std::views::transform(check));
+    }
+
+    [[gnu::noinline]] auto kernel_try_transform_seq(const std::vector<int>& in) {
+        return C163q::try_transform(C163q::execution::seq, in, check);
+    }
+
+    [[gnu::noinline]] auto kernel_try_transform_par(const std::vector<int>& in) {
+        return C163q::try_transform(C163q::execution::par, in, check);
+    }
+
+}
+
+int main() {
+    constexpr size_t iterations = 200;
+    std::vector<int> input(1 << 20);
+    std::iota(input.begin(), input.end(), 0);
+    std::vector<int> bad = input;
+    bad[bad.size() / 2] = -1;
+
+    C163q::bench::run("collect_result (ok)", iterations, [&](size_t) { do_not_optimize(kernel_collect(input)); });
+    C163q::bench::run("try_transform seq (ok)", iterations, [&](size_t) {
+        do_not_optimize(kernel_try_transform_seq(input));
+    });
+    C163q::bench::run("try_transform par (ok)", iterations, [&](size_t) {
+        do_not_optimize(kernel_try_transform_par(input));
+    });
+    C163q::bench::run("collect_result (err at 1/2)", iterations, [&](size_t) {
+        do_not_optimize(kernel_collect(bad));
+    });
+    C163q::bench::run("try_transform par (err at 1/2)", iterations, [&](size_t) {
+        do_not_optimize(kernel_try_transform_par(bad));
+    });
+}
+
+// USAGE: g++ -std=c++20 -O2 -pthread -o build/bench_parallel bench/src/parallel.cpp src/rs/panic.cpp src/rs/thread_pool.cpp
@@ -0,0 +1,88 @@
+#include"../bench.hpp"
+#include"../../include/rs/result.hpp"
+#include<cstddef>
+#include<cstdint>
+#include<cstdio>
+#include<type_traits>
+#include<variant>
+
+// 比较同一条map/and_then/map/unwrap_or链使用Result、手写的错误码返回以及std::variant + std::visit的耗时。
+// 错误码版本即不使用任何抽象时的写法，作为Result的开销下限。
+// std::expected的比较见result23.cpp。
+
+namespace {
+
+    enum class Errc : int { none, odd, overflow };
+
+    using R = C163q::Result<std::uint64_t, Errc>;
+
+    [[gnu::noinline]] R parse(std::uint64_t v) {
+        if (v % 97 == 0) return R(std::in_place_index<1>, Errc::odd);
+        return R(std::in_place_index<0>, v);
+    }
+
+    [[gnu::noinline]] std::uint64_t kernel_result_chain(std::uint64_t v) {
+        return parse(v)
+            .map<std::uint64_t>([](std::uint64_t x) { return x * 3; })
+            .and_then<std::uint64_t>([](std::uint64_t x) {
+                if (x > (std::uint64_t(1) << 62)) return R(std::in_place_index<1>, Errc::overflow);
+                return R(std::in_place_index<0>, x + 1);
+            })
+            .map<std::uint64_t>([](std::uint64_t x) { return x ^ 0x5a5a; })
+            .unwrap_or(0);
+    }
+
+    [[gnu::noinline]] Errc parse_errc(std::uint64_t v, std::uint64_t& out) {
+        if (v % 97 == 0) return Errc::odd;
+        out = v;
+        return Errc::none;
+    }
+
+    [[gnu::noinline]] std::uint64_t kernel_errc_chain(std::uint64_t v) {
+        std::uint64_t x;
+        if (parse_errc(v, x) != Errc::none) return 0;
+        x *= 3;
+        if (x > (std::uint64_t(1) << 62)) return 0;
+        x += 1;
+        return x ^ 0x5a5a;
+    }
+
+    using V = std::variant<std::uint64_t, Errc>;
+
+    [[gnu::noinline]] V parse_variant(std::uint64_t v) {
+        if (v % 97 == 0) return V(std::in_place_index<1>, Errc::odd);
+        return V(std::in_place_index<0>, v);
+    }
+
+    [[gnu::noinline]] std::uint64_t kernel_variant_chain(std::uint64_t v) {
+        V r = parse_variant(v);
+        r = std::visit([](auto x) -> V {
+            if constexpr (std::is_same_v<decltype(x), Errc>) return x;
+            else return x * 3;
+        }, r);
+        r = std::visit([](auto x) -> V {
+            if constexpr (std::is_same_v<decltype(x), Errc>) return x;
+            else if (x > (std::uint64_t(1) << 62)) return Errc::overflow;
+            else return x + 1;
+        }, r);
+        r = std::visit([](auto x) -> V {
+            if constexpr (std::is_same_v<decltype(x), Errc>) return x;
+            else return x ^ 0x5a5a;
+        }, r);
+        if (auto p = std::get_if<0>(&r)) return *p;
+        return 0;
+    }
+
+}
+
+int main() {
+    constexpr size_t iterations = 50'000'000;
+    C163q::bench::run("error code return (baseline)", iterations,
+            [](size_t i) { C163q::bench::do_not_optimize(kernel_errc_chain(i)); });
+    C163q::bench::run("Result map/and_then/map/unwrap_or", iterations,
+            [](size_t i) { C163q::bench::do_not_optimize(kernel_result_chain(i)); });
+    C163q::bench::run("std::variant + std::visit", iterations,
+            [](size_t i) { C163q::bench::do_not_optimize(kernel_variant_chain(i)); });
+}
+
+// USAGE: g++ -std=c++20 -O2 -o build/bench_result bench/src/result.cpp src/rs/panic.cpp
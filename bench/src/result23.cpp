@@ -0,0 +1,148 @@
+#include"../bench.hpp"
+#include"../../include/rs/result.hpp"
+#include<cstddef>
+#include<cstdint>
+#include<cstdio>
+#include<expected>
+#include<string>
+#include<variant>
+
+// 比较同一条and_then/map链在不同存储下的耗时：
+// Result<std::uint64_t, Errc>的两个类型都是平凡可复制的，默认编译时使用与std::expected布局相同的平凡联合体存储；
+// Result<std::string, Errc>不是平凡可复制的，默认编译时才真正使用std::expected存储。
+// 定义MY_RESULT_VARIANT_STORAGE后两者都使用std::variant存储。
+// 同时给出直接使用std::expected与std::variant手写的版本作为参照。
+//
+// 注意：std::expected存储只对平凡可复制的类型保证省去std::variant的额外开销；对于std::string这样非平凡的类型，
+// 每一步的移动构造占主要部分，std::expected存储并不一定更快，甚至可能比std::variant存储更慢，
+// 应当以实际编译器（GCC 13及以上，或者带有<expected>与<format>的Clang）的测量结果为准。
+
+namespace {
+
+    enum class Errc : int { none, odd, overflow };
+
+    using R = C163q::Result<std::uint64_t, Errc>;
+
+    [[gnu::noinline]] R parse(std::uint64_t v) {
+        if (v % 97 == 0) return R(std::in_place_index<1>, Errc::odd);
+        return R(std::in_place_index<0>, v);
+    }
+
+    [[gnu::noinline]] std::uint64_t kernel_result_chain(std::uint64_t v) {
+        return parse(v)
+            .map<std::uint64_t>([](std::uint64_t x) { return x * 3; })
+            .and_then<std::uint64_t>([](std::uint64_t x) {
+                if (x > (std::uint64_t(1) << 62)) return R(std::in_place_index<1>, Errc::overflow);
+                return R(std::in_place_index<0>, x + 1);
+            })
+            .map<std::uint64_t>([](std::uint64_t x) { return x ^ 0x5a5a; })
+            .unwrap_or(0);
+    }
+
+    using X = std::expected<std::uint64_t, Errc>;
+
+    [[gnu::noinline]] X parse_expected(std::uint64_t v) {
+        if (v % 97 == 0) return std::unexpected(Errc::odd);
+        return v;
+    }
+
+    [[gnu::noinline]] std::uint64_t kernel_expected_chain(std::uint64_t v) {
+        return parse_expected(v)
+            .transform([](std::uint64_t x) { return x * 3; })
+            .and_then([](std::uint64_t x) -> X {
+                if (x > (std::uint64_t(1) << 62)) return std::unexpected(Errc::overflow);
+                return x + 1;
+            })
+            .transform([](std::uint64_t x) { return x ^ 0x5a5a; })
+            .value_or(0);
+    }
+
+    // 非平凡的Ok类型，字符串都不超过短字符串优化的长度，测量的是分支与移动而不是内存分配
+    using S = C163q::Result<std::string, Errc>;
+
+    [[gnu::noinline]] S parse_text(std::uint64_t v) {
+        if (v % 97 == 0) return S(std::in_place_index<1>, Errc::odd);
+        return S(std::in_place_index<0>, std::to_string(v));
+    }
+
+    [[gnu::noinline]] std::size_t kernel_result_string_chain(std::uint64_t v) {
+        return parse_text(v)
+            .map<std::string>([](std::string s) { s.push_back('0'); return s; })
+            .and_then<std::string>([](std::string s) {
+                if (s.size() > 12) return S(std::in_place_index<1>, Errc::overflow);
+                s.push_back('1');
+                return S(std::in_place_index<0>, std::move(s));
+            })
+            .map<std::size_t>([](const std::string& s) { return s.size() + std::size_t(s.front()); })
+            .unwrap_or(0);
+    }
+
+    using XS = std::expected<std::string, Errc>;
+
+    [[gnu::noinline]] XS parse_text_expected(std::uint64_t v) {
+        if (v % 97 == 0) return std::unexpected(Errc::odd);
+        return std::to_string(v);
+    }
+
+    [[gnu::noinline]] std::size_t kernel_expected_string_chain(std::uint64_t v) {
+        return parse_text_expected(v)
+            .transform([](std::string s) { s.push_back('0'); return s; })
+            .and_then([](std::string s) -> XS {
+                if (s.size() > 12) return std::unexpected(Errc::overflow);
+                s.push_back('1');
+                return s;
+            })
+            .transform([](const std::string& s) { return s.size() + std::size_t(s.front()); })
+            .value_or(0);
+    }
+
+    using V = std::variant<std::uint64_t, Errc>;
+
+    [[gnu::noinline]] V parse_variant(std::uint64_t v) {
+        if (v % 97 == 0) return V(std::in_place_index<1>, Errc::odd);
+        return V(std::in_place_index<0>, v);
+    }
+
+    [[gnu::noinline]] std::uint64_t kernel_variant_chain(std::uint64_t v) {
+        V r = parse_variant(v);
+        r = std::visit([](auto x) -> V {
+            if constexpr (std::is_same_v<decltype(x), Errc>) return x;
+            else return x * 3;
+        }, r);
+        r = std::visit([](auto x) -> V {
+            if constexpr (std::is_same_v<decltype(x), Errc>) return x;
+            else if (x > (std::uint64_t(1) << 62)) return Errc::overflow;
+            else return x + 1;
+        }, r);
+        r = std::visit([](auto x) -> V {
+            if constexpr (std::is_same_v<decltype(x), Errc>) return x;
+            else return x ^ 0x5a5a;
+        }, r);
+        if (auto p = std::get_if<0>(&r)) return *p;
+        return 0;
+    }
+
+}
+
+int main() {
+    constexpr size_t iterations = 50'000'000;
+#ifdef MY_RESULT_VARIANT_STORAGE
+    std::puts("Result storage: std::variant");
+#else
+    std::puts("Result storage: trivial union for <uint64_t, Errc>, std::expected for <std::string, Errc>");
+#endif
+    C163q::bench::run("Result map/and_then/map/unwrap_or", iterations,
+            [](size_t i) { C163q::bench::do_not_optimize(kernel_result_chain(i)); });
+    C163q::bench::run("std::expected transform/and_then/transform", iterations,
+            [](size_t i) { C163q::bench::do_not_optimize(kernel_expected_chain(i)); });
+    C163q::bench::run("std::variant + std::visit", iterations,
+            [](size_t i) { C163q::bench::do_not_optimize(kernel_variant_chain(i)); });
+    C163q::bench::run("Result<std::string> map/and_then/map/unwrap_or", iterations,
+            [](size_t i) { C163q::bench::do_not_optimize(kernel_result_string_chain(i)); });
+    C163q::bench::run("std::expected<std::string> transform/and_then/transform", iterations,
+            [](size_t i) { C163q::bench::do_not_optimize(kernel_expected_string_chain(i)); });
+}
+
+// USAGE:
+// g++ -std=c++23 -O2 -o build/bench_result23 bench/src/result23.cpp src/rs/panic.cpp -lstdc++exp
+// g++ -std=c++23 -O2 -DMY_RESULT_VARIANT_STORAGE -o build/bench_result23_variant bench/src/result23.cpp src/rs/panic.cpp -lstdc++exp
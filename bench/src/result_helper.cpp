@@ -0,0 +1,73 @@
+#include"../bench.hpp"
+#include"../../include/rs/result.hpp"
+#include<cstddef>
+#include<cstdint>
+#include<cstdio>
+#include<exception>
+#include<functional>
+#include<stdexcept>
+#include<utility>
+
+// 比较result_helper::invoke在noexcept快速路径与try/catch路径下的耗时，
+// 以及try_invoke在成功和抛出异常两种情况下的耗时。
+// legacy_invoke为引入快速路径之前的实现，作为参照。
+
+namespace {
+
+    using C163q::bench::do_not_optimize;
+
+    template<typename E, typename F, typename ...Args>
+    auto legacy_invoke(F&& f, Args&&... args) {
+        using Type = std::invoke_result_t<F, Args...>;
+        try {
+            return C163q::Result<Type, E>(std::in_place_index<0>,
+                    std::invoke(std::forward<F>(f), std::forward<Args>(args)...));
+        } catch (E& e) {
+            return C163q::Result<Type, E>(std::in_place_index<1>, std::move(e));
+        }
+    }
+
+    [[gnu::noinline]] std::uint64_t square_noexcept(std::uint64_t v) noexcept {
+        return v * v;
+    }
+
+    [[gnu::noinline]] std::uint64_t square_may_throw(std::uint64_t v) {
+        if (v == std::uint64_t(-1)) throw std::runtime_error("unreachable");
+        return v * v;
+    }
+
+    [[gnu::noinline]] std::uint64_t always_throw(std::uint64_t v) {
+        if (v != std::uint64_t(-1)) throw std::runtime_error("error");
+        return v;
+    }
+
+    using helper = C163q::result_helper<std::runtime_error>;
+
+}
+
+int main() {
+    constexpr size_t iterations = 50'000'000;
+    constexpr size_t throw_iterations = 1'000'000;
+
+    std::puts("success path:");
+    C163q::bench::run("legacy invoke (noexcept callable)", iterations,
+            [](size_t i) { do_not_optimize(legacy_invoke<std::runtime_error>(square_noexcept, i)); });
+    C163q::bench::run("result_helper::invoke (noexcept callable)", iterations,
+            [](size_t i) { do_not_optimize(helper::invoke(square_noexcept, i)); });
+    C163q::bench::run("result_helper::invoke (may throw)", iterations,
+            [](size_t i) { do_not_optimize(helper::invoke(square_may_throw, i)); });
+    C163q::bench::run("try_invoke (noexcept callable)", iterations,
+            [](size_t i) { do_not_optimize(C163q::try_invoke(square_noexcept, i)); });
+    C163q::bench::run("try_invoke (may throw)", iterations,
+            [](size_t i) { do_not_optimize(C163q::try_invoke(square_may_throw, i)); });
+
+    std::puts("throwing path:");
+    C163q::bench::run("legacy invoke", throw_iterations,
+            [](size_t i) { do_not_optimize(legacy_invoke<std::runtime_error>(always_throw, i)); });
+    C163q::bench::run("result_helper::invoke", throw_iterations,
+            [](size_t i) { do_not_optimize(helper::invoke(always_throw, i)); });
+    C163q::bench::run("try_invoke", throw_iterations,
+            [](size_t i) { do_not_optimize(C163q::try_invoke(always_throw, i)); });
+}
+
+// USAGE: g++ -std=c++20 -O2 -o build/bench_result_helper bench/src/result_helper.cpp src/rs/panic.cpp
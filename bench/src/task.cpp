@@ -0,0 +1,47 @@
+#include"../bench.hpp"
+#include"../../include/rs/result.hpp"
+#include"../../include/rs/task.hpp"
+#include"../../include/rs/thread_pool.hpp"
+#include<cstddef>
+#include<string>
+#include<thread>
+
+// 以when_all递归地并行求和，比较不同工作线程数下每次求和的耗时，用于观察工作窃取的扩展性
+
+namespace {
+
+    using C163q::bench::do_not_optimize;
+    using result_t = C163q::Result<long, int>;
+
+    C163q::task<result_t> range_sum(long lo, long hi) {
+        if (hi - lo <= 256) {
+            long s = 0;
+            for (long i = lo; i < hi; ++i) do_not_optimize(s += i);
+            co_return s;
+        }
+        long mid = lo + (hi - lo) / 2;
+        auto [l, r] = co_await co_await C163q::when_all(range_sum(lo, mid), range_sum(mid, hi));
+        co_return l + r;
+    }
+
+    [[gnu::noinline]] result_t kernel_parallel_sum(C163q::thread_pool& pool, long n) {
+        return C163q::sync_wait(pool, range_sum(0, n));
+    }
+
+}
+
+int main() {
+    constexpr size_t iterations = 200;
+    constexpr long n = 1 << 20;
+
+    size_t hardware = std::thread::hardware_concurrency();
+    for (size_t threads = 1; ; threads *= 2) {
+        if (threads > hardware) threads = hardware;
+        C163q::thread_pool pool(threads);
+        C163q::bench::run("when_all sum, " + std::to_string(threads) + " threads", iterations,
+                [&](size_t) { do_not_optimize(kernel_parallel_sum(pool, n)); });
+        if (threads == hardware) break;
+    }
+}
+
+// USAGE: g++ -std=c++20 -O2 -pthread -o build/bench_task bench/src/task.cpp src/rs/panic.cpp src/rs/thread_pool.cpp
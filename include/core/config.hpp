@@ -36,4 +36,56 @@
 #endif // !defined (MY_CXX17)
 
 
+// MSVC会忽略[[no_unique_address]]，需要使用[[msvc::no_unique_address]]
+#if defined(_MSC_VER) && !defined(__clang__)
+    #define MY_NO_UNIQUE_ADDRESS [[msvc::no_unique_address]]
+#else
+    #define MY_NO_UNIQUE_ADDRESS [[no_unique_address]]
+#endif
+
+
+// 标记很少被执行的函数（例如panic），使其被放入冷代码段，调用处的分支也会被视为不太可能发生
+#if defined(__GNUC__) || defined(__clang__)
+    #define MY_COLD [[gnu::cold]]
+#else
+    #define MY_COLD
+#endif
+
+
+// 告知编译器cond恒为真，使其可以省去由cond决定的分支；cond为假时行为未定义
+#if defined(__has_cpp_attribute)
+    #if __has_cpp_attribute(assume) >= 202207L
+        #define MY_ASSUME(cond) [[assume(cond)]]
+    #endif
+#endif
+#if !defined(MY_ASSUME)
+    #if defined(__clang__)
+        #define MY_ASSUME(cond) __builtin_assume(cond)
+    #elif defined(__GNUC__)
+        #define MY_ASSUME(cond) do { if (!(cond)) __builtin_unreachable(); } while(0)
+    #elif defined(_MSC_VER)
+        #define MY_ASSUME(cond) __assume(cond)
+    #else
+        #define MY_ASSUME(cond) ((void) 0)
+    #endif
+#endif
+
+
+// 未检查的访问函数（Option::get_uncheck()、Result::unwrap_unchecked()等）的前置条件：
+// - 定义MY_UTILS_HARDENED时，前置条件不满足会导致panic，并打印调用处的源代码位置，
+//   此时这些函数不再是noexcept的（使用panic_strategy::unwind时会抛出panic_error）；
+// - 否则前置条件通过MY_ASSUME告知编译器，不产生任何检查。
+// 该宏必须在整个程序中保持一致。
+#ifdef MY_UTILS_HARDENED
+    #define MY_UNCHECKED_NOEXCEPT
+#else
+    #define MY_UNCHECKED_NOEXCEPT noexcept
+#endif
+
+
+// 定义MY_UTILS_INSTRUMENT时，Ok()、Err()、Result::or_else()以及Result::unwrap_or()等函数会按调用处计数，
+// 需要链接src/rs/instrument.cpp（见rs/instrument.hpp）；未定义时这些函数的签名与生成的代码都不受影响。
+// 该宏必须在整个程序中保持一致。
+
+
 #endif // !C163Q_MY_CPP_UTILS_CORE_CONFIG_HPP
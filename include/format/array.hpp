@@ -0,0 +1,50 @@
+/*!
+ * @file format/array.hpp
+ * @brief 为std::array类提供std::formatter的实现
+ *
+ * 至少需要C++20
+ *
+ * @since Oct 14, 2026
+ */
+
+#ifndef C163Q_MY_CPP_UTILS_FORMAT_ARRAY_HPP
+#define C163Q_MY_CPP_UTILS_FORMAT_ARRAY_HPP
+
+#include"../core/config.hpp"
+#ifndef MY_CXX20
+    static_assert(false, "Require C++20!");
+#else
+
+#include<array>
+#include<cstddef>
+#include<format>
+#include"range_base.hpp"
+
+
+/**
+ * @brief 为标准库std::formatter实现std::array的特化。
+ *
+ * 格式化字符串的形式见C163q::range_formatter_base，
+ * 使用'|'分隔array本身的格式与元素的格式，'<'、'>'、'v'分别用于设置前边界、后边界与分隔符。
+ *
+ * @example
+ * ```cpp
+ * assert(std::format("{}", std::array{ 1, 2, 3 })
+ *         == std::string_view("[1, 2, 3]"));
+ *
+ * assert(std::format("{:<(<>)>v; v|.2f}", std::array{ 1.0, 2.0 })
+ *         == std::string_view("(1.00; 2.00)"));
+ * ```
+ */
+template<typename T, size_t N, typename CharT>
+class std::formatter<std::array<T, N>, CharT> : public C163q::range_formatter_base<T, CharT> {
+public:
+    template<typename FormatContext>
+    FormatContext::iterator format(const std::array<T, N>& value, FormatContext& ctx) const {
+        return this->format_range(value, ctx);
+    }
+};
+
+
+#endif // MY_CXX20
+#endif // !C163Q_MY_CPP_UTILS_FORMAT_ARRAY_HPP
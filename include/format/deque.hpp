@@ -0,0 +1,50 @@
+/*!
+ * @file format/deque.hpp
+ * @brief 为std::deque类提供std::formatter的实现
+ *
+ * 至少需要C++20
+ *
+ * @since Oct 14, 2026
+ */
+
+#ifndef C163Q_MY_CPP_UTILS_FORMAT_DEQUE_HPP
+#define C163Q_MY_CPP_UTILS_FORMAT_DEQUE_HPP
+
+#include"../core/config.hpp"
+#ifndef MY_CXX20
+    static_assert(false, "Require C++20!");
+#else
+
+#include<deque>
+#include<format>
+#include"range_base.hpp"
+
+
+/**
+ * @brief 为标准库std::formatter实现std::deque的特化。
+ *
+ * 格式化字符串的形式见C163q::range_formatter_base，
+ * 使用'|'分隔deque本身的格式与元素的格式，'<'、'>'、'v'分别用于设置前边界、后边界与分隔符。
+ * std::deque不是连续存储的，因此总是逐个元素地使用元素的formatter。
+ *
+ * @example
+ * ```cpp
+ * assert(std::format("{}", std::deque{ 1, 2, 3 })
+ *         == std::string_view("[1, 2, 3]"));
+ *
+ * assert(std::format("{:v -> v}", std::deque{ 'a', 'b', 'c' })
+ *         == std::string_view("[a -> b -> c]"));
+ * ```
+ */
+template<typename T, typename Alloc, typename CharT>
+class std::formatter<std::deque<T, Alloc>, CharT> : public C163q::range_formatter_base<T, CharT> {
+public:
+    template<typename FormatContext>
+    FormatContext::iterator format(const std::deque<T, Alloc>& value, FormatContext& ctx) const {
+        return this->format_range(value, ctx);
+    }
+};
+
+
+#endif // MY_CXX20
+#endif // !C163Q_MY_CPP_UTILS_FORMAT_DEQUE_HPP
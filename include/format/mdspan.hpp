@@ -0,0 +1,160 @@
+/*!
+ * @file format/mdspan.hpp
+ * @brief 为std::mdspan类提供std::formatter的实现
+ *
+ * 至少需要C++23，并且标准库需要提供std::mdspan
+ *
+ * @since Oct 14, 2026
+ */
+
+#ifndef C163Q_MY_CPP_UTILS_FORMAT_MDSPAN_HPP
+#define C163Q_MY_CPP_UTILS_FORMAT_MDSPAN_HPP
+
+#include"../core/config.hpp"
+#ifndef MY_CXX23
+    static_assert(false, "Require C++23!");
+#else
+
+#include<array>
+#include<cstddef>
+#include<format>
+#include<memory>
+#include<mdspan>
+#include<string_view>
+#include<type_traits>
+#include"range_base.hpp"
+
+#ifndef __cpp_lib_mdspan
+    static_assert(false, "Require std::mdspan!");
+#else
+
+
+/**
+ * @brief 为标准库std::formatter实现std::mdspan的特化。
+ *
+ * 每一维都输出为一层嵌套的范围，例如2x3的矩阵输出为"[[1, 2, 3], [4, 5, 6]]"。
+ * 格式化字符串的形式见C163q::range_formatter_base，其中：
+ * - '<'、'>'设置的边界用于每一维；
+ * - 'v'设置的分隔符用于每一维，可以再使用"d"加上维度下标（从0开始，最外层为0）单独设置某一维的分隔符，
+ *   使用另一个'd'结束，如果要使用字符'd'，请使用"\d"，例如"d0,\n d"；
+ * - '|'之后的部分用于控制每个元素的格式；
+ * - "n"、"h"、"t"对mdspan不起作用。
+ *
+ * 输出时直接按多维下标访问原有的数据，不会构造任何临时的嵌套结构。
+ * 若布局是有步长的、使用std::default_accessor，并且最内层一维的步长为1，
+ * 则每一行都作为连续存储的元素输出（算术类型会批量格式化）。
+ *
+ * 0维的mdspan只输出其唯一的元素。
+ *
+ * @example
+ * ```cpp
+ * std::vector v { 1, 2, 3, 4, 5, 6 };
+ * std::mdspan m(v.data(), 2, 3);
+ * assert(std::format("{}", m) == std::string_view("[[1, 2, 3], [4, 5, 6]]"));
+ * assert(std::format("{:d0,\n d}", m) == std::string_view("[[1, 2, 3],\n [4, 5, 6]]"));
+ * ```
+ */
+template<typename T, typename Extents, typename Layout, typename Accessor, typename CharT>
+class std::formatter<std::mdspan<T, Extents, Layout, Accessor>, CharT>
+    : public C163q::range_formatter_base<T, CharT> {
+private:
+    using mdspan_type = std::mdspan<T, Extents, Layout, Accessor>;
+    using index_type = typename Extents::index_type;
+    using text_buffer = C163q::format_text_buffer<CharT>;
+    static constexpr size_t rank = Extents::rank();
+
+    // 可以取得每一行首元素的地址，并且行内元素连续存储
+    static constexpr bool contiguous_rows =
+        std::is_same_v<Accessor, std::default_accessor<T>> &&
+        mdspan_type::mapping_type::is_always_strided();
+
+public:
+    template<typename ParseContext>
+    constexpr ParseContext::iterator parse(ParseContext& ctx) {
+        return this->parse_range(ctx, [this](ParseContext& ctx, typename ParseContext::iterator& iter) {
+            if (*iter != CharT('d')) return false;
+            ++iter;
+            if (iter == ctx.end() || *iter < CharT('0') || *iter > CharT('9')) {
+                throw std::format_error("Missing dimension in format string");
+            }
+            const size_t dimension = size_t(*iter - CharT('0'));
+            if (dimension >= rank) throw std::format_error("Dimension in format string is out of range");
+            ++iter;
+            if constexpr (rank != 0) {
+                this->range_text_format(CharT('d'), separators[dimension], ctx, iter);
+                has_separator[dimension] = true;
+            }
+            return true;
+        });
+    }
+
+    template<typename FormatContext>
+    FormatContext::iterator format(const mdspan_type& value, FormatContext& ctx) const {
+        std::array<index_type, rank> index{};
+        if constexpr (rank == 0) {
+            return this->element_formatter.format(value[index], ctx);
+        } else {
+            return format_dimension<0>(value, index, ctx.out(), ctx);
+        }
+    }
+
+private:
+    /**
+     * @brief 输出第D维，index中前D个下标已经确定。
+     */
+    template<size_t D, typename FormatContext>
+    FormatContext::iterator format_dimension(const mdspan_type& value, std::array<index_type, rank>& index,
+            FormatContext::iterator iter, FormatContext& ctx) const {
+        iter = C163q::format_write(std::move(iter), this->border_begin.view());
+        const index_type n = value.extent(D);
+        const auto sep = separator_of(D);
+        if constexpr (D + 1 == rank) {
+            if (n != 0) iter = format_row(value, index, n, sep, std::move(iter), ctx);
+        } else if (n != 0) {
+            index[D] = 0;
+            iter = format_dimension<D + 1>(value, index, std::move(iter), ctx);
+            for (index_type i = 1; i < n; ++i) {
+                iter = C163q::format_write(std::move(iter), sep);
+                index[D] = i;
+                iter = format_dimension<D + 1>(value, index, std::move(iter), ctx);
+            }
+        }
+        return C163q::format_write(std::move(iter), this->border_end.view());
+    }
+
+    /**
+     * @brief 输出最内层一维的n(n > 0)个元素，不包括边界。
+     */
+    template<typename FormatContext>
+    FormatContext::iterator format_row(const mdspan_type& value, std::array<index_type, rank>& index,
+            index_type n, std::basic_string_view<CharT> sep,
+            FormatContext::iterator iter, FormatContext& ctx) const {
+        index[rank - 1] = 0;
+        if constexpr (contiguous_rows) {
+            if (n == 1 || value.stride(rank - 1) == 1) {
+                return this->format_contiguous(std::addressof(value[index]), size_t(n), sep, std::move(iter), ctx);
+            }
+        }
+        ctx.advance_to(std::move(iter));
+        iter = this->element_formatter.format(value[index], ctx);
+        for (index_type i = 1; i < n; ++i) {
+            ctx.advance_to(C163q::format_write(std::move(iter), sep));
+            index[rank - 1] = i;
+            iter = this->element_formatter.format(value[index], ctx);
+        }
+        return iter;
+    }
+
+    constexpr std::basic_string_view<CharT> separator_of(size_t dimension) const noexcept {
+        return has_separator[dimension] ? separators[dimension].view() : this->separator.view();
+    }
+
+private:
+    std::array<text_buffer, rank>   separators{};       // 由"d"单独设置的每一维的分隔符
+    std::array<bool, rank>          has_separator{};
+};
+
+
+#endif // __cpp_lib_mdspan
+#endif // MY_CXX23
+#endif // !C163Q_MY_CPP_UTILS_FORMAT_MDSPAN_HPP
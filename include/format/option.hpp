@@ -0,0 +1,74 @@
+/*!
+ * @file format/option.hpp
+ * @brief 为C163q::Option类提供std::formatter的实现
+ *
+ * 至少需要C++20
+ *
+ * @since Oct 14, 2026
+ */
+
+#ifndef C163Q_MY_CPP_UTILS_FORMAT_OPTION_HPP
+#define C163Q_MY_CPP_UTILS_FORMAT_OPTION_HPP
+
+#include"../core/config.hpp"
+#ifndef MY_CXX20
+    static_assert(false, "Require C++20!");
+#else
+
+#include<format>
+#include<string_view>
+#include<type_traits>
+#include"../rs/option.hpp"
+#include"range_base.hpp"
+
+
+/**
+ * @brief 为标准库std::formatter实现C163q::Option的特化。
+ *
+ * Some时输出"Some(值)"，None时输出"None"，保有的值直接交给其自身的formatter写入输出迭代器，
+ * 不会产生临时的字符串。
+ *
+ * 格式化字符串的形式见C163q::range_formatter_base，
+ * 其中'<'、'>'分别设置Some时值前后的字符串（默认为"Some("与")"），'|'之后的部分用于控制值的格式。
+ * 只对序列有意义的'v'、'n'、'h'、't'会使解析抛出std::format_error。
+ *
+ * @example
+ * ```cpp
+ * assert(std::format("{}", C163q::Option<int>(1)) == std::string_view("Some(1)"));
+ * assert(std::format("{}", C163q::Option<int>()) == std::string_view("None"));
+ * assert(std::format("{:|.2f}", C163q::Option<double>(0.5)) == std::string_view("Some(0.50)"));
+ * ```
+ */
+template<typename T, typename CharT>
+    requires (!std::is_void_v<T>)
+class std::formatter<C163q::Option<T>, CharT>
+    : public C163q::range_formatter_base<std::remove_cvref_t<T>, CharT> {
+private:
+    using base = C163q::range_formatter_base<std::remove_cvref_t<T>, CharT>;
+
+public:
+    constexpr formatter() : base(default_border_begin, default_border_end) {}
+
+    template<typename ParseContext>
+    constexpr ParseContext::iterator parse(ParseContext& ctx) {
+        return this->parse_range(ctx, C163q::format_reject_sequence_options{});
+    }
+
+    template<typename FormatContext>
+    FormatContext::iterator format(const C163q::Option<T>& value, FormatContext& ctx) const {
+        if (value.is_none()) return C163q::format_write(ctx.out(), std::basic_string_view<CharT>(none_text));
+        ctx.advance_to(C163q::format_write(ctx.out(), this->border_begin.view()));
+        auto iter = this->element_formatter.format(value.get_uncheck(), ctx);
+        return C163q::format_write(std::move(iter), this->border_end.view());
+    }
+
+public:
+    // 默认设置
+    constexpr static CharT default_border_begin [6] { CharT('S'), CharT('o'), CharT('m'), CharT('e'), CharT('('), 0 };
+    constexpr static CharT default_border_end   [2] { CharT(')'), 0 };
+    constexpr static CharT none_text            [5] { CharT('N'), CharT('o'), CharT('n'), CharT('e'), 0 };
+};
+
+
+#endif // MY_CXX20
+#endif // !C163Q_MY_CPP_UTILS_FORMAT_OPTION_HPP
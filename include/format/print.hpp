@@ -0,0 +1,134 @@
+/*!
+ * @file format/print.hpp
+ * @brief 将格式化的结果分块输出到文件描述符或者std::FILE*
+ *
+ * std::format会先得到整个std::string再输出，格式化很大的vector或span时内存峰值会翻倍，
+ * 并且要等格式化全部完成才能输出第一个字节。这里的函数使用与panic相同的panic_writer，
+ * 格式化的结果写满一个固定大小（print_buffer_size）的缓冲区后立即输出，占用的内存与输出的长度无关。
+ *
+ * 需要链接src/rs/panic.cpp。
+ *
+ * 至少需要C++20
+ *
+ * @since Oct 14, 2026
+ */
+
+#ifndef C163Q_MY_CPP_UTILS_FORMAT_PRINT_HPP
+#define C163Q_MY_CPP_UTILS_FORMAT_PRINT_HPP
+
+#include"../core/config.hpp"
+#ifndef MY_CXX20
+    static_assert(false, "Require C++20!");
+#else
+
+#include<cerrno>
+#include<cstddef>
+#include<cstdio>
+#include<format>
+#include<memory>
+#include<string_view>
+#include<system_error>
+#include<utility>
+#include"../rs/panic.hpp"
+#include"../rs/result.hpp"
+
+namespace C163q {
+
+    /**
+     * @brief 每次调用使用的缓冲区大小，缓冲区写满后输出一次
+     */
+    inline constexpr size_t print_buffer_size = 64 * 1024;
+
+    namespace detail {
+
+        struct print_target {
+            int fd = -1;
+            std::FILE* stream = nullptr;
+            size_t written = 0;
+            int error = 0;
+        };
+
+        // 出错之后丢弃剩余的输出，格式化本身无法被中途停止
+        inline void print_sink(void* context, std::string_view data) noexcept {
+            auto& target = *static_cast<print_target*>(context);
+            if (target.error != 0) return;
+            if (target.stream) {
+                // fwrite失败时并不一定设置errno，先清零以免报告之前残留的errno；
+                // 写入失败时fwrite也可能已经将数据计为写入（例如glibc的无缓冲流），因此同时检查ferror
+                errno = 0;
+                if (std::fwrite(data.data(), 1, data.size(), target.stream) != data.size() ||
+                        std::ferror(target.stream)) {
+                    target.error = errno != 0 ? errno : EIO;
+                    return;
+                }
+            } else if (int e = write_fd(target.fd, data); e != 0) {
+                target.error = e;
+                return;
+            }
+            target.written += data.size();
+        }
+
+        inline Result<size_t, std::errc> vprint_chunked(print_target& target, std::string_view fmt, std::format_args args) {
+            auto buffer = std::make_unique_for_overwrite<char[]>(print_buffer_size);
+            panic_writer writer(buffer.get(), print_buffer_size, &print_sink, &target);
+            std::vformat_to(writer.out(), fmt, args);
+            writer.flush();
+            if (target.error != 0) return Result<size_t, std::errc>(std::in_place_index<1>, std::errc(target.error));
+            return Result<size_t, std::errc>(std::in_place_index<0>, target.written);
+        }
+
+    }
+
+    /**
+     * @brief 与std::format相同，但将结果分块写入文件描述符fd
+     *
+     * 不经过stdio的缓冲区，与printf等混用时应当先调用std::fflush。
+     *
+     * @return 写入的字节数，或者写入失败时的错误码（之后的输出被丢弃）
+     */
+    template<typename ...Args>
+    Result<size_t, std::errc> format_to_fd(int fd, std::format_string<Args...> fmt, Args&&... args) {
+        detail::print_target target{ .fd = fd };
+        return detail::vprint_chunked(target, fmt.get(), std::make_format_args(args...));
+    }
+
+    /**
+     * @brief 与std::format相同，但将结果分块写入stream
+     *
+     * @return 写入的字节数，或者写入失败时的错误码（之后的输出被丢弃）
+     */
+    template<typename ...Args>
+    Result<size_t, std::errc> format_to_file(std::FILE* stream, std::format_string<Args...> fmt, Args&&... args) {
+        detail::print_target target{ .stream = stream };
+        return detail::vprint_chunked(target, fmt.get(), std::make_format_args(args...));
+    }
+
+    /**
+     * @brief 使用format/vector.hpp、format/span.hpp等提供的std::formatter将range分块写入stream
+     *
+     * @param fmt 运行时的格式字符串，其中只能有一个替换域，例如"{:<[<v, v>]>|.3f}\n"
+     *
+     * @example
+     * ```cpp
+     * std::vector<double> samples(50'000'000);
+     * C163q::print_range(stdout, std::span(samples), "{:|.3f}\n");   // 只占用print_buffer_size的缓冲区
+     * ```
+     */
+    template<typename R>
+    Result<size_t, std::errc> print_range(std::FILE* stream, const R& range, std::string_view fmt = "{}") {
+        detail::print_target target{ .stream = stream };
+        return detail::vprint_chunked(target, fmt, std::make_format_args(range));
+    }
+
+    /**
+     * @brief 与print_range(std::FILE*, ...)相同，但写入文件描述符fd
+     */
+    template<typename R>
+    Result<size_t, std::errc> print_range(int fd, const R& range, std::string_view fmt = "{}") {
+        detail::print_target target{ .fd = fd };
+        return detail::vprint_chunked(target, fmt, std::make_format_args(range));
+    }
+}
+
+#endif // MY_CXX20
+#endif // !C163Q_MY_CPP_UTILS_FORMAT_PRINT_HPP
@@ -0,0 +1,517 @@
+/*!
+ * @file format/range_base.hpp
+ * @brief 各个范围类型的std::formatter特化所共用的组件
+ *
+ * 包括保存边界、分隔符的内联缓冲区，向输出迭代器批量写入文本的辅助函数，
+ * 连续存储的算术类型元素在默认格式下的批量格式化，
+ * 以及解析格式化字符串并输出整个范围的range_formatter_base。
+ *
+ * 至少需要C++20
+ *
+ * @since Oct 14, 2026
+ */
+
+#ifndef C163Q_MY_CPP_UTILS_FORMAT_RANGE_BASE_HPP
+#define C163Q_MY_CPP_UTILS_FORMAT_RANGE_BASE_HPP
+
+#include"../core/config.hpp"
+#ifndef MY_CXX20
+    static_assert(false, "Require C++20!");
+#else
+
+#include<algorithm>
+#include<charconv>
+#include<cstddef>
+#include<format>
+#include<iterator>
+#include<memory>
+#include<ranges>
+#include<string_view>
+#include<type_traits>
+#include<utility>
+
+namespace C163q {
+
+    /**
+     * @brief 固定容量的内联字符缓冲区，用于保存格式化字符串中解析出的边界和分隔符。
+     *
+     * 不超过N个字符时字符直接保存在formatter对象内部，因此解析时不会分配内存，
+     * formatter被复制之后也不会出现指向其他对象的string_view。
+     * 更长的文本可以通过refer()改为引用格式化字符串中的原文，格式化字符串在整个格式化过程中都是有效的。
+     * 通过push_back()超出容量时抛出std::format_error。
+     *
+     * @tparam CharT 字符类型
+     * @tparam N     最多能保存的字符数
+     */
+    template<typename CharT, size_t N = 32>
+    class format_text_buffer {
+    public:
+        constexpr format_text_buffer() noexcept = default;
+
+        constexpr explicit format_text_buffer(std::basic_string_view<CharT> text) {
+            for (CharT ch : text) push_back(ch);
+        }
+
+        constexpr void clear() noexcept {
+            m_size = 0;
+            m_external = nullptr;
+        }
+
+        /**
+         * @brief 改为引用text，而不是保存其副本，text需要在使用view()期间一直有效。
+         */
+        constexpr void refer(std::basic_string_view<CharT> text) noexcept {
+            m_external = text.data();
+            m_size = text.size();
+        }
+
+        constexpr void push_back(CharT ch) {
+            if (m_size == N || m_external) throw std::format_error("Text in format string is too long");
+            m_data[m_size++] = ch;
+        }
+
+        [[nodiscard]] constexpr size_t size() const noexcept {
+            return m_size;
+        }
+
+        [[nodiscard]] constexpr std::basic_string_view<CharT> view() const noexcept {
+            return { m_external ? m_external : m_data, m_size };
+        }
+
+        [[nodiscard]] static constexpr size_t capacity() noexcept {
+            return N;
+        }
+
+    private:
+        CharT m_data[N]{};
+        size_t m_size = 0;
+        const CharT* m_external = nullptr;
+    };
+
+    /**
+     * @brief 将text整体写入输出迭代器，返回写入后的迭代器。
+     *
+     * std::format_to等传给formatter的迭代器是标准库内部的类型（并非用户传入的std::back_insert_iterator），
+     * 无法从中取得底层容器来预留空间或者整段插入，因此这里只是逐个字符地复制。
+     */
+    template<typename CharT, typename Iter>
+    constexpr Iter format_write(Iter iter, std::basic_string_view<CharT> text) {
+        return std::ranges::copy(text, std::move(iter)).out;
+    }
+
+    /**
+     * @brief 元素类型T在默认格式（即"{}"）下能否使用format_write_arithmetic批量格式化。
+     *
+     * 字符类型与bool会被格式化为字符和文本，因此不在此列。
+     */
+    template<typename T>
+    inline constexpr bool format_arithmetic_v = std::is_arithmetic_v<T> &&
+        !std::is_same_v<T, bool> && !std::is_same_v<T, char> && !std::is_same_v<T, wchar_t> &&
+        !std::is_same_v<T, char8_t> && !std::is_same_v<T, char16_t> && !std::is_same_v<T, char32_t>;
+
+    /**
+     * @brief 将[first, last)中的算术类型元素以默认格式写入输出迭代器，元素之间插入sep。
+     *
+     * 默认格式下std::format对整数和浮点数的输出与不指定格式的std::to_chars完全相同，
+     * 因此这里直接调用std::to_chars，将结果连同分隔符一起写入栈上的缓冲区，
+     * 缓冲区将满时再整体写入输出迭代器，从而避免逐个元素经过std::formatter<T>。
+     */
+    template<typename CharT, typename T, typename Iter>
+        requires format_arithmetic_v<T>
+    Iter format_write_arithmetic(Iter iter, const T* first, const T* last, std::basic_string_view<CharT> sep) {
+        constexpr size_t max_chars = 64;    // std::to_chars对任意算术类型的最长输出
+        constexpr size_t buffer_size = 4096;
+
+        CharT buffer[buffer_size];
+        size_t n = 0;
+        auto put = [&](const T& value) {
+            if constexpr (std::is_same_v<CharT, char>) {
+                n = size_t(std::to_chars(buffer + n, buffer + n + max_chars, value).ptr - buffer);
+            } else {
+                char narrow[max_chars];
+                auto end = std::to_chars(narrow, narrow + max_chars, value).ptr;
+                for (auto p = narrow; p != end; ++p) buffer[n++] = CharT(*p);
+            }
+        };
+        auto flush = [&] {
+            iter = format_write(std::move(iter), std::basic_string_view<CharT>(buffer, n));
+            n = 0;
+        };
+        // 分隔符过长时不放入缓冲区，而是直接写入输出迭代器
+        const bool buffered_sep = sep.size() <= buffer_size - max_chars;
+
+        if (first == last) return iter;
+        put(*first);
+        while (++first != last) {
+            if (!buffered_sep) {
+                flush();
+                iter = format_write(std::move(iter), sep);
+            } else {
+                if (buffer_size - n < max_chars + sep.size()) flush();
+                n = size_t(std::ranges::copy(sep, buffer + n).out - buffer);
+            }
+            put(*first);
+        }
+        return format_write(std::move(iter), std::basic_string_view<CharT>(buffer, n));
+    }
+
+    /**
+     * @brief 只保有单个值的formatter（Option、Result）使用的parse_range扩展，
+     *        拒绝只对序列有意义的选项'v'、'n'、'h'、't'。
+     */
+    struct format_reject_sequence_options {
+        template<typename ParseContext>
+        constexpr bool operator()(ParseContext&, ParseContext::iterator& iter) const {
+            using CharT = typename ParseContext::char_type;
+            switch (*iter) {
+            case CharT('v'):
+            case CharT('n'):
+            case CharT('h'):
+            case CharT('t'):
+                throw std::format_error("Separator and element count options are not allowed for a single value");
+            default:
+                return false;
+            }
+        }
+    };
+
+    /**
+     * @brief 范围类型的std::formatter特化的公共基类，负责解析格式化字符串并输出整个范围。
+     *
+     * 格式化字符串的形式如下：
+     *
+     * 使用'|'表示格式化字符串中，前面部分是用于控制范围格式的，后半部分是用于控制其中每个元素的格式的
+     * 当不存在'|'时，默认认为整个格式化字符串都是用于控制范围的。
+     *
+     * 例如：对于std::vector<float>的格式化字符串"{:v\nv|.5f}"，
+     * 前面部分"v\nv"用于控制元素之间的分割符为"\n"，后面部分".5f"用于控制每个float元素的格式。
+     *
+     * 使用'<'来表示设置打印第一个元素前打印的字符串，默认为"["，
+     * 使用另一个'<'结束打印字符串的设置，如果要使用字符'<'，请使用"\<"。（一个\字符和一个<字符）
+     *
+     * 使用'>'来表示设置打印最后一个元素后打印的字符串，默认为"]"，
+     * 使用另一个'>'结束打印字符串的设置，如果要使用字符'>'，请使用"\>"。
+     *
+     * 使用'v'来表示设置元素之间的分割符，默认为", "（一个,字符和一个空格），
+     * 使用另一个'v'结束打印字符串的设置，如果要使用字符'v'，请使用"\v"。
+     *
+     * 此外，如果要使用字符'|'，可以使用"\|"。
+     *
+     * 对于元素很多的范围，可以只输出其中的一部分：
+     * - "n"后跟一个整数K表示最多输出K个元素，超出时输出开头的(K+1)/2个与末尾的K/2个元素；
+     * - "h"后跟一个整数表示输出开头的多少个元素，"t"后跟一个整数表示输出末尾的多少个元素，
+     *   两者任意一个出现时"n"不起作用，未出现的一方视为0。
+     * 元素被省略时，省略的部分输出为"..."，并在后边界之后追加" (len=元素总数)"，
+     * 例如"{:h2t2}"输出"[1, 2, ..., 49999999, 50000000] (len=50000000)"。
+     * 这里只访问输出的元素，对随机访问的范围耗时与输出的元素个数成正比。
+     * 该功能要求范围是sized_range且forward_range，否则会忽略这些设置。
+     *
+     * 派生类只需要在format中调用format_range。连续存储的范围与其他范围使用不同的输出循环，
+     * 前者在元素为算术类型且使用默认格式时会使用format_write_arithmetic批量格式化。
+     *
+     * @tparam T     元素类型
+     * @tparam CharT 字符类型
+     *
+     * @example
+     * ```cpp
+     * template<typename T, typename CharT>
+     * struct std::formatter<my_list<T>, CharT> : C163q::range_formatter_base<T, CharT> {
+     *     template<typename FormatContext>
+     *     FormatContext::iterator format(const my_list<T>& value, FormatContext& ctx) const {
+     *         return this->format_range(value, ctx);
+     *     }
+     * };
+     * ```
+     */
+    template<typename T, typename CharT>
+    class range_formatter_base {
+    protected:
+        using element_type = std::remove_cv_t<T>;
+        using text_buffer = format_text_buffer<CharT>;  // 边界和分隔符直接存放在formatter内部
+
+    public:
+        constexpr range_formatter_base() = default;
+
+        template<typename ParseContext>
+        constexpr ParseContext::iterator parse(ParseContext& ctx) {
+            return parse_range(ctx, [](ParseContext&, typename ParseContext::iterator&) { return false; });
+        }
+
+    protected:
+        /**
+         * @brief 使用其他的默认边界，供派生类使用。
+         */
+        constexpr range_formatter_base(std::basic_string_view<CharT> begin, std::basic_string_view<CharT> end)
+            : border_begin(begin), border_end(end) {}
+
+        /**
+         * @brief 解析格式化字符串，并允许派生类处理额外的选项。
+         *
+         * @param extension 对'|'与'}'以外的每个字符，基类处理之前先调用extension(ctx, iter)，此时iter指向该字符。
+         *                  返回true表示已经处理了该选项，并且iter已被移动到选项之后；
+         *                  返回false时由基类处理，基类也不认识的字符被忽略。
+         *                  拒绝某个选项时抛出std::format_error即可，见format_reject_sequence_options。
+         */
+        template<typename ParseContext, typename Extension>
+        constexpr ParseContext::iterator parse_range(ParseContext& ctx, Extension&& extension) {
+            // '|'前的部分的格式化处理
+            auto [iter, element_format] = range_format_parse(ctx, ctx.begin(), extension);
+            if (head_elements != npos || tail_elements != npos) {
+                truncate = true;
+                if (head_elements == npos) head_elements = 0;
+                if (tail_elements == npos) tail_elements = 0;
+            } else if (max_elements != npos) {
+                truncate = true;
+                head_elements = max_elements - max_elements / 2;
+                tail_elements = max_elements / 2;
+            }
+            if (!element_format) return iter;
+            std::basic_format_parse_context<CharT> element_format_string
+                { std::basic_string_view<CharT> { iter, ctx.end() } };
+            if (element_format_string.begin() != element_format_string.end() &&
+                    *element_format_string.begin() != CharT('}')) {
+                default_element = false;
+            }
+            return element_formatter.parse(element_format_string);  // 委托给元素的formatter
+        }
+
+        /**
+         * @brief 输出整个范围，包括前后边界和元素之间的分隔符。
+         */
+        template<std::ranges::input_range Range, typename FormatContext>
+        FormatContext::iterator format_range(const Range& range, FormatContext& ctx) const {
+            auto iter = ctx.out();
+            if constexpr (std::ranges::sized_range<const Range>) {
+                const size_t n = size_t(std::ranges::size(range));
+                if constexpr (std::ranges::forward_range<const Range>) {
+                    if (truncate && n > head_elements + tail_elements) return format_truncated(range, n, ctx);
+                }
+            }
+            iter = format_write(std::move(iter), border_begin.view());
+            if constexpr (std::ranges::contiguous_range<const Range>) {
+                iter = format_contiguous(std::ranges::data(range), size_t(std::ranges::size(range)),
+                        separator.view(), std::move(iter), ctx);
+            } else {
+                iter = format_elements(std::ranges::begin(range), std::ranges::end(range),
+                        separator.view(), std::move(iter), ctx);
+            }
+            return format_write(std::move(iter), border_end.view());
+        }
+
+        /**
+         * @brief 只输出开头的head_elements个与末尾的tail_elements个元素，并在最后追加" (len=n)"。
+         */
+        template<typename Range, typename FormatContext>
+        FormatContext::iterator format_truncated(const Range& range, size_t n, FormatContext& ctx) const {
+            constexpr CharT ellipsis[] { CharT('.'), CharT('.'), CharT('.') };
+            const auto sep = separator.view();
+            auto iter = ctx.out();
+            iter = format_write(std::move(iter), border_begin.view());
+            if (head_elements != 0) {
+                iter = format_part(range, 0, head_elements, std::move(iter), ctx);
+                iter = format_write(std::move(iter), sep);
+            }
+            iter = format_write(std::move(iter), std::basic_string_view<CharT>(ellipsis, 3));
+            if (tail_elements != 0) {
+                iter = format_write(std::move(iter), sep);
+                iter = format_part(range, n - tail_elements, tail_elements, std::move(iter), ctx);
+            }
+            iter = format_write(std::move(iter), border_end.view());
+
+            constexpr char prefix[] = " (len=";
+            char digits[24];
+            auto digits_end = std::to_chars(digits, digits + sizeof(digits), n).ptr;
+            CharT suffix[sizeof(prefix) + sizeof(digits)];
+            auto out = std::ranges::copy(prefix, prefix + sizeof(prefix) - 1, suffix).out;
+            out = std::ranges::copy(digits, digits_end, out).out;
+            *out++ = CharT(')');
+            return format_write(std::move(iter), std::basic_string_view<CharT>(suffix, size_t(out - suffix)));
+        }
+
+        /**
+         * @brief 输出范围中从第offset个元素开始的count个元素，不包括边界。
+         */
+        template<typename Range, typename FormatContext>
+        FormatContext::iterator format_part(const Range& range, size_t offset, size_t count,
+                FormatContext::iterator iter, FormatContext& ctx) const {
+            if constexpr (std::ranges::contiguous_range<const Range>) {
+                return format_contiguous(std::ranges::data(range) + offset, count, separator.view(), std::move(iter), ctx);
+            } else {
+                using difference_type = std::ranges::range_difference_t<const Range>;
+                auto first = std::ranges::next(std::ranges::begin(range), difference_type(offset));
+                auto last = std::ranges::next(first, difference_type(count));
+                return format_elements(std::move(first), std::move(last), separator.view(), std::move(iter), ctx);
+            }
+        }
+
+        /**
+         * @brief 输出连续存储的n个元素，元素之间插入sep，不包括边界。
+         */
+        template<typename FormatContext>
+        FormatContext::iterator format_contiguous(const T* data, size_t n, std::basic_string_view<CharT> sep,
+                FormatContext::iterator iter, FormatContext& ctx) const {
+            if constexpr (format_arithmetic_v<element_type>) {
+                if (default_element) return format_write_arithmetic(std::move(iter), data, data + n, sep);
+            }
+            return format_elements(data, data + n, sep, std::move(iter), ctx);
+        }
+
+        /**
+         * @brief 逐个输出[first, last)中的元素，不包括边界。
+         *
+         * 第一个元素前没有分隔符，之后的每个元素前都先写入分隔符sep，从而无需逐个判断是否为最后一个元素。
+         */
+        template<typename Iter, typename Sentinel, typename FormatContext>
+        FormatContext::iterator format_elements(Iter first, Sentinel last, std::basic_string_view<CharT> sep,
+                FormatContext::iterator iter, FormatContext& ctx) const {
+            if (first == last) return iter;
+            ctx.advance_to(std::move(iter));
+            iter = element_formatter.format(*first, ctx);   // 使用元素的formatter
+            while (++first != last) {
+                ctx.advance_to(format_write(std::move(iter), sep));
+                iter = element_formatter.format(*first, ctx);
+            }
+            return iter;
+        }
+
+        /**
+         * 解析有关范围的格式，而不解析元素的格式
+         * @return 返回两个变量，ParseContext::iterator是ParseContext解析后的尾迭代器
+         *         bool是是否有'|'标识符，如果有为true，意味着需要解析元素格式
+         */
+        template<typename ParseContext, typename Extension>
+        constexpr std::pair<typename ParseContext::iterator, bool>
+        range_format_parse(ParseContext& ctx, ParseContext::iterator iter, Extension& extension) {
+            while (iter != ctx.end()) {
+                if (*iter == CharT('|')) {
+                    ++iter;
+                    return { iter, true };
+                }
+                if (*iter == CharT('}')) return { iter, false };
+                if (extension(ctx, iter)) continue;
+                switch (*iter) {
+                case CharT('<'):
+                    ++iter;
+                    range_text_format(CharT('<'), border_begin, ctx, iter);
+                    break;
+                case CharT('>'):
+                    ++iter;
+                    range_text_format(CharT('>'), border_end, ctx, iter);
+                    break;
+                case CharT('v'):
+                    ++iter;
+                    range_text_format(CharT('v'), separator, ctx, iter);
+                    break;
+                case CharT('n'):
+                    ++iter;
+                    max_elements = range_number_format(ctx, iter);
+                    break;
+                case CharT('h'):
+                    ++iter;
+                    head_elements = range_number_format(ctx, iter);
+                    break;
+                case CharT('t'):
+                    ++iter;
+                    tail_elements = range_number_format(ctx, iter);
+                    break;
+                default:
+                    ++iter;
+                    break;
+                }
+            }
+            return { iter, false };
+        }
+
+        /**
+         * 用于对分隔符、前边界、后边界进行解析的通用函数。
+         *
+         * @warning         传入的iter应当指向indicator的下一个位置！
+         *
+         * @param indicator 表明指示解析结束的字符。
+         *                  例如'<'，则遇到'<'时返回指向后一个的迭代器，遇到"\<"时继续解析。
+         * 文本超出aim的容量时aim改为引用格式化字符串中的原文；此时文本中不能有转义（"\\"），
+         * 否则抛出std::format_error。
+         *
+         * @param aim       决定最终将解析的字符串结果放入到哪个缓冲区中，原有内容会被清除。
+         * @param ctx       parse中的ctx。
+         * @param iter      ctx迭代器内容的迭代器，从中开始解析，由于是引用，因此会修改迭代器本身。
+         * @return          即参数iter。
+         */
+        template<typename ParseContext>
+        constexpr ParseContext::iterator& range_text_format(
+                CharT indicator,
+                text_buffer& aim,
+                ParseContext& ctx,
+                ParseContext::iterator& iter) {
+            bool ignore = false;
+            bool escaped = false;
+            bool overflow = false;
+            const CharT* first = std::to_address(iter);
+            size_t length = 0;          // 原文（包括转义字符）的长度
+            aim.clear();
+            while (iter != ctx.end()) {
+                if ((*iter == indicator) && !ignore) {
+                    ++iter;
+                    break;
+                }
+                ++length;
+                if ((*iter == CharT('\\')) && !ignore) {
+                    ++iter;
+                    ignore = true;
+                    escaped = true;
+                    continue;
+                }
+                if (aim.size() < aim.capacity()) aim.push_back(*iter);
+                else overflow = true;
+                if (overflow && escaped) throw std::format_error("Escaped text in format string is too long");
+                ++iter;
+                ignore = false;
+            }
+            if (overflow) aim.refer({ first, length });
+            return iter;
+        }
+
+        /**
+         * 解析'n'、'h'、't'之后的非负整数。
+         *
+         * @warning         传入的iter应当指向字母的下一个位置！
+         * @return          解析出的整数，iter会被移动到整数之后。
+         */
+        template<typename ParseContext>
+        constexpr size_t range_number_format(ParseContext& ctx, ParseContext::iterator& iter) {
+            if (iter == ctx.end() || *iter < CharT('0') || *iter > CharT('9')) {
+                throw std::format_error("Missing element count in format string");
+            }
+            size_t value = 0;
+            while (iter != ctx.end() && *iter >= CharT('0') && *iter <= CharT('9')) {
+                if (value > (npos - 9) / 10) throw std::format_error("Element count in format string is too large");
+                value = value * 10 + size_t(*iter - CharT('0'));
+                ++iter;
+            }
+            return value;
+        }
+
+    public:
+        // 默认设置
+        constexpr static CharT default_separator    [3] { CharT(','), CharT(' '), 0 };
+        constexpr static CharT default_border_begin [2] { CharT('['), 0 };
+        constexpr static CharT default_border_end   [2] { CharT(']'), 0 };
+
+    protected:
+        std::formatter<element_type, CharT> element_formatter;
+        text_buffer                         separator{ default_separator };
+        text_buffer                         border_begin{ default_border_begin };
+        text_buffer                         border_end{ default_border_end };
+        bool                                default_element = true; // 元素使用默认格式，算术类型可以批量格式化
+
+        static constexpr size_t npos = size_t(-1);
+        size_t                              max_elements = npos;    // "n"，解析后不再使用
+        size_t                              head_elements = npos;   // "h"，解析后为开头输出的元素个数
+        size_t                              tail_elements = npos;   // "t"，解析后为末尾输出的元素个数
+        bool                                truncate = false;       // 是否设置了"n"、"h"或"t"
+    };
+
+}
+
+#endif // MY_CXX20
+#endif // !C163Q_MY_CPP_UTILS_FORMAT_RANGE_BASE_HPP
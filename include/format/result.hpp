@@ -0,0 +1,136 @@
+/*!
+ * @file format/result.hpp
+ * @brief 为C163q::Result类提供std::formatter的实现
+ *
+ * 至少需要C++20
+ *
+ * @since Oct 14, 2026
+ */
+
+#ifndef C163Q_MY_CPP_UTILS_FORMAT_RESULT_HPP
+#define C163Q_MY_CPP_UTILS_FORMAT_RESULT_HPP
+
+#include"../core/config.hpp"
+#ifndef MY_CXX20
+    static_assert(false, "Require C++20!");
+#else
+
+#include<format>
+#include<string_view>
+#include<type_traits>
+#include"../rs/result.hpp"
+#include"range_base.hpp"
+
+namespace C163q {
+
+    /**
+     * @brief Result的formatter中用于输出Err的部分，Err的值总是使用默认格式。
+     */
+    template<typename E, typename CharT>
+    class result_err_formatter {
+    public:
+        constexpr result_err_formatter() {
+            std::basic_format_parse_context<CharT> empty{ std::basic_string_view<CharT>{} };
+            err_formatter.parse(empty);
+        }
+
+        template<typename FormatContext>
+        FormatContext::iterator format(const E& value, FormatContext& ctx) const {
+            ctx.advance_to(format_write(ctx.out(), std::basic_string_view<CharT>(err_begin)));
+            auto iter = err_formatter.format(value, ctx);
+            return format_write(std::move(iter), std::basic_string_view<CharT>(err_end));
+        }
+
+    public:
+        constexpr static CharT err_begin [5] { CharT('E'), CharT('r'), CharT('r'), CharT('('), 0 };
+        constexpr static CharT err_end   [2] { CharT(')'), 0 };
+
+    private:
+        std::formatter<E, CharT> err_formatter;
+    };
+
+}
+
+
+/**
+ * @brief 为标准库std::formatter实现C163q::Result的特化。
+ *
+ * Ok时输出"Ok(值)"，Err时输出"Err(错误)"，保有的值直接交给其自身的formatter写入输出迭代器，
+ * 不会产生临时的字符串。
+ *
+ * 格式化字符串的形式见C163q::range_formatter_base，
+ * 其中'<'、'>'分别设置Ok时值前后的字符串（默认为"Ok("与")"），'|'之后的部分用于控制Ok时值的格式。
+ * Err时的值总是使用默认格式。只对序列有意义的'v'、'n'、'h'、't'会使解析抛出std::format_error。
+ *
+ * @example
+ * ```cpp
+ * assert(std::format("{}", C163q::Ok<std::string>(1)) == std::string_view("Ok(1)"));
+ * assert(std::format("{}", C163q::Err<int>(std::string("bad"))) == std::string_view("Err(bad)"));
+ * assert(std::format("{:|.1f}", C163q::Ok<int>(2.0)) == std::string_view("Ok(2.0)"));
+ * ```
+ */
+template<typename T, typename E, typename CharT>
+    requires (!std::is_void_v<T>)
+class std::formatter<C163q::Result<T, E>, CharT> : public C163q::range_formatter_base<T, CharT> {
+private:
+    using base = C163q::range_formatter_base<T, CharT>;
+
+public:
+    constexpr formatter() : base(default_border_begin, default_border_end) {}
+
+    template<typename ParseContext>
+    constexpr ParseContext::iterator parse(ParseContext& ctx) {
+        return this->parse_range(ctx, C163q::format_reject_sequence_options{});
+    }
+
+    template<typename FormatContext>
+    FormatContext::iterator format(const C163q::Result<T, E>& value, FormatContext& ctx) const {
+        if (value.is_err()) return err_formatter.format(value.template get_uncheck<1>(), ctx);
+        ctx.advance_to(C163q::format_write(ctx.out(), this->border_begin.view()));
+        auto iter = this->element_formatter.format(value.template get_uncheck<0>(), ctx);
+        return C163q::format_write(std::move(iter), this->border_end.view());
+    }
+
+public:
+    // 默认设置
+    constexpr static CharT default_border_begin [4] { CharT('O'), CharT('k'), CharT('('), 0 };
+    constexpr static CharT default_border_end   [2] { CharT(')'), 0 };
+
+private:
+    C163q::result_err_formatter<E, CharT> err_formatter;
+};
+
+/**
+ * @brief Result<void, E>的特化，Ok时输出"Ok(())"。
+ *
+ * 格式化字符串中'|'之后的部分用于控制Err时错误的格式，同样不允许'v'、'n'、'h'、't'。
+ */
+template<typename E, typename CharT>
+class std::formatter<C163q::Result<void, E>, CharT> : public C163q::range_formatter_base<E, CharT> {
+private:
+    using base = C163q::range_formatter_base<E, CharT>;
+
+public:
+    constexpr formatter()
+        : base(C163q::result_err_formatter<E, CharT>::err_begin, C163q::result_err_formatter<E, CharT>::err_end) {}
+
+    template<typename ParseContext>
+    constexpr ParseContext::iterator parse(ParseContext& ctx) {
+        return this->parse_range(ctx, C163q::format_reject_sequence_options{});
+    }
+
+    template<typename FormatContext>
+    FormatContext::iterator format(const C163q::Result<void, E>& value, FormatContext& ctx) const {
+        if (value.is_ok()) return C163q::format_write(ctx.out(), std::basic_string_view<CharT>(ok_text));
+        ctx.advance_to(C163q::format_write(ctx.out(), this->border_begin.view()));
+        auto iter = this->element_formatter.format(value.template get_uncheck<1>(), ctx);
+        return C163q::format_write(std::move(iter), this->border_end.view());
+    }
+
+public:
+    constexpr static CharT ok_text [7] { CharT('O'), CharT('k'), CharT('('), CharT('('), CharT(')'), CharT(')'), 0 };
+};
+
+
+#endif // MY_CXX20
+#endif // !C163Q_MY_CPP_UTILS_FORMAT_RESULT_HPP
@@ -0,0 +1,125 @@
+/*!
+ * @file format/spec.hpp
+ * @brief 在编译期解析并检查格式化字符串，运行时只负责输出
+ *
+ * std::format每次调用时都会重新调用formatter的parse。
+ * 对于同一个格式被反复使用的场景，可以使用format_spec在编译期完成解析，
+ * 得到一个不可变的formatter，之后每次格式化时只需要输出。
+ *
+ * 至少需要C++20
+ *
+ * @since Oct 14, 2026
+ */
+
+#ifndef C163Q_MY_CPP_UTILS_FORMAT_SPEC_HPP
+#define C163Q_MY_CPP_UTILS_FORMAT_SPEC_HPP
+
+#include"../core/config.hpp"
+#ifndef MY_CXX20
+    static_assert(false, "Require C++20!");
+#else
+
+#include<format>
+#include<string>
+#include<string_view>
+#include<type_traits>
+
+namespace C163q {
+
+    /**
+     * @brief 在编译期解析完成的格式，保存了已经调用过parse的std::formatter<T, CharT>。
+     *
+     * 格式字符串即"{:...}"中冒号之后、右花括号之前的部分，必须被formatter完整地解析，
+     * 否则（以及formatter的parse抛出异常时）会导致编译错误。
+     * 要求std::formatter<T, CharT>可以在常量表达式中构造和解析，
+     * 本库中的各个容器formatter都满足这一点。
+     *
+     * @tparam T     被格式化的类型
+     * @tparam CharT 字符类型
+     *
+     * @example
+     * ```cpp
+     * static constexpr C163q::format_spec<std::vector<double>> spec("<[\n\t<v\n\tv>\n]>|.6f");
+     * std::vector v { 1.0, 2.0 };
+     * assert(std::format("{}", C163q::with_spec(spec, v)) == "[\n\t1.000000\n\t2.000000\n]");
+     * assert(C163q::format_with(spec, v) == "[\n\t1.000000\n\t2.000000\n]");
+     * ```
+     */
+    template<typename T, typename CharT = char>
+    class format_spec {
+    public:
+        using formatter_type = std::formatter<T, CharT>;
+
+        consteval explicit format_spec(const CharT* spec) : format_spec(std::basic_string_view<CharT>(spec)) {}
+
+        consteval explicit format_spec(std::basic_string_view<CharT> spec) : m_formatter() {
+            std::basic_format_parse_context<CharT> ctx(spec);
+            auto iter = m_formatter.parse(ctx);
+            if (iter != ctx.end()) throw std::format_error("Format spec is not fully parsed");
+        }
+
+        template<typename FormatContext>
+        FormatContext::iterator format(const T& value, FormatContext& ctx) const {
+            return m_formatter.format(value, ctx);
+        }
+
+        [[nodiscard]] constexpr const formatter_type& formatter() const noexcept {
+            return m_formatter;
+        }
+
+    private:
+        formatter_type m_formatter;
+    };
+
+    /**
+     * @brief 将值与预先解析好的格式绑定，用于std::format等函数的参数。
+     *
+     * 仅保存引用，因此只应当在格式化函数的参数中临时使用。
+     */
+    template<typename T, typename CharT>
+    struct format_with_spec {
+        const format_spec<T, CharT>& spec;
+        const T& value;
+    };
+
+    template<typename T, typename CharT>
+    [[nodiscard]] constexpr format_with_spec<T, CharT>
+    with_spec(const format_spec<T, CharT>& spec, const T& value) noexcept {
+        return { spec, value };
+    }
+
+    /**
+     * @brief 使用预先解析好的格式格式化value，返回格式化后的字符串。
+     */
+    template<typename T, typename CharT>
+    [[nodiscard]] std::basic_string<CharT> format_with(const format_spec<T, CharT>& spec, const T& value) {
+        if constexpr (std::is_same_v<CharT, char>) return std::format("{}", with_spec(spec, value));
+        else return std::format(L"{}", with_spec(spec, value));
+    }
+
+}
+
+/**
+ * @brief 输出与预先解析好的格式绑定的值，格式化字符串中不能再指定格式。
+ */
+template<typename T, typename CharT>
+class std::formatter<C163q::format_with_spec<T, CharT>, CharT> {
+public:
+    template<typename ParseContext>
+    constexpr ParseContext::iterator parse(ParseContext& ctx) {
+        auto iter = ctx.begin();
+        if (iter != ctx.end() && *iter != CharT('}')) {
+            throw std::format_error("Format spec is already bound by C163q::with_spec");
+        }
+        return iter;
+    }
+
+    template<typename FormatContext>
+    FormatContext::iterator format(const C163q::format_with_spec<T, CharT>& value, FormatContext& ctx) const {
+        return value.spec.format(value.value, ctx);
+    }
+};
+
+
+#endif // MY_CXX20
+#endif // !C163Q_MY_CPP_UTILS_FORMAT_SPEC_HPP
@@ -0,0 +1,376 @@
+/*!
+ * @file rs/coroutine.hpp
+ * @brief 使返回Result的函数可以作为协程，通过co_await传播Err
+ *
+ * 返回Result<T, E>的协程中，co_await一个Result<U, F>时：若为Ok则得到其值；若为Err则用其Err值构造E，
+ * 作为整个协程的返回值并立即结束协程，相当于rust中的?运算符。co_return的值作为Ok值返回
+ * （也可以直接co_return一个Result<T, E>）。
+ *
+ * 协程在调用时立即执行，直到co_return或者遇到Err为止，返回时协程帧已经被销毁，因此协程帧不会逃逸出调用处，
+ * 支持的编译器可以在内联后省去协程帧的分配（HALO）。否则协程帧默认从每个线程的帧缓存中分配，
+ * 反复调用同一个协程时不会每次都进行堆分配；协程的参数以std::allocator_arg_t, alloc开头时（成员函数则为对象参数之后）
+ * 使用alloc分配协程帧（GCC 13之前的版本对此会给出-Wmismatched-new-delete的误报）。
+ *
+ * 协程中抛出的异常直接传播给调用者。Result协程中只能co_await Result。
+ *
+ * 至少需要C++20，并且编译器必须在协程结束（或第一次挂起）之后才将get_return_object()的返回值转换为Result，
+ * 标准并没有规定转换的时机（CWG2563）。GCC以及Clang 17（Apple Clang 16）之后的版本推迟转换；
+ * MSVC与更早的Clang可能在协程开始运行之前就进行转换，此时还没有协程的结果，因此不能使用这些编译器。
+ *
+ * @since Oct 14, 2026
+ *
+ * @example
+ * ```cpp
+ * C163q::Result<int, std::string> parse(std::string_view s);
+ *
+ * C163q::Result<int, std::string> sum(std::string_view a, std::string_view b) {
+ *     int x = co_await parse(a);      // parse(a)为Err时，sum直接返回该Err
+ *     int y = co_await parse(b);
+ *     co_return x + y;
+ * }
+ * ```
+ */
+
+#ifndef C163Q_MY_CPP_UTILS_RS_COROUTINE_HPP
+#define C163Q_MY_CPP_UTILS_RS_COROUTINE_HPP
+
+#include"../core/config.hpp"
+#ifndef MY_CXX20
+    static_assert(false, "Require C++20!");
+#elif defined(__clang__) && (defined(__apple_build_version__) ? __clang_major__ < 16 : __clang_major__ < 17)
+    static_assert(false, "rs/coroutine.hpp requires Clang 17 (Apple Clang 16) or later!");
+#elif defined(_MSC_VER) && !defined(__clang__)
+    static_assert(false, "rs/coroutine.hpp does not support MSVC!");
+#else
+
+#include<concepts>
+#include<coroutine>
+#include<cstddef>
+#include<memory>
+#include<new>
+#include<optional>
+#include<type_traits>
+#include<utility>
+#include"result.hpp"
+
+namespace C163q {
+
+    namespace detail {
+
+        // 每个协程帧的末尾保存其释放函数，使operator delete不需要知道分配时使用的是帧缓存还是哪一个分配器
+        using frame_deallocate_fn = void(*)(void* frame, std::size_t size) noexcept;
+
+        inline constexpr std::size_t frame_alignment = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+        constexpr std::size_t frame_align_up(std::size_t n, std::size_t align) noexcept {
+            return (n + align - 1) & ~(align - 1);
+        }
+
+        constexpr std::size_t frame_deallocator_offset(std::size_t size) noexcept {
+            return frame_align_up(size, alignof(frame_deallocate_fn));
+        }
+
+        inline void set_frame_deallocator(void* frame, std::size_t size, frame_deallocate_fn fn) noexcept {
+            ::new (static_cast<unsigned char*>(frame) + frame_deallocator_offset(size)) frame_deallocate_fn(fn);
+        }
+
+        inline frame_deallocate_fn get_frame_deallocator(void* frame, std::size_t size) noexcept {
+            return *std::launder(reinterpret_cast<frame_deallocate_fn*>(
+                        static_cast<unsigned char*>(frame) + frame_deallocator_offset(size)));
+        }
+
+        /**
+         * @brief 每个线程缓存少量已释放的协程帧
+         *
+         * 帧的大小按64字节分级，每一级最多缓存8个，超过1024字节的帧直接使用operator new。
+         * 在其他线程释放的帧会进入释放线程的缓存。
+         */
+        class frame_cache {
+        public:
+            static constexpr std::size_t granularity = 64;
+            static constexpr std::size_t classes = 16;
+            static constexpr std::size_t max_cached = 8;
+
+            frame_cache() noexcept = default;
+            frame_cache(const frame_cache&) = delete;
+            frame_cache& operator=(const frame_cache&) = delete;
+
+            ~frame_cache() {
+                for (std::size_t c = 0; c < classes; ++c) {
+                    while (node* n = m_free[c].head) {
+                        m_free[c].head = n->next;
+                        ::operator delete(n, (c + 1) * granularity);
+                    }
+                }
+            }
+
+            [[nodiscard]] void* allocate(std::size_t bytes) {
+                std::size_t c = (bytes - 1) / granularity;
+                if (c >= classes) return ::operator new(bytes);
+                if (node* n = m_free[c].head) {
+                    m_free[c].head = n->next;
+                    --m_free[c].count;
+                    return n;
+                }
+                return ::operator new((c + 1) * granularity);
+            }
+
+            void deallocate(void* p, std::size_t bytes) noexcept {
+                std::size_t c = (bytes - 1) / granularity;
+                if (c >= classes) return ::operator delete(p, bytes);
+                if (m_free[c].count == max_cached) return ::operator delete(p, (c + 1) * granularity);
+                m_free[c].head = ::new (p) node{ m_free[c].head };
+                ++m_free[c].count;
+            }
+
+            static frame_cache& local() noexcept {
+                thread_local frame_cache cache;
+                return cache;
+            }
+
+        private:
+            struct node {
+                node* next;
+            };
+
+            struct bucket {
+                node* head = nullptr;
+                std::size_t count = 0;
+            };
+
+            bucket m_free[classes];
+        };
+
+        struct cached_frame {
+            static constexpr std::size_t total(std::size_t size) noexcept {
+                return frame_deallocator_offset(size) + sizeof(frame_deallocate_fn);
+            }
+
+            static void* allocate(std::size_t size) {
+                void* frame = frame_cache::local().allocate(total(size));
+                set_frame_deallocator(frame, size, &deallocate);
+                return frame;
+            }
+
+            static void deallocate(void* frame, std::size_t size) noexcept {
+                frame_cache::local().deallocate(frame, total(size));
+            }
+        };
+
+        // 使用Alloc分配的协程帧，分配器的副本保存在释放函数之后
+        template<typename Alloc>
+        struct allocator_frame {
+            struct alignas(frame_alignment) block {
+                unsigned char bytes[frame_alignment];
+            };
+
+            using allocator_type = typename std::allocator_traits<Alloc>::template rebind_alloc<block>;
+            using traits = std::allocator_traits<allocator_type>;
+
+            static_assert(alignof(allocator_type) <= frame_alignment);
+
+            static constexpr std::size_t allocator_offset(std::size_t size) noexcept {
+                return frame_align_up(frame_deallocator_offset(size) + sizeof(frame_deallocate_fn),
+                        alignof(allocator_type));
+            }
+
+            static constexpr std::size_t blocks(std::size_t size) noexcept {
+                return (allocator_offset(size) + sizeof(allocator_type) + frame_alignment - 1) / frame_alignment;
+            }
+
+            static allocator_type* stored_allocator(void* frame, std::size_t size) noexcept {
+                return std::launder(reinterpret_cast<allocator_type*>(
+                            static_cast<unsigned char*>(frame) + allocator_offset(size)));
+            }
+
+            static void* allocate(std::size_t size, const Alloc& alloc) {
+                allocator_type a(alloc);
+                void* frame = std::to_address(traits::allocate(a, blocks(size)));
+                ::new (static_cast<unsigned char*>(frame) + allocator_offset(size)) allocator_type(std::move(a));
+                set_frame_deallocator(frame, size, &deallocate);
+                return frame;
+            }
+
+            static void deallocate(void* frame, std::size_t size) noexcept {
+                allocator_type* stored = stored_allocator(frame, size);
+                allocator_type a(std::move(*stored));
+                stored->~allocator_type();
+                traits::deallocate(a, static_cast<block*>(frame), blocks(size));
+            }
+        };
+
+
+        /**
+         * @brief Result协程的返回对象，协程结束后被转换为Result<T, E>
+         *
+         * 协程运行期间promise通过指针写入结果，因此不可复制或移动。
+         */
+        template<typename T, typename E>
+        class result_coroutine_return {
+        public:
+            explicit result_coroutine_return(result_coroutine_return*& slot) noexcept {
+                slot = this;
+            }
+            result_coroutine_return(const result_coroutine_return&) = delete;
+            result_coroutine_return& operator=(const result_coroutine_return&) = delete;
+
+            operator Result<T, E>() {
+                // 编译器在协程运行之前就进行转换（见文件开头的说明）时，此时还没有结果
+                if (!m_value) [[unlikely]] panic("Result coroutine: return object converted before the coroutine finished");
+                return std::move(*m_value);
+            }
+
+            template<typename ...Args>
+            void emplace(Args&&... args) {
+                m_value.emplace(std::forward<Args>(args)...);
+            }
+
+        private:
+            std::optional<Result<T, E>> m_value;
+        };
+
+
+        /**
+         * @brief co_await Result时使用的awaiter
+         *
+         * 若为Ok则不挂起，await_resume得到Ok值（右值时移动出来，左值时返回引用）；
+         * 若为Err则将Err值写入协程的返回对象并销毁协程帧，控制返回到协程的调用者。
+         */
+        template<typename R, typename T, typename E>
+        class result_awaiter {
+            using result_type = std::remove_cvref_t<R>;
+            using value_type = typename result_type::value_type;
+
+        public:
+            result_awaiter(R&& result, result_coroutine_return<T, E>* out) noexcept
+                : m_result(std::forward<R>(result)), m_out(out) {}
+
+            [[nodiscard]] bool await_ready() const noexcept {
+                return m_result.is_ok();
+            }
+
+            void await_suspend(std::coroutine_handle<> handle) {
+                m_out->emplace(std::in_place_index<1>, std::forward<R>(m_result).template get_uncheck<1>());
+                handle.destroy();
+            }
+
+            decltype(auto) await_resume() {
+                if constexpr (std::is_void_v<value_type>) {
+                    return;
+                } else if constexpr (std::is_lvalue_reference_v<R>) {
+                    return m_result.template get_uncheck<0>();
+                } else {
+                    return value_type(std::move(m_result.template get_uncheck<0>()));
+                }
+            }
+
+        private:
+            R&& m_result;
+            result_coroutine_return<T, E>* m_out;
+        };
+
+
+        // promise_type的基类，提供协程帧的分配与释放，task等其他协程类型也使用它
+        struct frame_allocation {
+            // 默认从当前线程的帧缓存中分配
+            static void* operator new(std::size_t size) {
+                return cached_frame::allocate(size);
+            }
+
+            // 协程的参数以std::allocator_arg_t, alloc开头时使用alloc分配
+            template<typename Alloc, typename ...Args>
+            static void* operator new(std::size_t size, std::allocator_arg_t, const Alloc& alloc, const Args&...) {
+                return allocator_frame<Alloc>::allocate(size, alloc);
+            }
+
+            // 成员函数的第一个参数为对象本身
+            template<typename This, typename Alloc, typename ...Args>
+            static void* operator new(std::size_t size, const This&, std::allocator_arg_t, const Alloc& alloc,
+                    const Args&...) {
+                return allocator_frame<Alloc>::allocate(size, alloc);
+            }
+
+            static void operator delete(void* frame, std::size_t size) noexcept {
+                get_frame_deallocator(frame, size)(frame, size);
+            }
+        };
+
+
+        template<typename T, typename E>
+        class result_promise_base : public frame_allocation {
+        public:
+            [[nodiscard]] result_coroutine_return<T, E> get_return_object() noexcept {
+                return result_coroutine_return<T, E>(m_out);
+            }
+
+            [[nodiscard]] std::suspend_never initial_suspend() const noexcept { return {}; }
+            [[nodiscard]] std::suspend_never final_suspend() const noexcept { return {}; }
+
+            // 异常从unhandled_exception中离开时协程被视为停在最终挂起点（[dcl.fct.def.coroutine]），
+            // 由于此时协程还没有第一次挂起，异常离开的是最初的调用，GCC会在其中销毁协程帧（测试中检查是否泄漏）。
+            // 不能改为保存exception_ptr、在转换为Result时重新抛出：GCC 12在返回对象的转换抛出异常时会再次释放已经
+            // 在final_suspend之后销毁的协程帧
+            [[noreturn]] void unhandled_exception() {
+                throw;
+            }
+
+            template<typename U, typename F>
+                requires std::constructible_from<E, F&&>
+            [[nodiscard]] result_awaiter<Result<U, F>&&, T, E> await_transform(Result<U, F>&& result) noexcept {
+                return result_awaiter<Result<U, F>&&, T, E>(std::move(result), m_out);
+            }
+
+            template<typename U, typename F>
+                requires std::constructible_from<E, F&>
+            [[nodiscard]] result_awaiter<Result<U, F>&, T, E> await_transform(Result<U, F>& result) noexcept {
+                return result_awaiter<Result<U, F>&, T, E>(result, m_out);
+            }
+
+            template<typename U, typename F>
+                requires std::constructible_from<E, const F&>
+            [[nodiscard]] result_awaiter<const Result<U, F>&, T, E> await_transform(
+                    const Result<U, F>& result) noexcept {
+                return result_awaiter<const Result<U, F>&, T, E>(result, m_out);
+            }
+
+        protected:
+            result_coroutine_return<T, E>* m_out = nullptr;
+        };
+
+    }
+
+
+    /**
+     * @brief 返回Result<T, E>的协程的promise_type，见rs/coroutine.hpp
+     */
+    template<typename T, typename E>
+    class result_promise : public detail::result_promise_base<T, E> {
+    public:
+        void return_value(Result<T, E> result) {
+            this->m_out->emplace(std::move(result));
+        }
+
+        template<typename U = T>
+            requires (std::constructible_from<T, U> && !std::is_same_v<std::remove_cvref_t<U>, Result<T, E>>)
+        void return_value(U&& value) {
+            this->m_out->emplace(std::in_place_index<0>, std::forward<U>(value));
+        }
+    };
+
+    template<typename E>
+    class result_promise<void, E> : public detail::result_promise_base<void, E> {
+    public:
+        void return_void() {
+            this->m_out->emplace(std::in_place_index<0>);
+        }
+    };
+
+}
+
+template<typename T, typename E, typename ...Args>
+struct std::coroutine_traits<C163q::Result<T, E>, Args...> {
+    using promise_type = C163q::result_promise<T, E>;
+};
+
+#endif // MY_CXX20
+#endif // !C163Q_MY_CPP_UTILS_RS_COROUTINE_HPP
@@ -0,0 +1,130 @@
+/*!
+ * @file rs/instrument.hpp
+ * @brief 按调用处统计Ok/Err的构造、or_else以及unwrap_or系列函数的回退次数
+ *
+ * 定义MY_UTILS_INSTRUMENT时（见core/config.hpp），Ok()、Err()、Result::or_else()以及
+ * Result::unwrap_or()/unwrap_or_default()会多出一个默认为调用处的std::source_location参数，
+ * 并在每次构造（或者每次走到回退路径）时为该调用处的计数器加一，此时需要链接src/rs/instrument.cpp。
+ * 未定义时这些函数的签名与生成的代码都不受影响。
+ *
+ * 每个线程独占一张固定大小的计数表，记录时只需要查表以及一次relaxed的写入，不需要任何同步；
+ * instrument_snapshot()在任意线程中遍历所有的表并按调用处汇总，因此得到的是近似值。
+ *
+ * 至少需要C++20
+ *
+ * @since Oct 14, 2026
+ */
+
+#ifndef C163Q_MY_CPP_UTILS_RS_INSTRUMENT_HPP
+#define C163Q_MY_CPP_UTILS_RS_INSTRUMENT_HPP
+
+#include"../core/config.hpp"
+#ifndef MY_CXX20
+    static_assert(false, "Require C++20!");
+#else
+
+#include<cstdint>
+#include<source_location>
+#include<string_view>
+#include<type_traits>
+#include<vector>
+
+namespace C163q {
+
+    /**
+     * @brief 被统计的事件
+     */
+    enum class instrument_event : unsigned char {
+        /// 调用Ok()构造Result
+        ok,
+        /// 调用Err()构造Result
+        err,
+        /// Result::or_else()遇到Err，调用了回退的可调用对象（或返回了备选的Result）
+        or_else,
+        /// Result::unwrap_or()/unwrap_or_default()遇到Err，返回了回退值
+        unwrap_or,
+    };
+
+    /**
+     * @brief 返回事件的名称，例如"Err"
+     */
+    [[nodiscard]] std::string_view instrument_event_name(instrument_event event) noexcept;
+
+    /**
+     * @brief 一个调用处的汇总结果
+     */
+    struct instrument_record {
+        std::source_location location;
+        instrument_event event;
+        std::uint64_t count;
+    };
+
+    /**
+     * @brief 为location处的event计数，由MY_INSTRUMENT调用
+     *
+     * 每个线程第一次调用时分配自己的计数表，表满后新的调用处只计入instrument_dropped()。
+     */
+    void instrument_record_(instrument_event event, const std::source_location& location) noexcept;
+
+    /**
+     * @brief 汇总所有线程（包括已经退出的线程）的计数，按次数从多到少排列
+     *
+     * 可以在任意线程中随时调用，与正在进行的计数之间没有同步，因此结果是近似值。
+     *
+     * @example
+     * ```cpp
+     * for (const auto& r : C163q::instrument_snapshot()) {
+     *     std::printf("%s:%u %s %llu\n", r.location.file_name(), unsigned(r.location.line()),
+     *             C163q::instrument_event_name(r.event).data(), (unsigned long long) r.count);
+     * }
+     * ```
+     */
+    [[nodiscard]] std::vector<instrument_record> instrument_snapshot();
+
+    /**
+     * @brief 因为计数表已满而没有被记录的次数
+     */
+    [[nodiscard]] std::uint64_t instrument_dropped() noexcept;
+
+    /**
+     * @brief 将所有计数清零
+     *
+     * 与正在进行的计数之间没有同步，清零的同时发生的计数可能会被保留或丢失。
+     */
+    void instrument_reset() noexcept;
+}
+
+/**
+ * @brief 被统计的函数的调用处参数
+ *
+ * MY_INSTRUMENT_PARAM用于没有其他参数的函数，MY_INSTRUMENT_NEXT_PARAM用于放在其他参数之后。
+ * 未定义MY_UTILS_INSTRUMENT时两者都为空。
+ */
+#ifdef MY_UTILS_INSTRUMENT
+    #define MY_INSTRUMENT_PARAM \
+        const std::source_location instrument_location = std::source_location::current()
+    #define MY_INSTRUMENT_NEXT_PARAM , MY_INSTRUMENT_PARAM
+    #define MY_INSTRUMENT(event) do { \
+            if (!std::is_constant_evaluated()) \
+                ::C163q::instrument_record_(::C163q::instrument_event::event, instrument_location); \
+        } while(0)
+#else
+    #define MY_INSTRUMENT_PARAM
+    #define MY_INSTRUMENT_NEXT_PARAM
+    #define MY_INSTRUMENT(event) ((void) 0)
+#endif
+
+/**
+ * @brief 接受参数包的被统计函数
+ *
+ * 参数包之后无法再放置带默认值的调用处参数，因此统计时Ok()/Err()等为0至4个参数分别提供重载，
+ * 参数包版本只用于更多的参数（不被统计）。MY_INSTRUMENT_VARIADIC_ARITY(Args)为参数包版本的约束。
+ */
+#ifdef MY_UTILS_INSTRUMENT
+    #define MY_INSTRUMENT_VARIADIC_ARITY(Args) (sizeof...(Args) > 4)
+#else
+    #define MY_INSTRUMENT_VARIADIC_ARITY(Args) true
+#endif
+
+#endif // MY_CXX20
+#endif // !C163Q_MY_CPP_UTILS_RS_INSTRUMENT_HPP
@@ -15,8 +15,15 @@
     static_assert(false, "Require C++17!");
 #else
 
+#include<array>
+#include<cstddef>
+#include<functional>
+#include<iterator>
+#include<memory>
+#include<type_traits>
 #include<utility>
 #include<variant>
+#include<vector>
 
 namespace C163q {
 
@@ -28,6 +35,74 @@ namespace C163q {
     template <typename ...T>
     overload(T...) -> overload<T...>;
 
+    template<typename V>
+    struct is_variant : std::false_type {};
+
+    template<typename ...T>
+    struct is_variant<std::variant<T...>> : std::true_type {};
+
+    template<typename V>
+    inline constexpr bool is_variant_v = is_variant<V>::value;
+
+    /**
+     * @brief 可选项数量超过该值时，match使用switch跳转表分派，否则使用std::visit
+     *
+     * 可以在包含该头文件之前定义MY_MATCH_SWITCH_THRESHOLD修改该值
+     */
+#ifdef MY_MATCH_SWITCH_THRESHOLD
+    inline constexpr std::size_t match_switch_threshold = MY_MATCH_SWITCH_THRESHOLD;
+#else
+    inline constexpr std::size_t match_switch_threshold = 8;
+#endif
+
+    namespace detail {
+
+        // 每一层switch分派的可选项数量
+        inline constexpr std::size_t match_switch_width = 16;
+
+        template<typename R, typename F, typename V, std::size_t ...I>
+        consteval bool match_same_result(std::index_sequence<I...>) {
+            return (std::is_same_v<std::invoke_result_t<F, decltype(std::get<I>(std::declval<V>()))>, R> && ...);
+        }
+
+        /**
+         * @brief 使用switch分派，每层处理[Base, Base + match_switch_width)中的可选项，其余交给下一层
+         *
+         * 与std::visit相同，对每个可选项调用f的返回值类型都必须是R，而不会被隐式转换为R。
+         */
+        template<std::size_t Base, typename R, typename V, typename F>
+        constexpr R match_switch(std::size_t index, V&& v, F&& f) {
+            constexpr std::size_t size = std::variant_size_v<std::remove_cv_t<std::remove_reference_t<V>>>;
+            if constexpr (Base == 0) {
+                static_assert(match_same_result<R, F&&, V&&>(std::make_index_sequence<size>{}),
+                        "match requires all handlers to return the same type");
+            }
+
+#define MY_MATCH_CASE(K) \
+            case Base + K: \
+                if constexpr (Base + K < size) \
+                    return std::invoke(std::forward<F>(f), std::get<Base + K>(std::forward<V>(v))); \
+                else break
+
+            switch (index) {
+                MY_MATCH_CASE(0); MY_MATCH_CASE(1); MY_MATCH_CASE(2); MY_MATCH_CASE(3);
+                MY_MATCH_CASE(4); MY_MATCH_CASE(5); MY_MATCH_CASE(6); MY_MATCH_CASE(7);
+                MY_MATCH_CASE(8); MY_MATCH_CASE(9); MY_MATCH_CASE(10); MY_MATCH_CASE(11);
+                MY_MATCH_CASE(12); MY_MATCH_CASE(13); MY_MATCH_CASE(14); MY_MATCH_CASE(15);
+                default:
+                    if constexpr (Base + match_switch_width < size)
+                        return match_switch<Base + match_switch_width, R>(
+                                index, std::forward<V>(v), std::forward<F>(f));
+                    break;
+            }
+
+#undef MY_MATCH_CASE
+            // 只有valueless_by_exception时才会到达这里
+            throw std::bad_variant_access();
+        }
+
+    }
+
     /**
      * @brief 一个类似于rust语言match表达式的函数.
      *
@@ -79,7 +154,163 @@ namespace C163q {
      */
     template <typename ...T, typename ...F>
     constexpr auto match(const std::variant<T...>& v, F&&... func) {
-        return std::visit(overload{ std::forward<F>(func)... }, v);
+        if constexpr (sizeof...(T) <= match_switch_threshold) {
+            return std::visit(overload{ std::forward<F>(func)... }, v);
+        } else {
+            auto f = overload{ std::forward<F>(func)... };
+            using R = std::invoke_result_t<decltype(f)&&, const std::variant_alternative_t<0, std::variant<T...>>&>;
+            return detail::match_switch<0, R>(v.index(), v, std::move(f));
+        }
+    }
+
+    /**
+     * @brief match的通用版本，接受任意值类别的std::variant，保有的值会被完美转发给匹配的函数。
+     *
+     * 可选项数量不超过match_switch_threshold时使用std::visit，
+     * 否则使用编译期生成的switch跳转表，避免std::visit在可选项很多时较差的代码生成。
+     * 两种情况下所有可选项所调用的函数都必须返回相同的类型。
+     *
+     * @example
+     * ```cpp
+     * std::variant<int, std::string> v { std::string("hello") };
+     * std::string s = C163q::match(std::move(v),
+     *         [] (int) { return std::string(); },
+     *         [] (std::string&& s) { return std::move(s); }  // 移动而不是复制
+     *         );
+     * ```
+     *
+     * @throw std::bad_variant_access 当v处于valueless_by_exception状态时
+     */
+    template <typename V, typename ...F,
+             std::enable_if_t<is_variant_v<std::remove_cv_t<std::remove_reference_t<V>>> &&
+                (!std::is_lvalue_reference_v<V> || !std::is_const_v<std::remove_reference_t<V>>), int> = 0>
+    constexpr decltype(auto) match(V&& v, F&&... func) {
+        using variant_type = std::remove_cv_t<std::remove_reference_t<V>>;
+        constexpr std::size_t size = std::variant_size_v<variant_type>;
+        auto f = overload{ std::forward<F>(func)... };
+        if constexpr (size <= match_switch_threshold) {
+            return std::visit(std::move(f), std::forward<V>(v));
+        } else {
+            using R = std::invoke_result_t<decltype(f)&&, decltype(std::get<0>(std::forward<V>(v)))>;
+            return detail::match_switch<0, R>(v.index(), std::forward<V>(v), std::move(f));
+        }
+    }
+
+
+    /**
+     * @brief match_range处理元素的方式
+     */
+    enum class match_range_policy {
+        /// 按照原有顺序逐个match
+        in_order,
+        /// 先按照index()将元素分桶，再依次对每个桶调用对应的函数，不保证处理顺序
+        bucketed,
+    };
+
+    namespace detail {
+
+        // 每次分桶处理的元素数量，指针数组放在栈上，不需要堆分配
+        inline constexpr std::size_t match_range_chunk = 256;
+
+        template<std::size_t ...I, typename P, typename F>
+        void match_buckets(std::index_sequence<I...>, P* const* order,
+                const std::size_t* offset, F& f) {
+            // 同一个桶内的元素类型相同，循环内只有一个直接调用
+            ([&] {
+                P* const* first = order + offset[I];
+                P* const* last = order + offset[I + 1];
+                for (; first != last; ++first) std::invoke(f, *std::get_if<I>(*first));
+            }(), ...);
+        }
+
+        /**
+         * @brief 处理一批元素，uniform不为std::variant_npos时表示这批元素都保有第uniform个可选项
+         */
+        template<typename P, typename F>
+        void match_chunk(P* const* elements, std::size_t n, std::size_t uniform, F& f) {
+            constexpr std::size_t size = std::variant_size_v<std::remove_cv_t<P>>;
+
+            // 已经按照类型排好序的输入中，大多数批次只包含一种可选项，此时不需要分桶
+            if (uniform != std::variant_npos) {
+                std::size_t all[size + 1];
+                for (std::size_t i = 0; i <= size; ++i) all[i] = i <= uniform ? 0 : n;
+                match_buckets(std::make_index_sequence<size>{}, elements, all, f);
+                return;
+            }
+
+            // 统计每种可选项的数量
+            std::size_t offset[size + 1] = {};
+            for (std::size_t k = 0; k < n; ++k) ++offset[elements[k]->index() + 1];
+            for (std::size_t i = 0; i < size; ++i) offset[i + 1] += offset[i];
+
+            // 将元素的地址放入对应的桶中
+            P* order[match_range_chunk];
+            std::size_t position[size];
+            for (std::size_t i = 0; i < size; ++i) position[i] = offset[i];
+            for (std::size_t k = 0; k < n; ++k) order[position[elements[k]->index()]++] = elements[k];
+
+            match_buckets(std::make_index_sequence<size>{}, order, offset, f);
+        }
+
+    }
+
+    /**
+     * @brief 对range中的每个std::variant调用match，函数的返回值会被忽略。
+     *
+     * 使用match_range_policy::bucketed（默认）时，每次取出一批（256个）元素，
+     * 统计每种可选项的数量并将元素的地址分桶（指针数组位于栈上，不会进行堆分配），
+     * 再对每个桶在一个紧凑的循环中调用对应的函数，
+     * 从而将每个元素一次的数据相关的间接跳转变为少数几个可预测、可向量化的循环。
+     * 同一批内的元素会按照可选项的顺序（而不是原有顺序）被处理，同一可选项的元素之间保持原有顺序。
+     * 若输入已经按照类型排好序，逐个match的分支几乎总能被正确预测，此时match_range_policy::in_order通常更快。
+     *
+     * @tparam Policy 处理元素的方式
+     *
+     * @param range 元素为std::variant的范围，解引用迭代器须得到左值引用
+     * @param func  多个可调用对象，与match相同
+     *
+     * @example
+     * ```cpp
+     * std::vector<std::variant<int, double>> v { 1, 2.0, 3, 4.0 };
+     * int ints = 0;
+     * double doubles = 0;
+     * C163q::match_range(v, [&] (int i) { ints += i; }, [&] (double d) { doubles += d; });
+     * assert(ints == 4 && doubles == 6.0);
+     * ```
+     *
+     * @throw std::bad_variant_access 当某个元素处于valueless_by_exception状态时
+     */
+    template <match_range_policy Policy = match_range_policy::bucketed, typename Range, typename ...F>
+    void match_range(Range&& range, F&&... func) {
+        using reference = decltype(*std::begin(range));
+        using variant_type = std::remove_cv_t<std::remove_reference_t<reference>>;
+        static_assert(is_variant_v<variant_type>, "elements of the range must be std::variant");
+        static_assert(std::is_lvalue_reference_v<reference>, "the range must yield lvalue references");
+
+        if constexpr (Policy == match_range_policy::in_order) {
+            for (auto&& v : range) match(v, func...);
+        } else {
+            using pointer = std::remove_reference_t<reference>*;
+            auto f = overload{ std::forward<F>(func)... };
+
+            pointer elements[detail::match_range_chunk];
+            std::size_t n = 0;
+            std::size_t first = 0;
+            bool mixed = false;
+            for (auto&& v : range) {
+                const std::size_t index = v.index();
+                if (index == std::variant_npos) throw std::bad_variant_access();
+                if (n == 0) first = index;
+                mixed |= index != first;
+                elements[n++] = std::addressof(v);
+                if (n == detail::match_range_chunk) {
+                    detail::match_chunk(elements, n, mixed ? std::variant_npos : first, f);
+                    n = 0;
+                    mixed = false;
+                }
+            }
+            if (n != 0) detail::match_chunk(elements, n, mixed ? std::variant_npos : first, f);
+        }
     }
 
 }
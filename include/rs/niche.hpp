@@ -0,0 +1,512 @@
+/*!
+ * @file rs/niche.hpp
+ * @brief Result与Option的紧凑存储（niche）定制点
+ *
+ * 默认情况下Result<T, E>使用std::variant<T, E>存储，Option<T>使用std::optional<T>存储，都需要额外的判别式以及填充字节。
+ * 若T或E存在永远不会被使用的位模式（例如空指针、保留的枚举值、指针对齐后的低位、特定的NaN），
+ * 则可以将Ok/Err或者Some/None的判别信息放入这些位中，使sizeof(Result<T, E>)、sizeof(Option<T>)与所保有的类型相同。
+ *
+ * 这些特化必须在使用对应的Result或Option之前可见，并且在整个程序中保持一致。
+ *
+ * 至少需要C++20
+ *
+ * @since Oct 14, 2026
+ */
+
+#ifndef C163Q_MY_CPP_UTILS_RS_NICHE_HPP
+#define C163Q_MY_CPP_UTILS_RS_NICHE_HPP
+
+#include"../core/config.hpp"
+#ifndef MY_CXX20
+    static_assert(false, "Require C++20!");
+#else
+
+#include<array>
+#include<bit>
+#include<concepts>
+#include<cstddef>
+#include<cstdint>
+#include<initializer_list>
+#include<limits>
+#include<memory>
+#include<optional>
+#include<type_traits>
+#include<utility>
+
+namespace C163q {
+
+    /**
+     * @brief Result<T, E>的存储布局定制点。
+     *
+     * 默认不启用（enable为false），此时Result使用默认存储。
+     * 用户可以为自己的类型特化该模板（或直接继承下面提供的几种实现），
+     * 特化中需要提供：
+     *
+     * ```cpp
+     * static constexpr bool enable = true;
+     * using storage_type = ...;    // Result中唯一保存的对象，须可默认构造，
+     *                              // 其复制、移动、析构即为Result的复制、移动、析构
+     * static constexpr bool is_ok(const storage_type& s) noexcept;
+     * template<typename ...Args> static constexpr void emplace_ok(storage_type& s, Args&&... args);
+     * template<typename ...Args> static constexpr void emplace_err(storage_type& s, Args&&... args);
+     * static constexpr T& get_ok(storage_type& s) noexcept;                // T为void时不需要
+     * static constexpr const T& get_ok(const storage_type& s) noexcept;    // T为void时不需要
+     * static constexpr E& get_err(storage_type& s) noexcept;
+     * static constexpr const E& get_err(const storage_type& s) noexcept;
+     * ```
+     *
+     * get_ok/get_err仅在对应状态下被调用，emplace_ok/emplace_err负责销毁旧值并构造新值。
+     * 还可以提供static constexpr bool default_ok，为false时Result不能默认构造（例如T()恰好表示Err状态时）。
+     *
+     * @example
+     * ```cpp
+     * struct Node;
+     * enum class Errc : unsigned char { eof, bad_token };
+     *
+     * template<>
+     * struct C163q::result_niche_traits<Node*, Errc>
+     *     : C163q::result_pointer_tag_niche<Node*, Errc> {};
+     *
+     * static_assert(sizeof(C163q::Result<Node*, Errc>) == sizeof(Node*));
+     * ```
+     */
+    template<typename T, typename E>
+    struct result_niche_traits {
+        static constexpr bool enable = false;
+    };
+
+    /**
+     * @brief 使用T中的一个保留值表示Err状态，E必须是空类型（例如std::monostate或空的错误标签类）。
+     *
+     * 适用于“空指针即错误”、“保留的枚举值即错误”等场景，
+     * 例如Result<Node*, not_found>或Result<std::unique_ptr<X>, not_found>。
+     *
+     * @tparam T        Ok时保有的类型，需要可以使用Sentinel构造，并与Sentinel进行==比较
+     * @tparam E        Err时保有的类型，必须为空类型
+     * @tparam Sentinel 表示Err状态的保留值，默认为nullptr
+     *
+     * T()与Sentinel相等时（例如指针、std::unique_ptr），默认构造的Result会处于Err状态，因此此时Result不能默认构造；
+     * 无法在编译期比较T()与Sentinel时同样如此。
+     *
+     * @warning 启用后不能再用Sentinel构造Ok状态的Result，否则其会被视为Err状态！
+     *          同理，移动Ok值之后若被移动的T等于Sentinel（例如std::unique_ptr被移动之后为空），
+     *          原来的Result会变为Err状态。
+     */
+    template<typename T, typename E, auto Sentinel = nullptr>
+    struct result_sentinel_niche {
+        static_assert(std::is_empty_v<E> && std::is_default_constructible_v<E>,
+                "E must be an empty type to share storage with T");
+
+        static constexpr bool enable = true;
+
+        static constexpr bool default_ok = [] {
+            if constexpr (requires { typename std::bool_constant<!(T() == Sentinel)>; }) return !(T() == Sentinel);
+            else return false;
+        }();
+
+        struct storage_type {
+            T ok = T(Sentinel);
+            MY_NO_UNIQUE_ADDRESS E err{};
+        };
+
+        [[nodiscard]] static constexpr bool is_ok(const storage_type& s) noexcept {
+            return !(s.ok == Sentinel);
+        }
+
+        template<typename ...Args>
+        static constexpr void emplace_ok(storage_type& s, Args&&... args) {
+            s.ok = T(std::forward<Args>(args)...);
+        }
+
+        template<typename ...Args>
+        static constexpr void emplace_err(storage_type& s, Args&&... args) {
+            s.err = E(std::forward<Args>(args)...);
+            s.ok = T(Sentinel);
+        }
+
+        [[nodiscard]] static constexpr T& get_ok(storage_type& s) noexcept { return s.ok; }
+        [[nodiscard]] static constexpr const T& get_ok(const storage_type& s) noexcept { return s.ok; }
+        [[nodiscard]] static constexpr E& get_err(storage_type& s) noexcept { return s.err; }
+        [[nodiscard]] static constexpr const E& get_err(const storage_type& s) noexcept { return s.err; }
+    };
+
+    /**
+     * @brief Result<void, E>的特化：使用E中的一个保留值表示Ok状态。
+     *
+     * 例如错误码枚举中的Errc::ok，使得sizeof(Result<void, Errc>) == sizeof(Errc)。
+     *
+     * @warning 启用后不能再用Sentinel构造Err状态的Result，否则其会被视为Ok状态！
+     */
+    template<typename E, auto Sentinel>
+    struct result_sentinel_niche<void, E, Sentinel> {
+        static constexpr bool enable = true;
+
+        struct storage_type {
+            E err = E(Sentinel);
+        };
+
+        [[nodiscard]] static constexpr bool is_ok(const storage_type& s) noexcept {
+            return s.err == Sentinel;
+        }
+
+        static constexpr void emplace_ok(storage_type& s) {
+            s.err = E(Sentinel);
+        }
+
+        template<typename ...Args>
+        static constexpr void emplace_err(storage_type& s, Args&&... args) {
+            s.err = E(std::forward<Args>(args)...);
+        }
+
+        [[nodiscard]] static constexpr E& get_err(storage_type& s) noexcept { return s.err; }
+        [[nodiscard]] static constexpr const E& get_err(const storage_type& s) noexcept { return s.err; }
+    };
+
+    /**
+     * @brief 使用指针对齐后空闲的最低位作为判别式，E保存在指针的其余字节中。
+     *
+     * 适用于Result<T*, Errc>这类“指针或小错误码”的返回值，要求：
+     * - 所指向的类型的对齐至少为2；
+     * - E是平凡可复制的，并且能放入指针除最低字节外的其余字节中；
+     * - 小端序平台（x86-64、AArch64等）。
+     *
+     * @tparam P 指针类型
+     * @tparam E 错误类型
+     *
+     * @warning 由于需要检查对象表示，is_ok()无法在常量求值中使用。
+     */
+    template<typename P, typename E>
+    struct result_pointer_tag_niche {
+        static_assert(std::is_pointer_v<P> && alignof(std::remove_pointer_t<P>) >= 2,
+                "P must be a pointer to a type aligned to at least 2 bytes");
+        static_assert(std::is_trivially_copyable_v<E>, "E must be trivially copyable");
+        static_assert(std::endian::native == std::endian::little,
+                "result_pointer_tag_niche requires a little-endian target");
+
+    private:
+        struct err_repr {
+            unsigned char tag;
+            E value;
+        };
+        static_assert(sizeof(err_repr) <= sizeof(P) && alignof(err_repr) <= alignof(P),
+                "E is too large to be packed into the pointer");
+
+    public:
+        static constexpr bool enable = true;
+
+        union storage_type {
+            P ok = nullptr;
+            err_repr err;
+        };
+
+        [[nodiscard]] static bool is_ok(const storage_type& s) noexcept {
+            // 最低字节在两种状态下都是有效的值：指针的低位或者tag
+            return !(std::bit_cast<std::array<unsigned char, sizeof(storage_type)>>(s)[0] & 1u);
+        }
+
+        template<typename ...Args>
+        static constexpr void emplace_ok(storage_type& s, Args&&... args) {
+            s.ok = P(std::forward<Args>(args)...);
+        }
+
+        template<typename ...Args>
+        static constexpr void emplace_err(storage_type& s, Args&&... args) {
+            s.err = err_repr{ 1u, E(std::forward<Args>(args)...) };
+        }
+
+        [[nodiscard]] static constexpr P& get_ok(storage_type& s) noexcept { return s.ok; }
+        [[nodiscard]] static constexpr const P& get_ok(const storage_type& s) noexcept { return s.ok; }
+        [[nodiscard]] static constexpr E& get_err(storage_type& s) noexcept { return s.err.value; }
+        [[nodiscard]] static constexpr const E& get_err(const storage_type& s) noexcept { return s.err.value; }
+    };
+
+
+    /**
+     * @brief Option<T>的存储布局定制点。
+     *
+     * 默认不启用（enable为false），此时Option<T>使用std::optional<T>存储。
+     * 用户可以为自己的类型特化该模板（或直接继承下面提供的几种实现），特化中需要提供：
+     *
+     * ```cpp
+     * static constexpr bool enable = true;
+     * using storage_type = ...;    // Option中唯一保存的对象，默认构造时为None，
+     *                              // 其复制、移动、析构即为Option的复制、移动、析构
+     * static constexpr bool is_some(const storage_type& s) noexcept;
+     * template<typename ...Args> static constexpr void emplace(storage_type& s, Args&&... args);
+     * static constexpr void reset(storage_type& s) noexcept;
+     * static constexpr T& get(storage_type& s) noexcept;
+     * static constexpr const T& get(const storage_type& s) noexcept;
+     * ```
+     *
+     * get仅在Some状态下被调用，emplace负责销毁旧值（若有）并构造新值。
+     *
+     * @example
+     * ```cpp
+     * // 大量的std::vector<Option<float>>只占用一半的内存
+     * template<>
+     * struct C163q::option_sentinel_traits<float> : C163q::option_nan_sentinel<float> {};
+     *
+     * // 下标中的-1表示None
+     * template<>
+     * struct C163q::option_sentinel_traits<std::size_t> : C163q::option_value_sentinel<std::size_t, std::size_t(-1)> {};
+     *
+     * static_assert(sizeof(C163q::Option<float>) == sizeof(float));
+     * ```
+     */
+    template<typename T>
+    struct option_sentinel_traits {
+        static constexpr bool enable = false;
+    };
+
+    /**
+     * @brief 使用T中的一个保留值表示None，例如下标中的-1或者保留的枚举值。
+     *
+     * T在None状态下也保有Sentinel，因此也可以用于std::unique_ptr等以nullptr为保留值的类型。
+     *
+     * @tparam T        Some时保有的类型，需要可以使用Sentinel构造，并与Sentinel进行==比较
+     * @tparam Sentinel 表示None的保留值
+     *
+     * @warning 启用后不能再用Sentinel构造Some状态的Option，否则其会被视为None！
+     */
+    template<typename T, auto Sentinel>
+    struct option_value_sentinel {
+        static constexpr bool enable = true;
+
+        struct storage_type {
+            T value = T(Sentinel);
+        };
+
+        [[nodiscard]] static constexpr bool is_some(const storage_type& s) noexcept {
+            return !(s.value == Sentinel);
+        }
+
+        template<typename ...Args>
+        static constexpr void emplace(storage_type& s, Args&&... args) {
+            s.value = T(std::forward<Args>(args)...);
+        }
+
+        static constexpr void reset(storage_type& s) noexcept {
+            s.value = T(Sentinel);
+        }
+
+        [[nodiscard]] static constexpr T& get(storage_type& s) noexcept { return s.value; }
+        [[nodiscard]] static constexpr const T& get(const storage_type& s) noexcept { return s.value; }
+    };
+
+    /**
+     * @brief 使用一个特定负载的quiet NaN表示None（NaN-boxing），适用于float与double。
+     *
+     * 比较的是位模式，因此其他的NaN（包括std::numeric_limits<T>::quiet_NaN()以及运算产生的NaN）依然是Some。
+     *
+     * @warning 以None中的值参与运算时，NaN的负载可能会被传播到结果中，使结果被视为None；
+     *          也不能保存从外部读入的、恰好具有该位模式的值。
+     */
+    template<std::floating_point T>
+        requires (std::numeric_limits<T>::is_iec559 && (sizeof(T) == 4 || sizeof(T) == 8))
+    struct option_nan_sentinel {
+        using bits_type = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+
+        /// 表示None的位模式：符号位为0的quiet NaN，负载不同于各平台默认产生的NaN
+        static constexpr bits_type none_bits = sizeof(T) == 4 ? bits_type(0x7fc0'dead) : bits_type(0x7ff8'0000'0000'deadull);
+
+        static constexpr bool enable = true;
+
+        struct storage_type {
+            T value = std::bit_cast<T>(none_bits);
+        };
+
+        [[nodiscard]] static constexpr bool is_some(const storage_type& s) noexcept {
+            return std::bit_cast<bits_type>(s.value) != none_bits;
+        }
+
+        template<typename ...Args>
+        static constexpr void emplace(storage_type& s, Args&&... args) {
+            s.value = T(std::forward<Args>(args)...);
+        }
+
+        static constexpr void reset(storage_type& s) noexcept {
+            s.value = std::bit_cast<T>(none_bits);
+        }
+
+        [[nodiscard]] static constexpr T& get(storage_type& s) noexcept { return s.value; }
+        [[nodiscard]] static constexpr const T& get(const storage_type& s) noexcept { return s.value; }
+    };
+
+    /**
+     * @brief 使用bool中不会出现的位模式2表示None，使sizeof(Option<bool>) == 1。
+     *
+     * @warning 由于需要检查对象表示，is_some()无法在常量求值中使用。
+     */
+    struct option_bool_niche {
+        static_assert(sizeof(bool) == 1, "option_bool_niche requires a one-byte bool");
+
+        static constexpr bool enable = true;
+
+        union storage_type {
+            unsigned char none = 2;
+            bool value;
+        };
+
+        [[nodiscard]] static bool is_some(const storage_type& s) noexcept {
+            return std::bit_cast<unsigned char>(s) != 2;
+        }
+
+        template<typename ...Args>
+        static constexpr void emplace(storage_type& s, Args&&... args) {
+            s.value = bool(std::forward<Args>(args)...);
+        }
+
+        static constexpr void reset(storage_type& s) noexcept {
+            s.none = 2;
+        }
+
+        [[nodiscard]] static constexpr bool& get(storage_type& s) noexcept { return s.value; }
+        [[nodiscard]] static constexpr const bool& get(const storage_type& s) noexcept { return s.value; }
+    };
+
+
+    namespace detail {
+
+        template<typename T>
+        struct is_std_optional : std::false_type {};
+
+        template<typename T>
+        struct is_std_optional<std::optional<T>> : std::true_type {};
+
+        /**
+         * @brief option_sentinel_traits<T>::enable为true时Option<T>的存储，提供Option所使用的std::optional<T>的接口。
+         */
+        template<typename T>
+        class option_niche_storage {
+            using traits = option_sentinel_traits<T>;
+
+            template<typename U>
+            static constexpr bool is_value_v = std::is_constructible_v<T, U> &&
+                !std::is_same_v<std::remove_cvref_t<U>, option_niche_storage> &&
+                !std::is_same_v<std::remove_cvref_t<U>, std::nullopt_t> &&
+                !std::is_same_v<std::remove_cvref_t<U>, std::in_place_t> &&
+                !is_std_optional<std::remove_cvref_t<U>>::value;
+
+        public:
+            using value_type = T;
+
+            constexpr option_niche_storage() noexcept = default;
+            constexpr option_niche_storage(std::nullopt_t) noexcept {}
+
+            template<typename ...Args>
+            constexpr explicit option_niche_storage(std::in_place_t, Args&&... args) {
+                traits::emplace(m_storage, std::forward<Args>(args)...);
+            }
+
+            template<typename U, typename ...Args>
+            constexpr explicit option_niche_storage(std::in_place_t, std::initializer_list<U> ilist, Args&&... args) {
+                traits::emplace(m_storage, ilist, std::forward<Args>(args)...);
+            }
+
+            template<typename U>
+            constexpr option_niche_storage(const std::optional<U>& other) {
+                if (other) traits::emplace(m_storage, *other);
+            }
+
+            template<typename U>
+            constexpr option_niche_storage(std::optional<U>&& other) {
+                if (other) traits::emplace(m_storage, std::move(*other));
+            }
+
+            template<typename U = T>
+                requires is_value_v<U>
+            constexpr option_niche_storage(U&& value) {
+                traits::emplace(m_storage, std::forward<U>(value));
+            }
+
+            constexpr option_niche_storage& operator=(std::nullopt_t) noexcept {
+                reset();
+                return *this;
+            }
+
+            template<typename U>
+            constexpr option_niche_storage& operator=(const std::optional<U>& other) {
+                if (other) *this = *other;
+                else reset();
+                return *this;
+            }
+
+            template<typename U>
+            constexpr option_niche_storage& operator=(std::optional<U>&& other) {
+                if (other) *this = std::move(*other);
+                else reset();
+                return *this;
+            }
+
+            template<typename U = T>
+                requires is_value_v<U>
+            constexpr option_niche_storage& operator=(U&& value) {
+                if (has_value()) **this = std::forward<U>(value);
+                else traits::emplace(m_storage, std::forward<U>(value));
+                return *this;
+            }
+
+            [[nodiscard]] constexpr bool has_value() const noexcept {
+                return traits::is_some(m_storage);
+            }
+
+            [[nodiscard]] constexpr explicit operator bool() const noexcept {
+                return has_value();
+            }
+
+            [[nodiscard]] constexpr T& operator*() & noexcept { return traits::get(m_storage); }
+            [[nodiscard]] constexpr const T& operator*() const& noexcept { return traits::get(m_storage); }
+            [[nodiscard]] constexpr T&& operator*() && noexcept { return std::move(traits::get(m_storage)); }
+            [[nodiscard]] constexpr const T&& operator*() const&& noexcept { return std::move(traits::get(m_storage)); }
+
+            [[nodiscard]] constexpr T* operator->() noexcept { return std::addressof(traits::get(m_storage)); }
+            [[nodiscard]] constexpr const T* operator->() const noexcept { return std::addressof(traits::get(m_storage)); }
+
+            template<typename ...Args>
+            constexpr T& emplace(Args&&... args) {
+                traits::emplace(m_storage, std::forward<Args>(args)...);
+                return traits::get(m_storage);
+            }
+
+            constexpr void reset() noexcept {
+                traits::reset(m_storage);
+            }
+
+            constexpr void swap(option_niche_storage& other)
+                noexcept(std::is_nothrow_move_constructible_v<T> && std::is_nothrow_swappable_v<T>) {
+                if (has_value() && other.has_value()) {
+                    using std::swap;
+                    swap(**this, *other);
+                } else if (has_value()) {
+                    other.emplace(std::move(**this));
+                    reset();
+                } else if (other.has_value()) {
+                    emplace(std::move(*other));
+                    other.reset();
+                }
+            }
+
+            [[nodiscard]] constexpr operator std::optional<T>() const& {
+                if (has_value()) return std::optional<T>(std::in_place, **this);
+                return std::nullopt;
+            }
+
+            [[nodiscard]] constexpr operator std::optional<T>() && {
+                if (has_value()) return std::optional<T>(std::in_place, std::move(**this));
+                return std::nullopt;
+            }
+
+        private:
+            typename traits::storage_type m_storage;
+        };
+
+        template<typename T>
+        using option_storage_t = std::conditional_t<option_sentinel_traits<T>::enable,
+              option_niche_storage<T>, std::optional<T>>;
+
+    }
+
+}
+
+#endif // MY_CXX20
+#endif // !C163Q_MY_CPP_UTILS_RS_NICHE_HPP
@@ -16,6 +16,7 @@
     static_assert(false, "Require C++20!");
 #else
 
+#include"niche.hpp"
 #include"result.hpp"
 #include"panic.hpp"
 #include<algorithm>
@@ -25,6 +26,8 @@
 #include<initializer_list>
 #include<memory>
 #include<optional>
+#include<ranges>
+#include<source_location>
 #include<string_view>
 #include<tuple>
 #include<type_traits>
@@ -45,7 +48,7 @@ namespace C163q {
         requires (std::is_object_v<T> && !std::is_array_v<T> &&
                  !std::is_same_v<std::remove_cv_t<T>, std::nullopt_t> &&
                  !std::is_same_v<std::remove_cv_t<T>, std::in_place_t>) ||
-                  std::is_same_v<T, void>
+                  std::is_same_v<T, void> || std::is_lvalue_reference_v<T>
     class Option {
     private:
         template<typename U>
@@ -75,8 +78,8 @@ namespace C163q {
             std::is_same<std::remove_cvref_t<U>, std::optional<T>>
         >;
 
-        using as_ref_t = Option<std::reference_wrapper<T>>;
-        using as_cref_t = Option<std::reference_wrapper<const T>>;
+        using as_ref_t = Option<T&>;
+        using as_cref_t = Option<const T&>;
 
 
         template<size_t I, typename U>
@@ -105,6 +108,8 @@ namespace C163q {
 
     public:
         using value_type = T;
+        // option_sentinel_traits<T>启用时不需要额外的判别式，sizeof(Option<T>) == sizeof(T)
+        using storage_type = detail::option_storage_t<T>;
 
 
     public:
@@ -114,10 +119,9 @@ namespace C163q {
         constexpr Option() noexcept : m_data(std::nullopt) {}
         constexpr Option(std::nullopt_t) noexcept : m_data(std::nullopt) {}
 
-        constexpr Option(const Option& other) noexcept(std::is_nothrow_copy_constructible_v<T>)
-            : m_data(other.m_data) {}
-        constexpr Option(Option&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
-            : m_data(std::move(other.m_data)) {}
+        // 复制、移动以及析构均为默认，使得T是平凡的时候Option<T>也是平凡的
+        constexpr Option(const Option&) = default;
+        constexpr Option(Option&&) noexcept(std::is_nothrow_move_constructible_v<T>) = default;
 
         // 使std::optional能够隐式转换为Option
         constexpr Option(const std::optional<T>& other) noexcept(std::is_nothrow_copy_constructible_v<T>)
@@ -131,7 +135,9 @@ namespace C163q {
                         std::true_type, std::negation<possibly_convert_to_option<U>>>::value)
         constexpr explicit(!std::is_convertible_v<const U&, T>)
             Option(const Option<U>& other) noexcept(std::is_nothrow_constructible_v<T, const U&>)
-            : m_data(other.m_data) {}
+            : m_data(std::nullopt) {
+            if (other.is_some()) m_data.emplace(other.get_uncheck());
+        }
 
         template<typename U>
             requires (std::is_constructible_v<T, U> &&
@@ -139,7 +145,9 @@ namespace C163q {
                         std::true_type, std::negation<possibly_convert_to_option<U>>>::value)
         constexpr explicit(!std::is_convertible_v<U, T>)
             Option(Option<U>&& other) noexcept(std::is_nothrow_constructible_v<T, U>)
-            : m_data(std::move(other.m_data)) {}
+            : m_data(std::nullopt) {
+            if (other.is_some()) m_data.emplace(std::move(other.get_uncheck()));
+        }
 
         // 使std::optional能够隐式转换为Option
         template<typename U>
@@ -156,7 +164,7 @@ namespace C163q {
                         std::true_type, std::negation<possibly_convert_to_option<U>>>::value)
         constexpr explicit(!std::is_convertible_v<U, T>)
             Option(std::optional<U>&& other) noexcept(std::is_nothrow_constructible_v<T, U>)
-            : m_data(std::move(other.m_data)) {}
+            : m_data(std::move(other)) {}
 
         template<typename ...Args>
             requires std::is_constructible_v<T, Args...>
@@ -170,6 +178,50 @@ namespace C163q {
             noexcept(std::is_nothrow_constructible_v<T, std::initializer_list<U>&, Args...>)
             : m_data(std::in_place, ilist, std::forward<Args>(args)...) {}
 
+        /**
+         * @brief 使用alloc以uses-allocator方式构造Option
+         *
+         * T使用Alloc（例如std::pmr::string使用std::pmr::polymorphic_allocator<>）时，alloc会被传递给其构造函数，
+         * 否则alloc被忽略，与对应的不带alloc的构造函数相同。T使用Alloc时std::uses_allocator<Option<T>, Alloc>为真，
+         * 因此std::pmr::vector<Option<T>>的元素会使用容器的分配器构造。
+         *
+         * @example
+         * ```cpp
+         * std::pmr::monotonic_buffer_resource arena;
+         * std::pmr::polymorphic_allocator<> alloc(&arena);
+         * C163q::Option<std::pmr::string> x(std::allocator_arg, alloc, std::in_place, 32, 'x');
+         * assert(x.unwrap().get_allocator() == alloc);
+         * ```
+         */
+        template<typename Alloc>
+        constexpr Option(std::allocator_arg_t, const Alloc&) noexcept : m_data(std::nullopt) {}
+
+        template<typename Alloc>
+        constexpr Option(std::allocator_arg_t, const Alloc&, std::nullopt_t) noexcept : m_data(std::nullopt) {}
+
+        template<typename Alloc, typename ...Args>
+            requires constructible_using_allocator<T, Alloc, Args...>
+        constexpr explicit Option(std::allocator_arg_t, const Alloc& alloc, std::in_place_t, Args&&... args)
+            : m_data(std::in_place, invoke_for_construct<T>(make_using_allocator<T>, alloc, std::forward<Args>(args)...)) {}
+
+        template<typename Alloc, typename U = std::remove_cv_t<T>>
+            requires (constructible_using_allocator<T, Alloc, U> && std::is_constructible_v<T, U> &&
+                     !std::is_same_v<std::remove_cvref_t<U>, std::in_place_t> &&
+                     !std::is_same_v<std::remove_cvref_t<U>, std::nullopt_t> &&
+                     !std::is_same_v<std::remove_cvref_t<U>, Option>)
+        constexpr explicit Option(std::allocator_arg_t, const Alloc& alloc, U&& value)
+            : Option(std::allocator_arg, alloc, std::in_place, std::forward<U>(value)) {}
+
+        template<typename Alloc>
+            requires constructible_using_allocator<T, Alloc, const T&>
+        constexpr Option(std::allocator_arg_t, const Alloc& alloc, const Option& other)
+            : m_data(optional_using_allocator(alloc, other)) {}
+
+        template<typename Alloc>
+            requires constructible_using_allocator<T, Alloc, T&&>
+        constexpr Option(std::allocator_arg_t, const Alloc& alloc, Option&& other)
+            : m_data(optional_using_allocator(alloc, std::move(other))) {}
+
         template<typename U = std::remove_cv_t<T>>
             requires (std::is_constructible_v<T, U> &&
                      !std::is_same_v<std::remove_cvref_t<U>, std::in_place_t> &&
@@ -188,19 +240,9 @@ namespace C163q {
             return *this;
         }
 
-        constexpr Option& operator=(const Option& other)
-            noexcept(std::is_nothrow_copy_constructible_v<T> && std::is_nothrow_copy_assignable_v<T>) {
-            if (this == std::addressof(other)) return *this;
-            m_data.operator=(other.m_data);
-            return *this;
-        }
-
-        constexpr Option& operator=(Option&& other)
-            noexcept(std::is_nothrow_move_assignable_v<T> && std::is_nothrow_move_constructible_v<T>) {
-            if (this == std::addressof(other)) return *this;
-            m_data.operator=(std::move(other.m_data));
-            return *this;
-        }
+        constexpr Option& operator=(const Option&) = default;
+        constexpr Option& operator=(Option&&)
+            noexcept(std::is_nothrow_move_assignable_v<T> && std::is_nothrow_move_constructible_v<T>) = default;
 
         // 使std::optional能够隐式转换为Option
         constexpr Option& operator=(const std::optional<T>& other)
@@ -267,13 +309,13 @@ namespace C163q {
 
         [[nodiscard]] constexpr explicit operator std::optional<T>() const&
             noexcept(std::is_nothrow_copy_constructible_v<T>) {
-            return m_data;
+            return std::optional<T>(m_data);
         }
 
 
         [[nodiscard]] constexpr explicit operator std::optional<T>() const&&
             noexcept(std::is_nothrow_move_constructible_v<T>) {
-            return std::move(m_data);
+            return std::optional<T>(std::move(m_data));
         }
 
 
@@ -381,52 +423,62 @@ namespace C163q {
         }
 
 
-        [[nodiscard]] constexpr T unwrap_unchecked() {
+        /**
+         * @brief 不进行检查地取出保有的值，调用者需要保证处于Some状态，否则行为未定义。
+         *        非const时移动存储值，const时复制存储值。
+         *
+         * get_uncheck()等其他未检查的访问函数同理。
+         * 默认情况下该前置条件会被告知编译器，可以省去调用处之后多余的is_some()分支；
+         * 定义MY_UTILS_HARDENED时会进行检查，并在处于None状态时panic，打印调用处的源代码位置（见core/config.hpp）。
+         */
+        [[nodiscard]] constexpr T unwrap_unchecked(
+                const std::source_location location = std::source_location::current()) {
+            MY_UNCHECKED_PRECONDITION(is_some(), "Option has no value", location);
             return std::move(*m_data);
         }
 
 
-        [[nodiscard]] constexpr T unwrap_unchecked() const {
+        [[nodiscard]] constexpr T unwrap_unchecked(
+                const std::source_location location = std::source_location::current()) const {
+            MY_UNCHECKED_PRECONDITION(is_some(), "Option has no value", location);
             return *m_data;
         }
 
 
         [[nodiscard]] constexpr T& get() {
-            try {
-                return m_data.value();
-            } catch (...) {
-                panic("Option has no value");
-            }
+            if (is_some()) return *m_data;
+            panic("Option has no value");
         }
 
 
         [[nodiscard]] constexpr const T& get() const {
-            try {
-                return m_data.value();
-            } catch (...) {
-                panic("Option has no value");
-            }
+            if (is_some()) return *m_data;
+            panic("Option has no value");
         }
 
 
-        [[nodiscard]] constexpr T& get_uncheck() noexcept {
+        [[nodiscard]] constexpr T& get_uncheck(
+                const std::source_location location = std::source_location::current()) MY_UNCHECKED_NOEXCEPT {
+            MY_UNCHECKED_PRECONDITION(is_some(), "Option has no value", location);
             return *m_data;
         }
 
 
-        [[nodiscard]] constexpr const T& get_uncheck() const noexcept {
+        [[nodiscard]] constexpr const T& get_uncheck(
+                const std::source_location location = std::source_location::current()) const MY_UNCHECKED_NOEXCEPT {
+            MY_UNCHECKED_PRECONDITION(is_some(), "Option has no value", location);
             return *m_data;
         }
 
 
         template<typename U, typename F>
             requires (requires (F f, T t) {
-                { std::invoke(f, t) } -> std::convertible_to<U>;
+                { std::invoke(f, std::move(t)) } -> std::convertible_to<U>;
             } && std::is_move_constructible_v<T>)
         [[nodiscard]] constexpr Option<U> map(F&& f)
             noexcept(std::is_nothrow_invocable_v<F, T> && std::is_nothrow_move_constructible_v<T> &&
                      std::is_nothrow_constructible_v<Option<U>, std::in_place_t, std::invoke_result_t<F, T>>) {
-            if (is_some()) return Option<U>(std::in_place, std::invoke(std::forward<F>(f), std::move(*m_data)));
+            if (is_some()) return Option<U>(std::in_place, invoke_for_construct<U>(std::forward<F>(f), std::move(*m_data)));
             return std::nullopt;
         }
 
@@ -438,7 +490,7 @@ namespace C163q {
         [[nodiscard]] constexpr Option<U> map(F&& f) const
             noexcept(std::is_nothrow_invocable_v<F, const T&> &&
                      std::is_nothrow_constructible_v<Option<U>, std::in_place_t, std::invoke_result_t<F, const T&>>) {
-            if (is_some()) return Option<U>(std::in_place, std::invoke(std::forward<F>(f), *m_data));
+            if (is_some()) return Option<U>(std::in_place, invoke_for_construct<U>(std::forward<F>(f), *m_data));
             return std::nullopt;
         }
 
@@ -469,7 +521,7 @@ namespace C163q {
             noexcept(std::is_nothrow_invocable_v<F, T> && std::is_nothrow_move_constructible_v<U> &&
                      std::is_nothrow_constructible_v<U, std::invoke_result_t<F, T>> &&
                      std::is_nothrow_move_constructible_v<T>) {
-            if (is_some()) std::invoke(std::forward<F>(f), std::move(*m_data));
+            if (is_some()) return std::invoke(std::forward<F>(f), std::move(*m_data));
             return default_value;
         }
 
@@ -481,7 +533,7 @@ namespace C163q {
         [[nodiscard]] constexpr U map(U default_value, F&& f) const
             noexcept(std::is_nothrow_invocable_v<F, const T&> && std::is_nothrow_move_constructible_v<U> &&
                      std::is_nothrow_constructible_v<U, std::invoke_result_t<F, const T&>>) {
-            if (is_some()) std::invoke(std::forward<F>(f), *m_data);
+            if (is_some()) return std::invoke(std::forward<F>(f), *m_data);
             return default_value;
         }
 
@@ -496,7 +548,7 @@ namespace C163q {
                      std::is_nothrow_move_constructible_v<U> && std::is_nothrow_move_constructible_v<T> &&
                      std::is_nothrow_constructible_v<U, std::invoke_result_t<F, T>> &&
                      std::is_nothrow_constructible_v<U, std::invoke_result_t<D>>) {
-            if (is_some()) std::invoke(std::forward<F>(f), std::move(*m_data));
+            if (is_some()) return std::invoke(std::forward<F>(f), std::move(*m_data));
             return std::invoke(std::forward<D>(fallback));
         }
 
@@ -511,7 +563,7 @@ namespace C163q {
                      std::is_nothrow_move_constructible_v<U> &&
                      std::is_nothrow_constructible_v<U, std::invoke_result_t<F, const T&>> &&
                      std::is_nothrow_constructible_v<U, std::invoke_result_t<D>>) {
-            if (is_some()) std::invoke(std::forward<F>(f), *m_data);
+            if (is_some()) return std::invoke(std::forward<F>(f), *m_data);
             return std::invoke(std::forward<D>(fallback));
         }
 
@@ -547,7 +599,7 @@ namespace C163q {
                      std::is_nothrow_constructible_v<Result<T, E>, std::in_place_index_t<0>, T> &&
                      std::is_nothrow_constructible_v<Result<T, E>, std::in_place_index_t<1>, std::invoke_result_t<F>>) {
             if (is_some()) return Result<T, E>(std::in_place_index<0>, std::move(*m_data));
-            return Result<T, E>(std::in_place_index<1>, std::invoke(std::forward<F>(err)));
+            return Result<T, E>(std::in_place_index<1>, invoke_for_construct<E>(std::forward<F>(err)));
         }
 
 
@@ -560,7 +612,7 @@ namespace C163q {
                      std::is_nothrow_constructible_v<Result<T, E>, std::in_place_index_t<0>, const T&> &&
                      std::is_nothrow_constructible_v<Result<T, E>, std::in_place_index_t<1>, std::invoke_result_t<F>>) {
             if (is_some()) return Result<T, E>(std::in_place_index<0>, *m_data);
-            return Result<T, E>(std::in_place_index<1>, std::invoke(std::forward<F>(err)));
+            return Result<T, E>(std::in_place_index<1>, invoke_for_construct<E>(std::forward<F>(err)));
         }
 
 
@@ -580,7 +632,7 @@ namespace C163q {
         [[nodiscard]] constexpr Option<U> and_then(F&& f)
             noexcept(std::is_nothrow_invocable_v<F, T> && std::is_nothrow_move_constructible_v<T> &&
                      std::is_nothrow_constructible_v<Option<U>, std::invoke_result_t<F, T>>) {
-            if (is_some()) std::invoke(f, std::move(*m_data));
+            if (is_some()) return std::invoke(std::forward<F>(f), std::move(*m_data));
             return std::nullopt;
         }
 
@@ -592,7 +644,54 @@ namespace C163q {
         [[nodiscard]] constexpr Option<U> and_then(F&& f) const
             noexcept(std::is_nothrow_invocable_v<F, T> &&
                      std::is_nothrow_constructible_v<Option<U>, std::invoke_result_t<F, const T&>>) {
-            if (is_some()) std::invoke(f, *m_data);
+            if (is_some()) return std::invoke(std::forward<F>(f), *m_data);
+            return std::nullopt;
+        }
+
+
+        /**
+         * @brief 与map、and_then相同，但使用alloc以uses-allocator方式构造返回值
+         *        非const时移动存储值，const时复制存储值。
+         *
+         * 若f可以在参数末尾额外接收alloc，则调用f(value, alloc)，返回值类型恰好是U（and_then时为Option<U>）时
+         * 直接构造在返回值中，由f负责使用alloc分配；否则调用f(value)，再使用alloc由返回值构造。
+         *
+         * @example
+         * ```cpp
+         * std::pmr::monotonic_buffer_resource arena;
+         * std::pmr::polymorphic_allocator<> alloc(&arena);
+         * auto x = C163q::Option<int>(3).map<std::pmr::string>(std::allocator_arg, alloc,
+         *         [](int n, const auto& a) { return std::pmr::string(size_t(n), 'x', a); });
+         * assert(x.unwrap() == "xxx" && x.unwrap().get_allocator() == alloc);
+         * ```
+         */
+        template<typename U, typename Alloc, typename F>
+            requires invocable_using_allocator<U, Alloc, F, T&&> && std::is_move_constructible_v<T>
+        [[nodiscard]] constexpr Option<U> map(std::allocator_arg_t, const Alloc& alloc, F&& f) {
+            if (is_some()) return Option<U>(std::in_place, invoke_for_construct<U>(
+                        invoke_using_allocator<U>, alloc, std::forward<F>(f), std::move(*m_data)));
+            return std::nullopt;
+        }
+
+        template<typename U, typename Alloc, typename F>
+            requires invocable_using_allocator<U, Alloc, F, const T&>
+        [[nodiscard]] constexpr Option<U> map(std::allocator_arg_t, const Alloc& alloc, F&& f) const {
+            if (is_some()) return Option<U>(std::in_place, invoke_for_construct<U>(
+                        invoke_using_allocator<U>, alloc, std::forward<F>(f), *m_data));
+            return std::nullopt;
+        }
+
+        template<typename U, typename Alloc, typename F>
+            requires invocable_using_allocator<Option<U>, Alloc, F, T&&> && std::is_move_constructible_v<T>
+        [[nodiscard]] constexpr Option<U> and_then(std::allocator_arg_t, const Alloc& alloc, F&& f) {
+            if (is_some()) return invoke_using_allocator<Option<U>>(alloc, std::forward<F>(f), std::move(*m_data));
+            return std::nullopt;
+        }
+
+        template<typename U, typename Alloc, typename F>
+            requires invocable_using_allocator<Option<U>, Alloc, F, const T&>
+        [[nodiscard]] constexpr Option<U> and_then(std::allocator_arg_t, const Alloc& alloc, F&& f) const {
+            if (is_some()) return invoke_using_allocator<Option<U>>(alloc, std::forward<F>(f), *m_data);
             return std::nullopt;
         }
 
@@ -688,7 +787,7 @@ namespace C163q {
         [[nodiscard]] constexpr T& get_or_insert()
             noexcept(std::is_nothrow_default_constructible_v<T>) {
             if (is_none()) m_data.emplace();
-            return *this;
+            return *m_data;
         }
 
 
@@ -697,13 +796,13 @@ namespace C163q {
             noexcept(std::is_nothrow_invocable_v<F> &&
                      std::is_nothrow_constructible_v<T, std::invoke_result_t<F>>) {
             if (is_none()) m_data.emplace(std::invoke(std::forward<F>(f)));
-            return *this;
+            return *m_data;
         }
 
 
         [[nodiscard]] constexpr Option<T> take()
             noexcept(std::is_nothrow_move_constructible_v<T> && std::is_nothrow_destructible_v<T>) {
-            Option<T> ret(std::move(m_data));
+            Option<T> ret(std::move(*this));
             m_data.reset();
             return ret;
         }
@@ -812,7 +911,7 @@ namespace C163q {
 
         [[nodiscard]] constexpr as_ref_t as_ref() noexcept {
             if (is_none()) return std::nullopt;
-            return as_ref_t(std::in_place, std::ref(*m_data));
+            return as_ref_t(std::in_place, *m_data);
         }
 
 
@@ -823,46 +922,75 @@ namespace C163q {
 
         [[nodiscard]] constexpr as_cref_t as_cref() const noexcept {
             if (is_none()) return std::nullopt;
-            return as_cref_t(std::in_place, std::cref(*m_data));
+            return as_cref_t(std::in_place, *m_data);
         }
 
 
-        [[nodiscard]] const std::optional<T>& data() const noexcept {
+        /**
+         * @brief 底层存储，option_sentinel_traits<T>未启用时为std::optional<T>
+         */
+        [[nodiscard]] const storage_type& data() const noexcept {
             return m_data;
         }
 
+
+        /**
+         * @brief 将Option视为包含0个或1个元素的范围，与rust中的Option::iter()相同。
+         *
+         * @example
+         * ```cpp
+         * auto x = C163q::Some(1);
+         * for (int& i : x) i += 1;
+         * assert(x.get() == 2);
+         * assert(std::ranges::distance(C163q::None<int>()) == 0);
+         * ```
+         */
+        [[nodiscard]] constexpr T* begin() noexcept {
+            return m_data ? std::addressof(*m_data) : nullptr;
+        }
+
+        [[nodiscard]] constexpr const T* begin() const noexcept {
+            return m_data ? std::addressof(*m_data) : nullptr;
+        }
+
+        [[nodiscard]] constexpr T* end() noexcept {
+            return begin() + is_some();
+        }
+
+        [[nodiscard]] constexpr const T* end() const noexcept {
+            return begin() + is_some();
+        }
+
     private:
         /**
          * @brief 调用panic，同时，若类型是formattable时，打印其值
          */
         template<size_t I>
             requires (I == 0 || I == 1)
-        [[noreturn]] constexpr void call_panic_with_TN_uncheck(const std::string_view& msg, const std::string_view& sep) const {
+        MY_COLD [[noreturn]] constexpr void call_panic_with_TN_uncheck(const std::string_view& msg, const std::string_view& sep) const {
             if constexpr (I == 1) {
-                auto && str = std::format("{}{}{}", msg, sep, "None");
-                panic(str);
-            }
-            else if constexpr (
-#ifdef MY_CXX23
-                std::formattable<T, char>
-#else // C++23 ^^^ /  vvv C++20
-                requires (std::formatter<T>& f, const std::formatter<T>& cf, T&& t,
-                    std::format_parse_context& p, std::format_context& fc) {
-                    { f.parse(p) };
-                    { cf.format(t, fc) };
-                }
-#endif
-            ) {
-                auto&& str = std::format("{}{}{}", msg, sep, *m_data);
-                panic(str);
+                constexpr std::string_view none = "None";
+                call_panic_format_(msg, sep, &panic_format_string_, &none);
+            } else if constexpr (panic_pass_by_value_v<T>) {
+                call_panic_format_value_(msg, sep, *m_data);
+            } else if constexpr (panic_formattable<T>) {
+                call_panic_format_(msg, sep, &panic_format_value_<T>, std::addressof(*m_data));
             } else {
                 panic(msg);
             }
         }
 
 
+        template<typename Alloc, typename O>
+        static constexpr std::optional<T> optional_using_allocator(const Alloc& alloc, O&& other) {
+            using value_t = std::conditional_t<std::is_const_v<std::remove_reference_t<O>>, const T&, T&&>;
+            if (other.is_none()) return std::nullopt;
+            return std::optional<T>(std::in_place, invoke_for_construct<T>(
+                        make_using_allocator<T>, alloc, static_cast<value_t>(*other.m_data)));
+        }
+
     private:
-        std::optional<T> m_data;
+        storage_type m_data;
     };
 
 
@@ -879,8 +1007,8 @@ namespace C163q {
         constexpr Option() : m_data(std::nullopt) {}
         constexpr Option(std::nullopt_t) : m_data(std::nullopt) {}
 
-        constexpr Option(const Option& other) noexcept : m_data(other.m_data) {}
-        constexpr Option(Option&& other) noexcept : m_data(std::move(other.m_data)) {}
+        constexpr Option(const Option&) noexcept = default;
+        constexpr Option(Option&&) noexcept = default;
 
         // 使std::optional能够隐式转换为Option
         constexpr Option(const std::optional<std::monostate>& other) noexcept
@@ -907,17 +1035,8 @@ namespace C163q {
             return *this;
         }
 
-        constexpr Option& operator=(const Option& other) noexcept {
-            if (this == std::addressof(other)) return *this;
-            m_data.operator=(other.m_data);
-            return *this;
-        }
-
-        constexpr Option& operator=(Option&& other) noexcept {
-            if (this == std::addressof(other)) return *this;
-            m_data.operator=(std::move(other.m_data));
-            return *this;
-        }
+        constexpr Option& operator=(const Option&) noexcept = default;
+        constexpr Option& operator=(Option&&) noexcept = default;
 
 
         [[nodiscard]] constexpr explicit operator std::optional<std::monostate>() const& noexcept {
@@ -984,20 +1103,20 @@ namespace C163q {
         }
 
 
-        constexpr void unwrap_unchecked() const {
+        constexpr void unwrap_unchecked(
+                const std::source_location location = std::source_location::current()) const {
+            MY_UNCHECKED_PRECONDITION(is_some(), "Option has no value", location);
             return;
         }
 
 
         constexpr const void get() const {
-            try {
-                return;
-            } catch (...) {
-                panic("Option has no value");
-            }
+            if (is_none()) panic("Option has no value");
         }
 
-        constexpr const void get_uncheck() const noexcept {
+        constexpr const void get_uncheck(
+                const std::source_location location = std::source_location::current()) const MY_UNCHECKED_NOEXCEPT {
+            MY_UNCHECKED_PRECONDITION(is_some(), "Option has no value", location);
             return;
         }
 
@@ -1009,7 +1128,7 @@ namespace C163q {
         [[nodiscard]] constexpr Option<U> map(F&& f) const
             noexcept(std::is_nothrow_invocable_v<F> &&
                      std::is_nothrow_constructible_v<Option<U>, std::in_place_t, std::invoke_result_t<F>>) {
-            if (is_some()) return Option<U>(std::in_place, std::invoke(std::forward<F>(f)));
+            if (is_some()) return Option<U>(std::in_place, invoke_for_construct<U>(std::forward<F>(f)));
             return std::nullopt;
         }
 
@@ -1030,7 +1149,7 @@ namespace C163q {
         [[nodiscard]] constexpr U map(U default_value, F&& f) const
             noexcept(std::is_nothrow_invocable_v<F> && std::is_nothrow_move_constructible_v<U> &&
                      std::is_nothrow_constructible_v<U, std::invoke_result_t<F>>) {
-            if (is_some()) std::invoke(std::forward<F>(f));
+            if (is_some()) return std::invoke(std::forward<F>(f));
             return default_value;
         }
 
@@ -1045,7 +1164,7 @@ namespace C163q {
                      std::is_nothrow_move_constructible_v<U> &&
                      std::is_nothrow_constructible_v<U, std::invoke_result_t<F>> &&
                      std::is_nothrow_constructible_v<U, std::invoke_result_t<D>>) {
-            if (is_some()) std::invoke(std::forward<F>(f));
+            if (is_some()) return std::invoke(std::forward<F>(f));
             return std::invoke(std::forward<D>(fallback));
         }
 
@@ -1069,7 +1188,7 @@ namespace C163q {
             noexcept(std::is_nothrow_constructible_v<Result<void, E>, std::in_place_index_t<0>> &&
                      std::is_nothrow_constructible_v<Result<void, E>, std::in_place_index_t<1>, std::invoke_result_t<F>>) {
             if (is_some()) return Result<void, E>(std::in_place_index<0>);
-            return Result<void, E>(std::in_place_index<1>, std::invoke(std::forward<F>(err)));
+            return Result<void, E>(std::in_place_index<1>, invoke_for_construct<E>(std::forward<F>(err)));
         }
 
 
@@ -1089,7 +1208,7 @@ namespace C163q {
         [[nodiscard]] constexpr Option<U> and_then(F&& f) const
             noexcept(std::is_nothrow_invocable_v<F> &&
                      std::is_nothrow_constructible_v<Option<U>, std::invoke_result_t<F>>) {
-            if (is_some()) std::invoke(f);
+            if (is_some()) return std::invoke(std::forward<F>(f));
             return std::nullopt;
         }
 
@@ -1218,19 +1337,423 @@ namespace C163q {
          */
         template<size_t I>
             requires (I == 0 || I == 1)
-        [[noreturn]] constexpr void call_panic_with_TN_uncheck(const std::string_view& msg, const std::string_view& sep) const {
-            if constexpr (I == 1) {
-                auto && str = std::format("{}{}{}", msg, sep, "None");
-                panic(str);
+        MY_COLD [[noreturn]] constexpr void call_panic_with_TN_uncheck(const std::string_view& msg, const std::string_view& sep) const {
+            constexpr std::string_view str = I == 1 ? "None" : "void";
+            call_panic_format_(msg, sep, &panic_format_string_, &str);
+        }
+
+    private:
+        std::optional<std::monostate> m_data;
+    };
+
+
+
+    /**
+     * @brief Option<T&>的特化，内部只保存一个可空的指针
+     *
+     * 与Option<std::reference_wrapper<T>>相比不需要额外的判别式，sizeof(Option<T&>) == sizeof(T*)，
+     * 并且总是平凡可复制的。Option本身的const并不会传递给所引用的对象（与指针相同），
+     * 赋值总是重新绑定引用，而不是对所引用的对象进行赋值。
+     *
+     * @example
+     * ```cpp
+     * int x = 1;
+     * C163q::Option<int&> ref(x);
+     * ref.unwrap() = 2;
+     * assert(x == 2);
+     * assert(ref.copied().unwrap() == 2);
+     * ```
+     */
+    template<typename T>
+    class Option<T&> {
+    private:
+        using value_t = std::remove_cv_t<T>;
+
+    public:
+        using value_type = T&;
+
+    public:
+        constexpr Option() noexcept : m_data(nullptr) {}
+        constexpr Option(std::nullopt_t) noexcept : m_data(nullptr) {}
+
+        constexpr Option(const Option&) = default;
+        constexpr Option(Option&&) = default;
+
+        constexpr Option(T& value) noexcept : m_data(std::addressof(value)) {}
+        constexpr explicit Option(std::in_place_t, T& value) noexcept : m_data(std::addressof(value)) {}
+
+        // 禁止绑定到临时对象上
+        Option(const T&&) = delete;
+        Option(std::in_place_t, const T&&) = delete;
+
+        template<typename U>
+            requires (!std::is_same_v<U, T> && std::is_convertible_v<U*, T*>)
+        constexpr Option(const Option<U&>& other) noexcept : m_data(other.data()) {}
+
+        // 使Option<std::reference_wrapper<T>>能够隐式转换为Option<T&>
+        template<typename U>
+            requires std::is_convertible_v<U*, T*>
+        constexpr Option(const Option<std::reference_wrapper<U>>& other) noexcept
+            : m_data(other.is_some() ? std::addressof(other.get_uncheck().get()) : nullptr) {}
+
+        constexpr ~Option() = default;
+
+
+        constexpr Option& operator=(std::nullopt_t) noexcept {
+            m_data = nullptr;
+            return *this;
+        }
+
+        constexpr Option& operator=(const Option&) = default;
+        constexpr Option& operator=(Option&&) = default;
+
+
+        [[nodiscard]] constexpr bool is_some() const noexcept {
+            return m_data != nullptr;
+        }
+
+
+        template<typename F>
+            requires std::predicate<F, const T&>
+        [[nodiscard]] constexpr bool is_some_and(F&& f) const
+            noexcept(std::is_nothrow_invocable_v<F, const T&> &&
+                     std::is_nothrow_constructible_v<bool, std::invoke_result_t<F, const T&>>) {
+            return is_some() && std::invoke(std::forward<F>(f), const_cast<const T&>(*m_data));
+        }
+
+
+        [[nodiscard]] constexpr bool is_none() const noexcept {
+            return m_data == nullptr;
+        }
+
+
+        template<typename F>
+            requires std::predicate<F, const T&>
+        [[nodiscard]] constexpr bool is_none_or(F&& f) const
+            noexcept(std::is_nothrow_invocable_v<F, const T&> &&
+                     std::is_nothrow_constructible_v<bool, std::invoke_result_t<F, const T&>>) {
+            return is_none() || std::invoke(std::forward<F>(f), const_cast<const T&>(*m_data));
+        }
+
+
+        [[nodiscard]] constexpr T& expect(const std::string_view& msg) const {
+            if (is_some()) return *m_data;
+            call_panic_with_TN_uncheck<1>(msg, ": ");
+        }
+
+
+        [[nodiscard]] constexpr T& unwrap() const {
+            if (is_some()) return *m_data;
+            call_panic_with_TN_uncheck<1>("", "");
+        }
+
+
+        [[nodiscard]] constexpr T& unwrap_or(T& default_value) const noexcept {
+            if (is_some()) return *m_data;
+            return default_value;
+        }
+
+
+        T& unwrap_or(const T&&) const = delete;
+
+
+        template<typename F>
+            requires requires (F f) {
+                { std::invoke(f) } -> std::convertible_to<T&>;
             }
-            else {
-                auto&& str = std::format("{}{}{}", msg, sep, "void");
-                panic(str);
+        [[nodiscard]] constexpr T& unwrap_or(F&& f) const
+            noexcept(std::is_nothrow_invocable_v<F>) {
+            if (is_some()) return *m_data;
+            return std::invoke(std::forward<F>(f));
+        }
+
+
+        [[nodiscard]] constexpr T& unwrap_unchecked(
+                const std::source_location location = std::source_location::current()) const MY_UNCHECKED_NOEXCEPT {
+            MY_UNCHECKED_PRECONDITION(is_some(), "Option has no value", location);
+            return *m_data;
+        }
+
+
+        [[nodiscard]] constexpr T& get() const {
+            if (is_some()) return *m_data;
+            panic("Option has no value");
+        }
+
+
+        [[nodiscard]] constexpr T& get_uncheck(
+                const std::source_location location = std::source_location::current()) const MY_UNCHECKED_NOEXCEPT {
+            MY_UNCHECKED_PRECONDITION(is_some(), "Option has no value", location);
+            return *m_data;
+        }
+
+
+        template<typename U, typename F>
+            requires requires (F f, T& t) {
+                { std::invoke(f, t) } -> std::convertible_to<U>;
             }
+        [[nodiscard]] constexpr Option<U> map(F&& f) const
+            noexcept(std::is_nothrow_invocable_v<F, T&> &&
+                     std::is_nothrow_constructible_v<Option<U>, std::in_place_t, std::invoke_result_t<F, T&>>) {
+            if (is_some()) return Option<U>(std::in_place, invoke_for_construct<U>(std::forward<F>(f), *m_data));
+            return std::nullopt;
+        }
+
+
+        template<typename F>
+            requires std::invocable<F, T&>
+        [[nodiscard]] constexpr const Option& inspect(F&& f) const
+            noexcept(std::is_nothrow_invocable_v<F, T&>) {
+            if (is_some()) std::invoke(std::forward<F>(f), *m_data);
+            return *this;
+        }
+
+
+        template<typename U, typename F>
+            requires (requires (F f, T& t) {
+                { std::invoke(f, t) } -> std::convertible_to<U>;
+            } && std::is_move_constructible_v<U>)
+        [[nodiscard]] constexpr U map(U default_value, F&& f) const
+            noexcept(std::is_nothrow_invocable_v<F, T&> && std::is_nothrow_move_constructible_v<U> &&
+                     std::is_nothrow_constructible_v<U, std::invoke_result_t<F, T&>>) {
+            if (is_some()) return std::invoke(std::forward<F>(f), *m_data);
+            return default_value;
+        }
+
+
+        template<typename U, typename D, typename F>
+            requires (requires (F f, D d, T& t) {
+                { std::invoke(f, t) } -> std::convertible_to<U>;
+                { std::invoke(d) } -> std::convertible_to<U>;
+            })
+        [[nodiscard]] constexpr U map(D&& fallback, F&& f) const
+            noexcept(std::is_nothrow_invocable_v<F, T&> && std::is_nothrow_invocable_v<D> &&
+                     std::is_nothrow_constructible_v<U, std::invoke_result_t<F, T&>> &&
+                     std::is_nothrow_constructible_v<U, std::invoke_result_t<D>>) {
+            if (is_some()) return std::invoke(std::forward<F>(f), *m_data);
+            return std::invoke(std::forward<D>(fallback));
+        }
+
+
+        /**
+         * @brief Result只能保存对象类型，因此Ok时保存的是std::reference_wrapper<T>
+         */
+        template<typename E>
+            requires std::is_move_constructible_v<E>
+        [[nodiscard]] constexpr Result<std::reference_wrapper<T>, E> ok_or(E err) const
+            noexcept(std::is_nothrow_move_constructible_v<E>) {
+            using result_t = Result<std::reference_wrapper<T>, E>;
+            if (is_some()) return result_t(std::in_place_index<0>, std::ref(*m_data));
+            return result_t(std::in_place_index<1>, std::move(err));
+        }
+
+
+        template<typename E, typename F>
+            requires requires (F&& err) {
+                { std::invoke(err) } -> std::convertible_to<E>;
+            }
+        [[nodiscard]] constexpr Result<std::reference_wrapper<T>, E> ok_or_else(F&& err) const
+            noexcept(std::is_nothrow_invocable_v<F> && std::is_nothrow_constructible_v<E, std::invoke_result_t<F>>) {
+            using result_t = Result<std::reference_wrapper<T>, E>;
+            if (is_some()) return result_t(std::in_place_index<0>, std::ref(*m_data));
+            return result_t(std::in_place_index<1>, invoke_for_construct<E>(std::forward<F>(err)));
+        }
+
+
+        template<typename U>
+        [[nodiscard]] constexpr Option<U> and_then(Option<U> other) const
+            noexcept(std::is_nothrow_move_constructible_v<Option<U>>) {
+            if (is_some()) return other;
+            return std::nullopt;
+        }
+
+
+        template<typename U, typename F>
+            requires requires (F f, T& t) {
+                { std::invoke(f, t) } -> std::convertible_to<Option<U>>;
+            }
+        [[nodiscard]] constexpr Option<U> and_then(F&& f) const
+            noexcept(std::is_nothrow_invocable_v<F, T&> &&
+                     std::is_nothrow_constructible_v<Option<U>, std::invoke_result_t<F, T&>>) {
+            if (is_some()) return std::invoke(std::forward<F>(f), *m_data);
+            return std::nullopt;
+        }
+
+
+        template<typename P>
+            requires std::predicate<P, const T&>
+        [[nodiscard]] constexpr Option filter(P&& predicate) const
+            noexcept(std::is_nothrow_invocable_v<P, const T&>) {
+            if (is_some() && std::invoke(std::forward<P>(predicate), const_cast<const T&>(*m_data))) return *this;
+            return std::nullopt;
+        }
+
+
+        [[nodiscard]] constexpr Option or_else(Option other) const noexcept {
+            if (is_some()) return *this;
+            return other;
+        }
+
+
+        template<typename F>
+            requires requires (F f) {
+                { std::invoke(f) } -> std::convertible_to<Option>;
+            }
+        [[nodiscard]] constexpr Option or_else(F&& f) const
+            noexcept(std::is_nothrow_invocable_v<F>) {
+            if (is_some()) return *this;
+            return std::invoke(std::forward<F>(f));
+        }
+
+
+        [[nodiscard]] constexpr Option xor_else(Option other) const noexcept {
+            if (is_some() == other.is_some()) return std::nullopt;
+            if (is_some()) return *this;
+            return other;
+        }
+
+
+        constexpr Option& insert(T& value) noexcept {
+            m_data = std::addressof(value);
+            return *this;
+        }
+
+
+        Option& insert(const T&&) = delete;
+
+
+        [[nodiscard]] constexpr T& get_or_insert(T& value) noexcept {
+            if (is_none()) m_data = std::addressof(value);
+            return *m_data;
+        }
+
+
+        T& get_or_insert(const T&&) = delete;
+
+
+        template<typename F>
+            requires requires (F f) {
+                { std::invoke(f) } -> std::convertible_to<T&>;
+            }
+        [[nodiscard]] constexpr T& get_or_insert(F&& f)
+            noexcept(std::is_nothrow_invocable_v<F>) {
+            if (is_none()) m_data = std::addressof(static_cast<T&>(std::invoke(std::forward<F>(f))));
+            return *m_data;
+        }
+
+
+        [[nodiscard]] constexpr Option take() noexcept {
+            return Option(std::exchange(m_data, nullptr));
+        }
+
+
+        template<typename P>
+            requires std::predicate<P, T&>
+        [[nodiscard]] constexpr Option take(P&& predicate)
+            noexcept(std::is_nothrow_invocable_v<P, T&> &&
+                     std::is_nothrow_constructible_v<bool, std::invoke_result_t<P, T&>>) {
+            if (is_some() && std::invoke(std::forward<P>(predicate), *m_data)) return take();
+            return std::nullopt;
+        }
+
+
+        [[nodiscard]] constexpr Option replace(T& value) noexcept {
+            return Option(std::exchange(m_data, std::addressof(value)));
+        }
+
+
+        Option replace(const T&&) = delete;
+
+
+        template<typename U>
+        [[nodiscard]] constexpr Option<std::pair<std::reference_wrapper<T>, U>> zip(Option<U> other) const
+            noexcept(std::is_nothrow_move_constructible_v<U>) {
+            if (is_some() && other.is_some())
+                return Option<std::pair<std::reference_wrapper<T>, U>>(
+                        std::in_place, std::ref(*m_data), std::move(other.get_uncheck()));
+            return std::nullopt;
+        }
+
+
+        /**
+         * @brief 复制所引用的值，得到Option<T>
+         */
+        [[nodiscard]] constexpr Option<value_t> copied() const
+            noexcept(std::is_nothrow_copy_constructible_v<value_t>)
+            requires std::is_copy_constructible_v<value_t> {
+            if (is_none()) return std::nullopt;
+            return Option<value_t>(std::in_place, *m_data);
+        }
+
+
+        /**
+         * @brief 与copied()相同
+         */
+        [[nodiscard]] constexpr Option<value_t> cloned() const
+            noexcept(std::is_nothrow_copy_constructible_v<value_t>)
+            requires std::is_copy_constructible_v<value_t> {
+            return copied();
+        }
+
+
+        [[nodiscard]] constexpr Option clone() const noexcept {
+            return *this;
+        }
+
+
+        [[nodiscard]] constexpr const Option& as_const() const noexcept {
+            return *this;
+        }
+
+
+        [[nodiscard]] constexpr Option& as_mut() const noexcept {
+            return const_cast<Option&>(*this);
+        }
+
+
+        [[nodiscard]] constexpr Option as_ref() const noexcept {
+            return *this;
+        }
+
+
+        [[nodiscard]] constexpr Option<const T&> as_cref() const noexcept {
+            return Option<const T&>(*this);
+        }
+
+
+        /**
+         * @brief 返回内部保存的指针，为None时返回nullptr
+         */
+        [[nodiscard]] constexpr T* data() const noexcept {
+            return m_data;
+        }
+
+        /**
+         * @brief 将Option<T&>视为包含0个或1个元素的视图（std::ranges::view）
+         */
+        [[nodiscard]] constexpr T* begin() const noexcept {
+            return m_data;
+        }
+
+        [[nodiscard]] constexpr T* end() const noexcept {
+            return m_data + (m_data != nullptr);
         }
 
     private:
-        std::optional<std::monostate> m_data;
+        constexpr explicit Option(T* ptr) noexcept : m_data(ptr) {}
+
+        /**
+         * @brief 调用panic，Option<T&>只会在None时panic
+         */
+        template<size_t I>
+            requires (I == 1)
+        MY_COLD [[noreturn]] constexpr void call_panic_with_TN_uncheck(const std::string_view& msg, const std::string_view& sep) const {
+            constexpr std::string_view none = "None";
+            call_panic_format_(msg, sep, &panic_format_string_, &none);
+        }
+
+    private:
+        T* m_data;
     };
 
 
@@ -1280,6 +1803,74 @@ namespace C163q {
         return Option<option_transform_t<T>>(std::in_place, ini, std::forward<Args>(args)...);
     }
 
+
+    template<typename O>
+    struct is_option : std::false_type {};
+
+    template<typename T>
+    struct is_option<Option<T>> : std::true_type {};
+
+    template<typename O>
+    inline constexpr bool is_option_v = is_option<O>::value;
+
+    /**
+     * @brief 对Option进行match，Some时以保有的值调用on_some，None时不带参数调用on_none。
+     *
+     * 与rust中`match option { Some(v) => ..., None => ... }`相同。保有的值按照option的值类别被完美转发，
+     * Option<void>为Some时on_some不接受参数，Option<T&>总是传递T&。
+     *
+     * @example
+     * ```cpp
+     * auto x = C163q::Some(2);
+     * int y = C163q::match(x, [] (int v) { return v * 2; }, [] { return 0; });
+     * assert(y == 4);
+     * ```
+     */
+    template<typename O, typename FSome, typename FNone>
+        requires is_option_v<std::remove_cvref_t<O>>
+    constexpr decltype(auto) match(O&& option, FSome&& on_some, FNone&& on_none) {
+        using T = std::remove_cvref_t<O>::value_type;
+        if constexpr (std::is_void_v<T>) {
+            using Ret = std::invoke_result_t<FSome>;
+            if (option.is_some()) return static_cast<Ret>(std::invoke(std::forward<FSome>(on_some)));
+            return static_cast<Ret>(std::invoke(std::forward<FNone>(on_none)));
+        } else {
+            auto&& some = [&]() -> decltype(auto) {
+                if constexpr (std::is_lvalue_reference_v<O> || std::is_reference_v<T>)
+                    return option.get_uncheck();
+                else return std::move(option.get_uncheck());
+            };
+            using Ret = std::invoke_result_t<FSome, decltype(some())>;
+            if (option.is_some()) return static_cast<Ret>(std::invoke(std::forward<FSome>(on_some), some()));
+            return static_cast<Ret>(std::invoke(std::forward<FNone>(on_none)));
+        }
+    }
+}
+
+namespace std {
+
+    // T使用Alloc时，Option<T>提供带std::allocator_arg_t的构造函数，从而可以被容器以uses-allocator方式构造
+    template<typename T, typename Alloc>
+        requires std::is_object_v<T>
+    struct uses_allocator<C163q::Option<T>, Alloc> : bool_constant<uses_allocator_v<T, Alloc>> {};
+
+#ifdef __cpp_lib_format_ranges
+    // Option因为begin()/end()而是一个范围，不使用标准库对范围的格式化，Option的格式化见format/option.hpp
+    template<typename T>
+    inline constexpr range_format format_kind<C163q::Option<T>> = range_format::disabled;
+#endif
+
+}
+
+namespace std::ranges {
+
+    // Option<T&>不拥有所引用的对象，复制的开销为O(1)，因此是一个视图，并且其迭代器不依赖于Option本身
+    template<typename T>
+    inline constexpr bool enable_view<C163q::Option<T&>> = true;
+
+    template<typename T>
+    inline constexpr bool enable_borrowed_range<C163q::Option<T&>> = true;
+
 }
 
 #endif // MY_CXX20
@@ -0,0 +1,634 @@
+/*!
+ * @file rs/option_vector.hpp
+ * @brief 以结构数组（structure of arrays）存储Option与Result的容器
+ *
+ * std::vector<Option<T>>中每个元素的判别式与值交错存放，统计有多少个Some或者对所有Some求和时，
+ * 每一条缓存行都需要被读取，并且判别式之间的分支使循环无法向量化。
+ * 这里的option_vector<T>与result_vector<T, E>与Apache Arrow相同，值连续存放，
+ * 另外使用紧凑的位图记录每个元素是否为Some（Ok）：
+ * - count_some()/count_ok()对位图的每个64位字调用std::popcount；
+ * - filter_map()只访问位图中置位的元素，全为0的字直接跳过；
+ * - unwrap_or()对全为1或全为0的字整块复制或填充，其余的字使用无分支的选择。
+ *
+ * None（Err）位置上的值为值初始化的T（Ok位置上的错误为值初始化的E），因此T与E须可默认构造。
+ *
+ * 至少需要C++20
+ *
+ * @since Oct 14, 2026
+ */
+
+#ifndef C163Q_MY_CPP_UTILS_RS_OPTION_VECTOR_HPP
+#define C163Q_MY_CPP_UTILS_RS_OPTION_VECTOR_HPP
+
+#include"../core/config.hpp"
+#ifndef MY_CXX20
+    static_assert(false, "Require C++20!");
+#else
+
+#include<algorithm>
+#include<bit>
+#include<concepts>
+#include<cstddef>
+#include<cstdint>
+#include<functional>
+#include<initializer_list>
+#include<ranges>
+#include<span>
+#include<type_traits>
+#include<utility>
+#include<vector>
+#include"option.hpp"
+
+namespace C163q {
+
+    namespace detail {
+
+        /**
+         * @brief 紧凑的有效性位图，第i个元素对应第i / 64个字的第i % 64位
+         *
+         * 超出size()的位总是为0，因此统计时不需要处理最后一个字。
+         */
+        class validity_bitmap {
+        public:
+            using word_type = std::uint64_t;
+            static constexpr size_t word_bits = 64;
+
+            constexpr validity_bitmap() noexcept = default;
+
+            constexpr validity_bitmap(size_t count, bool value)
+                : m_words((count + word_bits - 1) / word_bits, value ? ~word_type(0) : 0), m_size(count) {
+                clear_tail();
+            }
+
+            [[nodiscard]] constexpr size_t size() const noexcept { return m_size; }
+
+            [[nodiscard]] constexpr bool test(size_t i) const noexcept {
+                return (m_words[i / word_bits] >> (i % word_bits)) & 1;
+            }
+
+            constexpr void set(size_t i, bool value) noexcept {
+                word_type mask = word_type(1) << (i % word_bits);
+                if (value) m_words[i / word_bits] |= mask;
+                else m_words[i / word_bits] &= ~mask;
+            }
+
+            constexpr void push_back(bool value) {
+                if (m_size % word_bits == 0) m_words.push_back(0);
+                ++m_size;
+                set(m_size - 1, value);
+            }
+
+            /**
+             * @brief 保证之后的一次push_back不需要分配内存，因此不会抛出异常
+             *
+             * 与std::vector相同按倍数增长，逐个添加元素的均摊复杂度为O(1)。
+             */
+            constexpr void reserve_back() {
+                if (m_size % word_bits == 0 && m_words.size() == m_words.capacity()) {
+                    m_words.reserve(std::max<size_t>(1, 2 * m_words.capacity()));
+                }
+            }
+
+            constexpr void pop_back() noexcept {
+                set(--m_size, false);
+                if (m_size % word_bits == 0) m_words.pop_back();
+            }
+
+            constexpr void resize(size_t count, bool value) {
+                size_t old = m_size;
+                if (count < old) {
+                    m_words.resize((count + word_bits - 1) / word_bits);
+                    m_size = count;
+                    clear_tail();
+                    return;
+                }
+                m_words.resize((count + word_bits - 1) / word_bits, value ? ~word_type(0) : 0);
+                m_size = count;
+                if (value) {
+                    // 原来最后一个字中的空位
+                    for (size_t i = old; i < count && i % word_bits != 0; ++i) set(i, true);
+                }
+                clear_tail();
+            }
+
+            constexpr void reserve(size_t count) {
+                m_words.reserve((count + word_bits - 1) / word_bits);
+            }
+
+            constexpr void clear() noexcept {
+                m_words.clear();
+                m_size = 0;
+            }
+
+            constexpr void fill(bool value) noexcept {
+                std::ranges::fill(m_words, value ? ~word_type(0) : 0);
+                clear_tail();
+            }
+
+            [[nodiscard]] constexpr size_t count() const noexcept {
+                size_t n = 0;
+                for (word_type w : m_words) n += size_t(std::popcount(w));
+                return n;
+            }
+
+            [[nodiscard]] constexpr std::span<const word_type> words() const noexcept {
+                return m_words;
+            }
+
+            /**
+             * @brief 按下标递增的顺序对每个置位的下标调用f
+             */
+            template<typename F>
+            constexpr void for_each_set(F&& f) const {
+                for (size_t k = 0; k < m_words.size(); ++k) {
+                    for (word_type w = m_words[k]; w != 0; w &= w - 1) {
+                        std::invoke(f, k * word_bits + size_t(std::countr_zero(w)));
+                    }
+                }
+            }
+
+            constexpr void swap(validity_bitmap& other) noexcept {
+                m_words.swap(other.m_words);
+                std::swap(m_size, other.m_size);
+            }
+
+        private:
+            constexpr void clear_tail() noexcept {
+                if (size_t r = m_size % word_bits; r != 0) m_words.back() &= (word_type(1) << r) - 1;
+            }
+
+            std::vector<word_type> m_words;
+            size_t m_size = 0;
+        };
+
+        /**
+         * @brief 将values中bitmap置位的元素复制到out，其余位置填充fallback
+         */
+        template<typename T>
+        constexpr void select_or(const validity_bitmap& bitmap, const T* values, const T& fallback, T* out) {
+            constexpr size_t bits = validity_bitmap::word_bits;
+            auto words = bitmap.words();
+            size_t n = bitmap.size();
+            for (size_t k = 0; k < words.size(); ++k) {
+                size_t base = k * bits;
+                size_t len = std::min(bits, n - base);
+                auto w = words[k];
+                if (len == bits && w == ~validity_bitmap::word_type(0)) {
+                    std::copy(values + base, values + base + bits, out + base);
+                } else if (w == 0) {
+                    std::fill(out + base, out + base + len, fallback);
+                } else {
+                    for (size_t j = 0; j < len; ++j) {
+                        out[base + j] = ((w >> j) & 1) ? values[base + j] : fallback;
+                    }
+                }
+            }
+        }
+
+        /**
+         * @brief 将values中bitmap未置位的元素设为fallback
+         */
+        template<typename T>
+        constexpr void fill_unset(const validity_bitmap& bitmap, T* values, const T& fallback) {
+            constexpr size_t bits = validity_bitmap::word_bits;
+            auto words = bitmap.words();
+            size_t n = bitmap.size();
+            for (size_t k = 0; k < words.size(); ++k) {
+                auto w = words[k];
+                if (w == ~validity_bitmap::word_type(0)) continue;
+                size_t base = k * bits;
+                size_t len = std::min(bits, n - base);
+                for (size_t j = 0; j < len; ++j) {
+                    if (!((w >> j) & 1)) values[base + j] = fallback;
+                }
+            }
+        }
+
+        template<typename F, typename Arg>
+        using filter_map_value_t = typename std::remove_cvref_t<std::invoke_result_t<F, Arg>>::value_type;
+
+    }
+
+    /**
+     * @brief 以值数组加有效性位图存储元素的Option<T>容器
+     *
+     * 值数组为std::vector<T>，因此T不能是bool（std::vector<bool>不能提供元素的引用），可以使用Option<bool>的紧凑存储代替。
+     *
+     * @example
+     * ```cpp
+     * C163q::option_vector<double> v;
+     * v.push_back(C163q::Some(1.5));
+     * v.push_back(C163q::None<double>());
+     * v.emplace_back(2.5);
+     * assert(v.count_some() == 2);
+     * assert(v[1].is_none() && v[2].get() == 2.5);
+     * auto dense = v.unwrap_or(0.0);      // std::vector<double>{ 1.5, 0.0, 2.5 }
+     * ```
+     */
+    template<typename T>
+        requires (std::is_object_v<T> && std::default_initializable<T> && std::movable<T> && !std::is_same_v<T, bool>)
+    class option_vector {
+    public:
+        using value_type = Option<T>;
+        using reference = Option<T&>;
+        using const_reference = Option<const T&>;
+        using size_type = size_t;
+
+        constexpr option_vector() noexcept = default;
+
+        /**
+         * @brief 构造count个None
+         */
+        constexpr explicit option_vector(size_t count) : m_values(count), m_valid(count, false) {}
+
+        /**
+         * @brief 构造count个Some(value)
+         */
+        constexpr option_vector(size_t count, const T& value) : m_values(count, value), m_valid(count, true) {}
+
+        constexpr option_vector(std::initializer_list<Option<T>> ilist) {
+            reserve(ilist.size());
+            for (const auto& o : ilist) push_back(o);
+        }
+
+        /**
+         * @brief 从元素可以转换为Option<T>的范围构造
+         */
+        template<std::ranges::input_range R>
+            requires (std::convertible_to<std::ranges::range_reference_t<R>, Option<T>> &&
+                     !std::same_as<std::remove_cvref_t<R>, option_vector>)
+        constexpr explicit option_vector(R&& range) {
+            if constexpr (std::ranges::sized_range<R>) reserve(size_t(std::ranges::size(range)));
+            for (auto&& o : range) push_back(Option<T>(std::forward<decltype(o)>(o)));
+        }
+
+        [[nodiscard]] constexpr size_t size() const noexcept { return m_values.size(); }
+        [[nodiscard]] constexpr bool empty() const noexcept { return m_values.empty(); }
+
+        constexpr void reserve(size_t count) {
+            m_values.reserve(count);
+            m_valid.reserve(count);
+        }
+
+        constexpr void clear() noexcept {
+            m_values.clear();
+            m_valid.clear();
+        }
+
+        /**
+         * @brief 改变元素个数，新增的元素为None
+         */
+        constexpr void resize(size_t count) {
+            m_valid.reserve(count);
+            m_values.resize(count);
+            m_valid.resize(count, false);
+        }
+
+        [[nodiscard]] constexpr bool is_some(size_t i) const noexcept { return m_valid.test(i); }
+        [[nodiscard]] constexpr bool is_none(size_t i) const noexcept { return !m_valid.test(i); }
+
+        /**
+         * @brief 第i个元素的引用，与Option::as_ref()相同；不检查i是否越界
+         */
+        [[nodiscard]] constexpr reference operator[](size_t i) noexcept {
+            if (is_some(i)) return reference(std::in_place, m_values[i]);
+            return std::nullopt;
+        }
+
+        [[nodiscard]] constexpr const_reference operator[](size_t i) const noexcept {
+            if (is_some(i)) return const_reference(std::in_place, m_values[i]);
+            return std::nullopt;
+        }
+
+        /**
+         * @brief 与operator[]相同，但i越界时panic
+         */
+        [[nodiscard]] constexpr reference at(size_t i) {
+            if (i >= size()) [[unlikely]] panic("option_vector::at: index out of range");
+            return (*this)[i];
+        }
+
+        [[nodiscard]] constexpr const_reference at(size_t i) const {
+            if (i >= size()) [[unlikely]] panic("option_vector::at: index out of range");
+            return (*this)[i];
+        }
+
+        constexpr void push_back(const Option<T>& value) {
+            if (value.is_some()) emplace_back(value.get_uncheck());
+            else push_none();
+        }
+
+        constexpr void push_back(Option<T>&& value) {
+            if (value.is_some()) emplace_back(std::move(value.get_uncheck()));
+            else push_none();
+        }
+
+        /**
+         * @brief 在末尾构造一个Some
+         */
+        template<typename ...Args>
+            requires std::constructible_from<T, Args...>
+        constexpr T& emplace_back(Args&&... args) {
+            // 先为位图分配空间，构造元素之后的步骤不会再抛出异常
+            m_valid.reserve_back();
+            T& ret = m_values.emplace_back(std::forward<Args>(args)...);
+            m_valid.push_back(true);
+            return ret;
+        }
+
+        constexpr void push_none() {
+            m_valid.reserve_back();
+            m_values.emplace_back();
+            m_valid.push_back(false);
+        }
+
+        constexpr void pop_back() {
+            m_values.pop_back();
+            m_valid.pop_back();
+        }
+
+        /**
+         * @brief 将第i个元素设为value
+         */
+        constexpr void set(size_t i, Option<T> value) {
+            if (value.is_some()) {
+                m_values[i] = std::move(value.get_uncheck());
+                m_valid.set(i, true);
+            } else {
+                reset(i);
+            }
+        }
+
+        /**
+         * @brief 将第i个元素设为None，并释放其中的值
+         */
+        constexpr void reset(size_t i) {
+            m_values[i] = T();
+            m_valid.set(i, false);
+        }
+
+        [[nodiscard]] constexpr size_t count_some() const noexcept { return m_valid.count(); }
+        [[nodiscard]] constexpr size_t count_none() const noexcept { return size() - count_some(); }
+
+        /**
+         * @brief 对每个Some中的值调用f（返回Option<U>），收集其中的Some
+         */
+        template<typename F>
+            requires is_option_v<std::remove_cvref_t<std::invoke_result_t<F, const T&>>>
+        [[nodiscard]] constexpr auto filter_map(F&& f) const {
+            using U = detail::filter_map_value_t<F, const T&>;
+            std::vector<U> ret;
+            m_valid.for_each_set([&](size_t i) {
+                auto o = std::invoke(f, m_values[i]);
+                if (o.is_some()) ret.push_back(std::move(o.get_uncheck()));
+            });
+            return ret;
+        }
+
+        /**
+         * @brief 将None替换为value，得到所有元素的值
+         */
+        [[nodiscard]] constexpr std::vector<T> unwrap_or(const T& value) const
+            requires std::copyable<T> {
+            std::vector<T> ret(size());
+            detail::select_or(m_valid, m_values.data(), value, ret.data());
+            return ret;
+        }
+
+        /**
+         * @brief 原地将所有None设为Some(value)
+         */
+        constexpr void fill_none(const T& value) requires std::copyable<T> {
+            detail::fill_unset(m_valid, m_values.data(), value);
+            m_valid.fill(true);
+        }
+
+        /**
+         * @brief 所有元素的值，None处为值初始化的T
+         */
+        [[nodiscard]] constexpr std::span<T> values() noexcept { return m_values; }
+        [[nodiscard]] constexpr std::span<const T> values() const noexcept { return m_values; }
+
+        /**
+         * @brief 有效性位图，第i个元素为Some时第i / 64个字的第i % 64位为1
+         */
+        [[nodiscard]] constexpr std::span<const std::uint64_t> validity() const noexcept { return m_valid.words(); }
+
+        constexpr void swap(option_vector& other) noexcept {
+            m_values.swap(other.m_values);
+            m_valid.swap(other.m_valid);
+        }
+
+    private:
+        std::vector<T> m_values;
+        detail::validity_bitmap m_valid;
+    };
+
+
+    /**
+     * @brief 以Ok值数组、Err值数组加位图存储元素的Result<T, E>容器
+     *
+     * 与Arrow中的sparse union相同，两个数组的长度都与容器相同，位图中为1的元素是Ok。
+     * 与option_vector相同，T与E都不能是bool。
+     *
+     * @example
+     * ```cpp
+     * C163q::result_vector<int, std::string> v;
+     * v.emplace_ok(1);
+     * v.emplace_err("bad");
+     * assert(v.count_ok() == 1 && v[1].unwrap_err().get() == "bad");
+     * ```
+     */
+    template<typename T, typename E>
+        requires (std::is_object_v<T> && std::default_initializable<T> && std::movable<T> && !std::is_same_v<T, bool> &&
+                  std::is_object_v<E> && std::default_initializable<E> && std::movable<E> && !std::is_same_v<E, bool>)
+    class result_vector {
+    public:
+        using value_type = Result<T, E>;
+        using reference = Result<std::reference_wrapper<T>, std::reference_wrapper<E>>;
+        using const_reference = Result<std::reference_wrapper<const T>, std::reference_wrapper<const E>>;
+        using size_type = size_t;
+
+        constexpr result_vector() noexcept = default;
+
+        constexpr result_vector(std::initializer_list<Result<T, E>> ilist) {
+            reserve(ilist.size());
+            for (const auto& r : ilist) push_back(r);
+        }
+
+        /**
+         * @brief 从元素可以转换为Result<T, E>的范围构造
+         */
+        template<std::ranges::input_range R>
+            requires (std::convertible_to<std::ranges::range_reference_t<R>, Result<T, E>> &&
+                     !std::same_as<std::remove_cvref_t<R>, result_vector>)
+        constexpr explicit result_vector(R&& range) {
+            if constexpr (std::ranges::sized_range<R>) reserve(size_t(std::ranges::size(range)));
+            for (auto&& r : range) push_back(Result<T, E>(std::forward<decltype(r)>(r)));
+        }
+
+        [[nodiscard]] constexpr size_t size() const noexcept { return m_values.size(); }
+        [[nodiscard]] constexpr bool empty() const noexcept { return m_values.empty(); }
+
+        constexpr void reserve(size_t count) {
+            m_values.reserve(count);
+            m_errors.reserve(count);
+            m_ok.reserve(count);
+        }
+
+        constexpr void clear() noexcept {
+            m_values.clear();
+            m_errors.clear();
+            m_ok.clear();
+        }
+
+        [[nodiscard]] constexpr bool is_ok(size_t i) const noexcept { return m_ok.test(i); }
+        [[nodiscard]] constexpr bool is_err(size_t i) const noexcept { return !m_ok.test(i); }
+
+        /**
+         * @brief 第i个元素的引用，与Result::as_ref()相同；不检查i是否越界
+         */
+        [[nodiscard]] constexpr reference operator[](size_t i) noexcept {
+            if (is_ok(i)) return reference(std::in_place_index<0>, std::ref(m_values[i]));
+            return reference(std::in_place_index<1>, std::ref(m_errors[i]));
+        }
+
+        [[nodiscard]] constexpr const_reference operator[](size_t i) const noexcept {
+            if (is_ok(i)) return const_reference(std::in_place_index<0>, std::cref(m_values[i]));
+            return const_reference(std::in_place_index<1>, std::cref(m_errors[i]));
+        }
+
+        /**
+         * @brief 与operator[]相同，但i越界时panic
+         */
+        [[nodiscard]] constexpr reference at(size_t i) {
+            if (i >= size()) [[unlikely]] panic("result_vector::at: index out of range");
+            return (*this)[i];
+        }
+
+        [[nodiscard]] constexpr const_reference at(size_t i) const {
+            if (i >= size()) [[unlikely]] panic("result_vector::at: index out of range");
+            return (*this)[i];
+        }
+
+        constexpr void push_back(const Result<T, E>& value) {
+            if (value.is_ok()) emplace_ok(value.template get<0>());
+            else emplace_err(value.template get<1>());
+        }
+
+        constexpr void push_back(Result<T, E>&& value) {
+            if (value.is_ok()) emplace_ok(std::move(value.template get<0>()));
+            else emplace_err(std::move(value.template get<1>()));
+        }
+
+        template<typename ...Args>
+            requires std::constructible_from<T, Args...>
+        constexpr T& emplace_ok(Args&&... args) {
+            // 任何一步抛出异常时撤销之前的步骤，保持三部分的长度一致
+            m_ok.reserve_back();
+            T& ret = m_values.emplace_back(std::forward<Args>(args)...);
+            try {
+                m_errors.emplace_back();
+            } catch (...) {
+                m_values.pop_back();
+                throw;
+            }
+            m_ok.push_back(true);
+            return ret;
+        }
+
+        template<typename ...Args>
+            requires std::constructible_from<E, Args...>
+        constexpr E& emplace_err(Args&&... args) {
+            m_ok.reserve_back();
+            E& ret = m_errors.emplace_back(std::forward<Args>(args)...);
+            try {
+                m_values.emplace_back();
+            } catch (...) {
+                m_errors.pop_back();
+                throw;
+            }
+            m_ok.push_back(false);
+            return ret;
+        }
+
+        constexpr void pop_back() {
+            m_values.pop_back();
+            m_errors.pop_back();
+            m_ok.pop_back();
+        }
+
+        /**
+         * @brief 将第i个元素设为value，另一侧的值被重置以释放资源
+         */
+        constexpr void set(size_t i, Result<T, E> value) {
+            if (value.is_ok()) {
+                m_values[i] = std::move(value.template get<0>());
+                m_errors[i] = E();
+            } else {
+                m_errors[i] = std::move(value.template get<1>());
+                m_values[i] = T();
+            }
+            m_ok.set(i, value.is_ok());
+        }
+
+        [[nodiscard]] constexpr size_t count_ok() const noexcept { return m_ok.count(); }
+        [[nodiscard]] constexpr size_t count_err() const noexcept { return size() - count_ok(); }
+
+        /**
+         * @brief 对每个Ok中的值调用f（返回Option<U>），收集其中的Some
+         */
+        template<typename F>
+            requires is_option_v<std::remove_cvref_t<std::invoke_result_t<F, const T&>>>
+        [[nodiscard]] constexpr auto filter_map(F&& f) const {
+            using U = detail::filter_map_value_t<F, const T&>;
+            std::vector<U> ret;
+            m_ok.for_each_set([&](size_t i) {
+                auto o = std::invoke(f, m_values[i]);
+                if (o.is_some()) ret.push_back(std::move(o.get_uncheck()));
+            });
+            return ret;
+        }
+
+        /**
+         * @brief 将Err替换为value，得到所有元素的值
+         */
+        [[nodiscard]] constexpr std::vector<T> unwrap_or(const T& value) const
+            requires std::copyable<T> {
+            std::vector<T> ret(size());
+            detail::select_or(m_ok, m_values.data(), value, ret.data());
+            return ret;
+        }
+
+        /**
+         * @brief 所有元素的Ok值，Err处为值初始化的T
+         */
+        [[nodiscard]] constexpr std::span<T> values() noexcept { return m_values; }
+        [[nodiscard]] constexpr std::span<const T> values() const noexcept { return m_values; }
+
+        /**
+         * @brief 所有元素的Err值，Ok处为值初始化的E
+         */
+        [[nodiscard]] constexpr std::span<E> errors() noexcept { return m_errors; }
+        [[nodiscard]] constexpr std::span<const E> errors() const noexcept { return m_errors; }
+
+        /**
+         * @brief 有效性位图，第i个元素为Ok时第i / 64个字的第i % 64位为1
+         */
+        [[nodiscard]] constexpr std::span<const std::uint64_t> validity() const noexcept { return m_ok.words(); }
+
+        constexpr void swap(result_vector& other) noexcept {
+            m_values.swap(other.m_values);
+            m_errors.swap(other.m_errors);
+            m_ok.swap(other.m_ok);
+        }
+
+    private:
+        std::vector<T> m_values;
+        std::vector<E> m_errors;
+        detail::validity_bitmap m_ok;
+    };
+}
+
+#endif // MY_CXX20
+#endif // !C163Q_MY_CPP_UTILS_RS_OPTION_VECTOR_HPP
@@ -15,30 +15,337 @@
     static_assert(false, "Require C++20!");
 #else
 
+#include<algorithm>
+#include<cstddef>
+#include<format>
+#include<iterator>
+#include<memory>
+#include<string>
 #include<string_view>
 #include<source_location>
+#include<type_traits>
 
 namespace C163q {
 
     /**
      * @brief 决定在panic中是否显示栈回溯，默认为false
-     *
-     * 仅在启用C++23标准时可用！
      */
     extern bool enable_traceback;
 
+    /**
+     * @brief 栈回溯的打印方式
+     */
+    enum class panic_traceback : unsigned char {
+        /// 只打印原始地址以及已加载模块的基址与build-id，可以离线使用addr2line等工具解析，
+        /// 耗时为微秒级，并且不会进行堆分配，仅在Linux等提供execinfo.h的平台上可用
+        raw,
+        /// 使用std::stacktrace当场解析符号，需要C++23，耗时为毫秒级且会进行堆分配
+        symbolized,
+    };
+
+    /**
+     * @brief enable_traceback为true时栈回溯的打印方式，默认为panic_traceback::symbolized
+     *
+     * 不支持symbolized（C++20）时退化为raw。
+     */
+    extern panic_traceback traceback_style;
+
+    /**
+     * @brief 预先加载获取原始栈回溯所需的运行时库。
+     *
+     * 第一次获取栈回溯时可能需要加载libgcc并分配内存，
+     * 如果需要在信号处理函数中panic并打印原始栈回溯，应当在程序启动时调用该函数。
+     */
+    void prepare_panic_traceback() noexcept;
+
+    /**
+     * @brief 传递给panic钩子的信息
+     *
+     * message指向panic线程的缓冲区，只在钩子执行期间有效。
+     */
+    struct panic_info {
+        std::string_view message;
+        std::source_location location;
+    };
+
+    /**
+     * @brief panic钩子，在panic时代替默认的输出被调用
+     */
+    using panic_hook = void(*)(const panic_info& info);
+
+    /**
+     * @brief 设置panic钩子，返回之前的钩子。传入nullptr时恢复默认的输出（打印到stderr）。
+     *
+     * 钩子保存在原子变量中，只会在panic时被读取。钩子返回后程序按照panic_strategy终止或展开，
+     * 钩子中抛出的异常会被忽略。
+     *
+     * @example
+     * ```cpp
+     * C163q::set_panic_hook([](const C163q::panic_info& info) {
+     *     log_error(info.location.file_name(), info.message);
+     * });
+     * ```
+     */
+    panic_hook set_panic_hook(panic_hook hook) noexcept;
+
+    /**
+     * @brief 取出当前的panic钩子并恢复默认输出
+     */
+    panic_hook take_panic_hook() noexcept;
+
+    /**
+     * @brief panic发生后的处理方式
+     */
+    enum class panic_strategy : unsigned char {
+        /// 输出信息后调用std::abort()终止程序（默认）
+        abort,
+        /// 输出信息后抛出panic_error，可以在任务的边界处捕获
+        unwind,
+    };
+
+    /**
+     * @brief 设置panic的处理方式，返回之前的处理方式。
+     *
+     * 编译src/rs/panic.cpp时定义MY_PANIC_UNWIND则默认为panic_strategy::unwind。
+     *
+     * 使用panic_strategy::unwind时，panic_error与其他异常一样不能穿过noexcept函数：
+     * 在noexcept函数（析构函数、noexcept的lambda、带有noexcept(...)的组合子等）中发生的panic展开到该函数时
+     * 会调用std::terminate()，而不会到达外层的catch。例如传给Option<T&>::map的noexcept的lambda中调用unwrap()，
+     * 此时map同样是noexcept的。
+     * 未检查的访问函数（get_uncheck()、unwrap_unchecked()等）只有在定义MY_UTILS_HARDENED时才检查前置条件并panic，
+     * 此时它们不是noexcept的；否则它们是noexcept的，也不会panic，前置条件不满足时行为未定义（见core/config.hpp）。
+     */
+    panic_strategy set_panic_strategy(panic_strategy strategy) noexcept;
+
+    [[nodiscard]] panic_strategy get_panic_strategy() noexcept;
+
+    /**
+     * @brief panic_strategy::unwind时panic抛出的异常
+     *
+     * 故意不继承std::exception，使得result_helper<std::exception>::invoke等捕获异常的代码不会把panic当作普通的错误。
+     *
+     * @example
+     * ```cpp
+     * C163q::set_panic_strategy(C163q::panic_strategy::unwind);
+     * try {
+     *     handle_request(req);
+     * } catch (const C163q::panic_error& e) {
+     *     respond_internal_error(req, e.what());
+     * }
+     * ```
+     */
+    class panic_error {
+    public:
+        panic_error(std::string_view message, const std::source_location& location)
+            : m_message(message), m_location(location) {}
+
+        [[nodiscard]] const char* what() const noexcept {
+            return m_message.c_str();
+        }
+
+        [[nodiscard]] const std::source_location& location() const noexcept {
+            return m_location;
+        }
+
+    private:
+        std::string m_message;
+        std::source_location m_location;
+    };
+
     /**
      * @brief 使程序因不可恢复错误而崩溃。
      *
-     * 该函数一般使用panic宏间接被调用
+     * 该函数一般使用panic宏间接被调用。使用panic_strategy::abort时，多个线程同时panic只有第一个会输出信息并终止程序，
+     * 其余线程会被阻塞；未设置钩子且未启用栈回溯或使用panic_traceback::raw时，该函数是异步信号安全的，
+     * 可以在信号处理函数中调用。使用panic_strategy::unwind时抛出panic_error。
      *
      * @param message  程序崩溃时打印的错误信息
      * @param location 程序调用该函数时的上下文信息
      *
      * @warning 可能需要使用-lstdc++_libbacktrace或-lstdc++exp来启用栈追踪
      */
-    [[noreturn]] void call_panic_(const std::string_view& message,
-            const std::source_location location = std::source_location::current()) noexcept;
+    MY_COLD [[noreturn]] void call_panic_(const std::string_view& message,
+            const std::source_location location = std::source_location::current());
+
+
+    /**
+     * @brief panic时使用的输出缓冲区
+     *
+     * 指向预先分配的缓冲区，写满后截断而不会进行堆分配，所有内容最终通过一次write(2)输出。
+     * 提供sink时写满后不会截断，而是将缓冲区中的内容交给sink后继续写入，
+     * format/print.hpp使用这种方式将格式化的结果分块输出，占用的内存与输出的长度无关。
+     */
+    class panic_writer {
+    public:
+        class iterator {
+        public:
+            using iterator_category = std::output_iterator_tag;
+            using value_type = void;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = void;
+
+            iterator() noexcept = default;
+            explicit iterator(panic_writer& writer) noexcept : m_writer(std::addressof(writer)) {}
+
+            iterator& operator=(char c) noexcept {
+                m_writer->put(c);
+                return *this;
+            }
+
+            iterator& operator*() noexcept { return *this; }
+            iterator& operator++() noexcept { return *this; }
+            iterator operator++(int) noexcept { return *this; }
+
+        private:
+            panic_writer* m_writer = nullptr;
+        };
+
+    public:
+        /**
+         * @brief 缓冲区写满或者调用flush()时接收其中的内容
+         */
+        using sink_fn = void(*)(void* context, std::string_view data) noexcept;
+
+        panic_writer(char* buffer, size_t capacity) noexcept : m_data(buffer), m_capacity(capacity) {}
+        panic_writer(char* buffer, size_t capacity, sink_fn sink, void* context) noexcept
+            : m_data(buffer), m_capacity(capacity), m_sink(sink), m_context(context) {}
+        panic_writer(const panic_writer&) = delete;
+        panic_writer& operator=(const panic_writer&) = delete;
+
+        void put(char c) noexcept {
+            if (m_size == m_capacity) [[unlikely]] {
+                if (!m_sink) {
+                    m_truncated = true;
+                    return;
+                }
+                flush();
+            }
+            m_data[m_size++] = c;
+        }
+
+        void write(std::string_view str) noexcept {
+            while (!str.empty()) {
+                if (m_size == m_capacity) [[unlikely]] {
+                    if (!m_sink) {
+                        m_truncated = true;
+                        return;
+                    }
+                    flush();
+                }
+                size_t n = std::min(str.size(), m_capacity - m_size);
+                std::char_traits<char>::copy(m_data + m_size, str.data(), n);
+                m_size += n;
+                str.remove_prefix(n);
+            }
+        }
+
+        /**
+         * @brief 将缓冲区中的内容交给sink并清空缓冲区，未提供sink时什么也不做
+         */
+        void flush() noexcept {
+            if (!m_sink) return;
+            if (m_size != 0) m_sink(m_context, view());
+            m_size = 0;
+        }
+
+        [[nodiscard]] iterator out() noexcept {
+            return iterator(*this);
+        }
+
+        [[nodiscard]] std::string_view view() const noexcept {
+            return std::string_view(m_data, m_size);
+        }
+
+        [[nodiscard]] bool truncated() const noexcept {
+            return m_truncated;
+        }
+
+    private:
+        char* m_data;
+        size_t m_size = 0;
+        size_t m_capacity;
+        sink_fn m_sink = nullptr;
+        void* m_context = nullptr;
+        bool m_truncated = false;
+    };
+
+    /**
+     * @brief 将data全部写入文件描述符fd，被信号中断时重试，panic的输出也使用该函数
+     *
+     * 没有write(2)的平台上只支持1（stdout）与2（stderr）。
+     *
+     * @return 成功时为0，否则为errno
+     */
+    int write_fd(int fd, std::string_view data) noexcept;
+
+    /**
+     * @brief 将value指向的对象格式化后写入writer，由call_panic_format_在panic时调用
+     */
+    using panic_format_fn = void(*)(panic_writer& writer, const void* value);
+
+    /**
+     * @brief 使程序因不可恢复错误而崩溃，崩溃时打印message、sep以及由format格式化后的value
+     *
+     * 格式化在该函数中（而不是调用处）进行，使Result::unwrap()等函数的调用处只需要一次比较以及一次冷调用，
+     * 格式化的结果写入每个线程预先分配的缓冲区，不会进行堆分配。
+     *
+     * @param message  程序崩溃时打印的错误信息
+     * @param sep      message与value之间的分隔符
+     * @param format   格式化value的函数，为nullptr时不打印value
+     * @param value    需要打印的值
+     * @param location 程序调用该函数时的上下文信息
+     */
+    MY_COLD [[noreturn]] void call_panic_format_(std::string_view message, std::string_view sep,
+            panic_format_fn format, const void* value,
+            const std::source_location location = std::source_location::current());
+
+    /**
+     * @brief 格式化std::string_view的panic_format_fn，用于打印"None"之类的固定文本
+     */
+    void panic_format_string_(panic_writer& writer, const void* value) noexcept;
+
+    /**
+     * @brief T是否可以使用std::format格式化
+     */
+    template<typename T>
+    concept panic_formattable =
+#ifdef MY_CXX23
+        std::formattable<T, char>;
+#else // C++23 ^^^ /  vvv C++20
+        requires (std::formatter<T>& f, const std::formatter<T>& cf, T&& t,
+            std::format_parse_context& p, std::format_context& fc) {
+            { f.parse(p) };
+            { cf.format(t, fc) };
+        };
+#endif
+
+    /**
+     * @brief 使用std::formatter<T>格式化T的panic_format_fn
+     */
+    template<panic_formattable T>
+    MY_COLD void panic_format_value_(panic_writer& writer, const void* value) {
+        std::format_to(writer.out(), "{}", *static_cast<const T*>(value));
+    }
+
+    /**
+     * @brief 与call_panic_format_相同，但按值接收value，用于较小的可平凡复制的类型
+     *
+     * 调用处不需要取value的地址，value可以一直保存在寄存器中，
+     * 使调用处的成功路径上不需要为了panic而分配栈空间。
+     */
+    template<panic_formattable T>
+    MY_COLD [[noreturn, gnu::noinline]] void call_panic_format_value_(std::string_view message, std::string_view sep,
+            T value, const std::source_location location = std::source_location::current()) {
+        call_panic_format_(message, sep, &panic_format_value_<T>, std::addressof(value), location);
+    }
+
+    /**
+     * @brief 是否应当使用call_panic_format_value_按值传递T
+     */
+    template<typename T>
+    inline constexpr bool panic_pass_by_value_v = panic_formattable<T> &&
+        std::is_trivially_copyable_v<T> && sizeof(T) <= 2 * sizeof(void*);
 }
 
 /**
@@ -50,5 +357,20 @@ namespace C163q {
  */
 #define panic(message) do { ::C163q::call_panic_(message); } while(0)
 
+/**
+ * @brief 检查未检查的访问函数的前置条件（见core/config.hpp中的MY_UTILS_HARDENED）
+ *
+ * @param cond     前置条件
+ * @param message  前置条件不满足时打印的错误信息
+ * @param location 调用访问函数处的源代码位置
+ */
+#ifdef MY_UTILS_HARDENED
+    #define MY_UNCHECKED_PRECONDITION(cond, message, location) \
+        do { if (!(cond)) [[unlikely]] ::C163q::call_panic_(message, location); } while(0)
+#else
+    #define MY_UNCHECKED_PRECONDITION(cond, message, location) \
+        do { (void) (location); MY_ASSUME(cond); } while(0)
+#endif
+
 #endif // MY_CXX20
 #endif // !C163Q_MY_CPP_UTILS_RS_PANIC_HPP
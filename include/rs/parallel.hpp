@@ -0,0 +1,402 @@
+/*!
+ * @file rs/parallel.hpp
+ * @brief 对范围并行地调用返回Result的函数，全部为Ok时收集结果，否则得到一个Err
+ *
+ * - try_transform(policy, range, f)：得到Result<std::vector<U>, E>，f返回Result<U, E>；
+ * - try_transform_reduce(policy, range, init, reduce, f)：得到Result<T, E>，将各个Ok值按顺序归约到init上。
+ *
+ * 范围被分为连续的块，在thread_pool（见rs/thread_pool.hpp）中运行，调用者自身也会处理块，因此在线程池的工作线程中
+ * 调用也不会死锁。观察到Err之后，所有块通过一个共享的原子变量得知，不再对之后的元素调用f。
+ * 选择哪一个Err由error_order决定：
+ * - error_order::first_index：下标最小的Err，与串行执行的结果相同。下标更大的元素不再被处理，
+ *   更小的元素依然需要处理以确认其中没有Err；
+ * - error_order::first_in_time：最先被观察到的Err，所有块立即停止。
+ *
+ * f（以及reduce）会在多个线程中同时被调用，必须是线程安全的；f抛出的异常在调用处重新抛出。
+ * 需要链接src/rs/thread_pool.cpp。
+ *
+ * 至少需要C++20
+ *
+ * @since Oct 14, 2026
+ *
+ * @example
+ * ```cpp
+ * std::vector<std::string> records = load();
+ * auto parse = [](const std::string& s) -> C163q::Result<int, std::string> { ... };
+ *
+ * C163q::Result<std::vector<int>, std::string> all = C163q::try_transform(C163q::execution::par, records, parse);
+ * C163q::Result<long, std::string> sum = C163q::try_transform_reduce(C163q::execution::par.on(pool), records,
+ *         0L, std::plus<>(), parse);
+ * ```
+ */
+
+#ifndef C163Q_MY_CPP_UTILS_RS_PARALLEL_HPP
+#define C163Q_MY_CPP_UTILS_RS_PARALLEL_HPP
+
+#include"../core/config.hpp"
+#ifndef MY_CXX20
+    static_assert(false, "Require C++20!");
+#else
+
+#include<algorithm>
+#include<atomic>
+#include<concepts>
+#include<coroutine>
+#include<cstddef>
+#include<exception>
+#include<functional>
+#include<iterator>
+#include<memory>
+#include<optional>
+#include<ranges>
+#include<type_traits>
+#include<utility>
+#include<vector>
+#include"coroutine.hpp"
+#include"result.hpp"
+#include"thread_pool.hpp"
+
+namespace C163q {
+
+    /**
+     * @brief 并行算法中出现多个Err时选择哪一个
+     */
+    enum class error_order : unsigned char {
+        /// 下标最小的Err，结果是确定的，与串行执行相同
+        first_index,
+        /// 最先被观察到的Err，可以更早地停止，但在多次运行之间可能不同
+        first_in_time,
+    };
+
+    /**
+     * @brief rs/parallel.hpp中算法的执行策略
+     *
+     * 不使用<execution>中的策略，因为libstdc++在存在TBB时要求所有包含<execution>的程序链接TBB。
+     */
+    namespace execution {
+
+        /**
+         * @brief 在调用线程中依次处理所有元素
+         */
+        struct sequenced_policy {};
+
+        /**
+         * @brief 分块在线程池中处理
+         */
+        struct parallel_policy {
+            /// 使用的线程池，为nullptr时使用default_thread_pool()
+            thread_pool* pool = nullptr;
+            /// 每个块的元素个数，为0时按线程数自动选择
+            size_t chunk_size = 0;
+
+            [[nodiscard]] constexpr parallel_policy on(thread_pool& p) const noexcept {
+                parallel_policy ret = *this;
+                ret.pool = &p;
+                return ret;
+            }
+
+            [[nodiscard]] constexpr parallel_policy chunked(size_t size) const noexcept {
+                parallel_policy ret = *this;
+                ret.chunk_size = size;
+                return ret;
+            }
+        };
+
+        inline constexpr sequenced_policy seq{};
+        inline constexpr parallel_policy par{};
+
+        template<typename P>
+        concept policy = std::same_as<std::remove_cvref_t<P>, sequenced_policy> ||
+            std::same_as<std::remove_cvref_t<P>, parallel_policy>;
+    }
+
+    namespace detail {
+
+        inline constexpr size_t no_error = size_t(-1);
+
+        // 记录出错的下标，并据此判断之后的元素是否还需要处理
+        class error_limit {
+        public:
+            explicit error_limit(error_order order) noexcept : m_order(order) {}
+
+            [[nodiscard]] bool stop_before(size_t index) const noexcept {
+                size_t limit = m_limit.load(std::memory_order_relaxed);
+                return m_order == error_order::first_index ? index > limit : limit != no_error;
+            }
+
+            // 报告index处的Err，返回该Err是否需要被保存。每个块只会报告它的第一个Err
+            [[nodiscard]] bool report(size_t index) noexcept {
+                size_t limit = m_limit.load(std::memory_order_relaxed);
+                if (m_order == error_order::first_index) {
+                    while (index < limit && !m_limit.compare_exchange_weak(limit, index, std::memory_order_relaxed)) {}
+                    return true;
+                }
+                return limit == no_error && m_limit.compare_exchange_strong(limit, index, std::memory_order_relaxed);
+            }
+
+            // 被选中的Err的下标，没有Err时为no_error
+            [[nodiscard]] size_t winner() const noexcept {
+                return m_limit.load(std::memory_order_relaxed);
+            }
+
+        private:
+            error_order m_order;
+            std::atomic<size_t> m_limit = no_error;
+        };
+
+        struct chunk_plan {
+            size_t size;
+            size_t chunk;
+            size_t count;
+
+            [[nodiscard]] constexpr size_t begin(size_t c) const noexcept { return c * chunk; }
+            [[nodiscard]] constexpr size_t end(size_t c) const noexcept { return std::min(size, (c + 1) * chunk); }
+        };
+
+        [[nodiscard]] constexpr chunk_plan plan_chunks(const execution::sequenced_policy&, size_t n) noexcept {
+            return { n, std::max<size_t>(n, 1), n != 0 };
+        }
+
+        [[nodiscard]] inline chunk_plan plan_chunks(const execution::parallel_policy& policy, size_t n) {
+            size_t chunk = policy.chunk_size;
+            if (chunk == 0) {
+                // 每个线程大约8个块，使各线程的负载可以通过窃取平衡
+                size_t threads = (policy.pool ? *policy.pool : default_thread_pool()).size();
+                chunk = std::max<size_t>(n / (threads * 8), 1);
+            }
+            return { n, chunk, (n + chunk - 1) / chunk };
+        }
+
+        // 调用者与线程池中的协程共享的状态，晚到的协程只会发现块已经被领取完毕
+        struct chunk_queue {
+            using run_fn = void(*)(void* body, size_t chunk);
+
+            chunk_queue(size_t count, run_fn run, void* body) noexcept
+                : count(count), remaining(count), run(run), body(body) {}
+
+            void finish(size_t n) noexcept {
+                if (remaining.fetch_sub(n, std::memory_order_acq_rel) == n) remaining.notify_all();
+            }
+
+            // 领取并处理块，直到没有剩余的块为止
+            void work() noexcept {
+                for (;;) {
+                    size_t c = next.fetch_add(1, std::memory_order_relaxed);
+                    if (c >= count) return;
+                    try {
+                        run(body, c);
+                    } catch (...) {
+                        if (!failed.exchange(true, std::memory_order_relaxed)) exception = std::current_exception();
+                        // 放弃所有尚未领取的块
+                        size_t unclaimed = next.exchange(count, std::memory_order_relaxed);
+                        if (unclaimed < count) finish(count - unclaimed);
+                    }
+                    finish(1);
+                }
+            }
+
+            void wait() const noexcept {
+                for (size_t n = remaining.load(std::memory_order_acquire); n != 0;
+                        n = remaining.load(std::memory_order_acquire)) {
+                    remaining.wait(n, std::memory_order_acquire);
+                }
+            }
+
+            size_t count;
+            std::atomic<size_t> next = 0;
+            std::atomic<size_t> remaining;
+            std::atomic<bool> failed = false;
+            std::exception_ptr exception;
+            run_fn run;
+            void* body;
+        };
+
+        // 在线程池中帮助处理块的协程，结束时自行销毁
+        class chunk_helper {
+        public:
+            class promise_type : public frame_allocation {
+            public:
+                [[nodiscard]] chunk_helper get_return_object() noexcept {
+                    return chunk_helper(std::coroutine_handle<promise_type>::from_promise(*this));
+                }
+
+                [[nodiscard]] std::suspend_always initial_suspend() const noexcept { return {}; }
+                [[nodiscard]] std::suspend_never final_suspend() const noexcept { return {}; }
+                void return_void() const noexcept {}
+
+                [[noreturn]] void unhandled_exception() const noexcept {
+                    std::terminate();
+                }
+            };
+
+            // 放入pool，之后由协程自己负责销毁；pool.post抛出异常时协程帧仍然由*this持有
+            void post_to(thread_pool& pool) {
+                pool.post(m_handle);
+                m_handle = nullptr;
+            }
+
+            chunk_helper(chunk_helper&& other) noexcept : m_handle(std::exchange(other.m_handle, nullptr)) {}
+
+            ~chunk_helper() {
+                if (m_handle) m_handle.destroy();
+            }
+
+        private:
+            explicit chunk_helper(std::coroutine_handle<promise_type> handle) noexcept : m_handle(handle) {}
+
+            std::coroutine_handle<promise_type> m_handle;
+        };
+
+        inline chunk_helper help_chunks(std::shared_ptr<chunk_queue> queue) {
+            queue->work();
+            co_return;
+        }
+
+        // 以body(c)处理plan中的每个块c，返回时所有块都已处理完毕
+        template<typename Body>
+        void run_chunks(const execution::sequenced_policy&, const chunk_plan& plan, Body& body) {
+            for (size_t c = 0; c < plan.count; ++c) body(c);
+        }
+
+        template<typename Body>
+        void run_chunks(const execution::parallel_policy& policy, const chunk_plan& plan, Body& body) {
+            if (plan.count <= 1) {
+                if (plan.count == 1) body(0);
+                return;
+            }
+            thread_pool& pool = policy.pool ? *policy.pool : default_thread_pool();
+            auto queue = std::make_shared<chunk_queue>(plan.count,
+                    [](void* b, size_t c) { (*static_cast<Body*>(b))(c); }, &body);
+            size_t helpers = std::min(pool.size(), plan.count - 1);
+            try {
+                for (size_t i = 0; i < helpers; ++i) help_chunks(queue).post_to(pool);
+            } catch (...) {
+                // 已经提交的协程仍然会调用body，等待所有块处理完毕之后才能离开
+                queue->work();
+                queue->wait();
+                throw;
+            }
+            queue->work();
+            queue->wait();
+            if (queue->exception) std::rethrow_exception(queue->exception);
+        }
+
+        template<typename Range, typename F>
+        using try_transform_result_t = std::remove_cvref_t<std::invoke_result_t<F&, std::ranges::range_reference_t<Range>>>;
+
+    }
+
+
+    /**
+     * @brief 对range中的每个元素调用f，全部为Ok时得到Ok值组成的std::vector，否则得到一个Err（见error_order）
+     *
+     * f返回Result<void, E>时得到Result<void, E>。
+     *
+     * @param policy execution::seq或execution::par（可以通过.on(pool)指定线程池，.chunked(n)指定块的大小）
+     * @param range  随机访问的有限范围
+     * @param f      以range的元素调用，返回Result<U, E>
+     * @param order  出现多个Err时选择哪一个
+     */
+    template<execution::policy Policy, std::ranges::random_access_range Range, typename F>
+        requires std::ranges::sized_range<Range> &&
+                 is_result_v<detail::try_transform_result_t<Range, F>>
+    [[nodiscard]] auto try_transform(const Policy& policy, Range&& range, F f,
+            error_order order = error_order::first_index) {
+        using R = detail::try_transform_result_t<Range, F>;
+        using U = typename R::value_type;
+        using E = typename R::error_type;
+        using Ret = std::conditional_t<std::is_void_v<U>, Result<void, E>, Result<std::vector<U>, E>>;
+
+        auto first = std::ranges::begin(range);
+        const detail::chunk_plan plan = detail::plan_chunks(policy, size_t(std::ranges::size(range)));
+        detail::error_limit limit(order);
+        std::vector<std::optional<E>> errors(plan.count);
+        std::vector<std::conditional_t<std::is_void_v<U>, char, std::vector<U>>> parts(std::is_void_v<U> ? 0 : plan.count);
+
+        auto body = [&](size_t c) {
+            size_t end = plan.end(c);
+            if constexpr (!std::is_void_v<U>) parts[c].reserve(end - plan.begin(c));
+            for (size_t i = plan.begin(c); i < end && !limit.stop_before(i); ++i) {
+                R result = std::invoke(f, first[std::ranges::range_difference_t<Range>(i)]);
+                if (result.is_err()) {
+                    if (limit.report(i)) errors[c].emplace(std::move(result.template get_uncheck<1>()));
+                    return;
+                }
+                if constexpr (!std::is_void_v<U>) parts[c].push_back(std::move(result.template get_uncheck<0>()));
+            }
+        };
+        detail::run_chunks(policy, plan, body);
+
+        if (size_t winner = limit.winner(); winner != detail::no_error) {
+            return Ret(std::in_place_index<1>, std::move(*errors[winner / plan.chunk]));
+        }
+        if constexpr (std::is_void_v<U>) {
+            return Ret(std::in_place_index<0>);
+        } else {
+            if (plan.count == 1) return Ret(std::in_place_index<0>, std::move(parts[0]));
+            std::vector<U> values;
+            values.reserve(plan.size);
+            for (auto& part : parts) std::ranges::move(part, std::back_inserter(values));
+            return Ret(std::in_place_index<0>, std::move(values));
+        }
+    }
+
+    /**
+     * @brief 对range中的每个元素调用f，全部为Ok时将Ok值按下标顺序归约到init上，否则得到一个Err（见error_order）
+     *
+     * 每个块先从其第一个Ok值（转换为T）开始归约，最后将各个块的结果按顺序归约到init上，
+     * 因此reduce需要满足结合律（不需要满足交换律），并且可以以(T, U)与(T, T)调用。
+     *
+     * @param policy execution::seq或execution::par
+     * @param range  随机访问的有限范围
+     * @param init   初始值
+     * @param reduce 以(T, U)或(T, T)调用，返回可以转换为T的值
+     * @param f      以range的元素调用，返回Result<U, E>
+     * @param order  出现多个Err时选择哪一个
+     */
+    template<execution::policy Policy, std::ranges::random_access_range Range, typename T, typename Reduce, typename F>
+        requires std::ranges::sized_range<Range> &&
+                 is_result_v<detail::try_transform_result_t<Range, F>> &&
+                 std::constructible_from<T, typename detail::try_transform_result_t<Range, F>::value_type> &&
+                 std::convertible_to<std::invoke_result_t<Reduce&, T, typename detail::try_transform_result_t<Range, F>::value_type>, T> &&
+                 std::convertible_to<std::invoke_result_t<Reduce&, T, T>, T>
+    [[nodiscard]] Result<T, typename detail::try_transform_result_t<Range, F>::error_type> try_transform_reduce(
+            const Policy& policy, Range&& range, T init, Reduce reduce, F f,
+            error_order order = error_order::first_index) {
+        using R = detail::try_transform_result_t<Range, F>;
+        using E = typename R::error_type;
+        using Ret = Result<T, E>;
+
+        auto first = std::ranges::begin(range);
+        const detail::chunk_plan plan = detail::plan_chunks(policy, size_t(std::ranges::size(range)));
+        detail::error_limit limit(order);
+        std::vector<std::optional<E>> errors(plan.count);
+        std::vector<std::optional<T>> partials(plan.count);
+
+        auto body = [&](size_t c) {
+            std::optional<T>& acc = partials[c];
+            for (size_t i = plan.begin(c), end = plan.end(c); i < end && !limit.stop_before(i); ++i) {
+                R result = std::invoke(f, first[std::ranges::range_difference_t<Range>(i)]);
+                if (result.is_err()) {
+                    if (limit.report(i)) errors[c].emplace(std::move(result.template get_uncheck<1>()));
+                    return;
+                }
+                if (acc) *acc = std::invoke(reduce, std::move(*acc), std::move(result.template get_uncheck<0>()));
+                else acc.emplace(std::move(result.template get_uncheck<0>()));
+            }
+        };
+        detail::run_chunks(policy, plan, body);
+
+        if (size_t winner = limit.winner(); winner != detail::no_error) {
+            return Ret(std::in_place_index<1>, std::move(*errors[winner / plan.chunk]));
+        }
+        for (auto& partial : partials) {
+            if (partial) init = std::invoke(reduce, std::move(init), std::move(*partial));
+        }
+        return Ret(std::in_place_index<0>, std::move(init));
+    }
+
+}
+
+#endif // MY_CXX20
+#endif // !C163Q_MY_CPP_UTILS_RS_PARALLEL_HPP
@@ -0,0 +1,160 @@
+/*!
+ * @file rs/ranges.hpp
+ * @brief Result、Option与std::ranges的结合
+ *
+ * Option本身即为包含0个或1个元素的范围（Option<T&>是视图），
+ * 因此Option的范围可以直接使用std::views::join取出所有Some中的值。
+ * 这里提供：
+ * - ok_view/err_view：只保留Result范围中Ok/Err的元素，并取出其中的值；
+ * - collect_result：将Result的范围收集为Result<std::vector<T>, E>，遇到第一个Err时立即返回。
+ *
+ * 至少需要C++20
+ *
+ * @since Oct 14, 2026
+ */
+
+#ifndef C163Q_MY_CPP_UTILS_RS_RANGES_HPP
+#define C163Q_MY_CPP_UTILS_RS_RANGES_HPP
+
+#include"../core/config.hpp"
+#ifndef MY_CXX20
+    static_assert(false, "Require C++20!");
+#else
+
+#include<cstddef>
+#include<ranges>
+#include<type_traits>
+#include<utility>
+#include<vector>
+#include"option.hpp"
+
+namespace C163q {
+
+    /**
+     * @brief 判断Result是否为Ok（Ok为true时）或Err（Ok为false时）
+     */
+    template<bool Ok>
+    struct result_is_fn {
+        template<typename R>
+        [[nodiscard]] constexpr bool operator()(const R& result) const noexcept {
+            return result.is_ok() == Ok;
+        }
+    };
+
+    /**
+     * @brief 取出Result中下标为I的值，左值返回引用，右值按值返回（移动）以免产生悬垂引用
+     */
+    template<size_t I>
+    struct result_get_fn {
+        template<typename R>
+        [[nodiscard]] constexpr decltype(auto) operator()(R&& result) const {
+            if constexpr (std::is_lvalue_reference_v<R>) {
+                return result.template get<I>();
+            } else {
+                using U = std::remove_cvref_t<decltype(result.template get<I>())>;
+                return U(std::move(result.template get<I>()));
+            }
+        }
+    };
+
+    template<typename Range>
+    concept result_range = std::ranges::input_range<Range> &&
+        is_result_v<std::remove_cvref_t<std::ranges::range_value_t<Range>>>;
+
+    /**
+     * @brief 只保留range中Ok的元素，并以其中的值作为元素的视图。
+     *
+     * range中的元素为左值时，视图的元素为其中值的引用。
+     *
+     * 视图由std::views::filter与std::views::transform组合而成，每个元素在过滤时与解引用时各被访问一次。
+     * range的元素为纯右值时（例如std::views::transform(parse)的结果），上游的元素因此会被求值两次，
+     * 开销较大或者有副作用时应当先将其保存到容器中。err_view同理。
+     *
+     * @example
+     * ```cpp
+     * std::vector<C163q::Result<int, int>> v { C163q::Ok<int>(1), C163q::Err<int>(2), C163q::Ok<int>(3) };
+     * for (int& x : C163q::ok_view(v)) x *= 10;
+     * assert(v[0].get<0>() == 10 && v[2].get<0>() == 30);
+     * ```
+     */
+    template<std::ranges::viewable_range Range>
+        requires result_range<Range> &&
+                 (!std::is_void_v<typename std::remove_cvref_t<std::ranges::range_value_t<Range>>::value_type>)
+    [[nodiscard]] constexpr auto ok_view(Range&& range) {
+        return std::views::transform(
+                std::views::filter(std::forward<Range>(range), result_is_fn<true>{}),
+                result_get_fn<0>{});
+    }
+
+    /**
+     * @brief 只保留range中Err的元素，并以其中的错误作为元素的视图。
+     *
+     * @example
+     * ```cpp
+     * std::vector<C163q::Result<int, int>> v { C163q::Ok<int>(1), C163q::Err<int>(2) };
+     * assert(std::ranges::distance(C163q::err_view(v)) == 1);
+     * assert(*C163q::err_view(v).begin() == 2);
+     * ```
+     */
+    template<std::ranges::viewable_range Range>
+        requires result_range<Range>
+    [[nodiscard]] constexpr auto err_view(Range&& range) {
+        return std::views::transform(
+                std::views::filter(std::forward<Range>(range), result_is_fn<false>{}),
+                result_get_fn<1>{});
+    }
+
+    /**
+     * @brief 将Result的范围收集为Result<std::vector<T>, E>，与rust中的
+     *        `iter.collect::<Result<Vec<T>, E>>()`相同。
+     *
+     * 遇到第一个Err时立即返回该错误，不再访问之后的元素。
+     * range是sized_range时只会分配一次内存。
+     * range的元素是右值（例如std::views::transform产生的临时的Result），
+     * 或者range本身是一个右值的容器时，其中的值会被移动，否则会被复制。
+     *
+     * Result<void, E>的范围会被收集为Result<void, E>。
+     *
+     * @example
+     * ```cpp
+     * std::vector<std::string> input { "1", "2", "x" };
+     * auto parse = [](const std::string& s) -> C163q::Result<int, std::string> { ... };
+     * auto r = C163q::collect_result(input | std::views::transform(parse));
+     * assert(r.is_err() && r.get<1>() == "x");
+     * ```
+     */
+    template<std::ranges::input_range Range>
+        requires result_range<Range>
+    [[nodiscard]] constexpr auto collect_result(Range&& range) {
+        using R = std::remove_cvref_t<std::ranges::range_value_t<Range>>;
+        using T = typename R::value_type;
+        using E = typename R::error_type;
+        // 元素本身不是左值，或者range是一个即将被销毁的容器时移动其中的值
+        constexpr bool move_elements = !std::is_lvalue_reference_v<std::ranges::range_reference_t<Range>> ||
+            (!std::is_lvalue_reference_v<Range> && !std::ranges::view<std::remove_cvref_t<Range>>);
+        auto take = [](auto& value) -> decltype(auto) {
+            if constexpr (move_elements) return std::move(value);
+            else return value;
+        };
+
+        if constexpr (std::is_void_v<T>) {
+            for (auto&& result : range) {
+                if (result.is_err()) return R(std::in_place_index<1>, take(result.template get<1>()));
+            }
+            return R(std::in_place_index<0>);
+        } else {
+            using Ret = Result<std::vector<T>, E>;
+            std::vector<T> values;
+            if constexpr (std::ranges::sized_range<Range>) values.reserve(size_t(std::ranges::size(range)));
+            for (auto&& result : range) {
+                if (result.is_err()) return Ret(std::in_place_index<1>, take(result.template get<1>()));
+                values.push_back(take(result.template get<0>()));
+            }
+            return Ret(std::in_place_index<0>, std::move(values));
+        }
+    }
+
+}
+
+#endif // MY_CXX20
+#endif // !C163Q_MY_CPP_UTILS_RS_RANGES_HPP
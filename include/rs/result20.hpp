@@ -2,7 +2,7 @@
  * @file rs/result20.hpp
  * @brief 在C++中实现rust当中的Result类
  *
- * 至少需要C++20
+ * 至少需要C++20。C++23下默认使用std::expected作为存储（见rs/result_storage.hpp）
  *
  * @since Jul 17, 2025
  */
@@ -22,17 +22,139 @@
 #include<compare>
 #include<concepts>
 #include<cstddef>
+#include<exception>
 #include<format>
 #include<functional>
+#include<memory>
 #include<optional>
+#include<source_location>
 #include<string_view>
+#include<tuple>
 #include<type_traits>
 #include<utility>
 #include<variant>
+#include"instrument.hpp"
 #include"panic.hpp"
+#include"result_storage.hpp"
 
 namespace C163q {
 
+    /**
+     * @brief 延迟调用可调用对象的代理，在被转换为R时才进行调用。
+     *
+     * 将代理作为参数传入原地构造（如std::in_place_index）时，R由转换函数返回的纯右值初始化，
+     * 编译器可以把可调用对象的返回值直接构造在最终的存储中，省去物化临时对象之后的那一次移动。
+     * 注意这并不属于保证的复制消除：通过转换函数初始化对象时是否省略临时对象尚未由标准确定（CWG2327），
+     * 只是GCC与Clang实际上会省略；其他编译器上最坏的情况与直接传入返回值相同，每一步仍然移动一次。
+     * 对于std::array<char, 4096>这样的只能复制的类型，或者移动开销较大的类型，
+     * 这可能使map/map_err的链式调用的每一步都少一次移动或复制。
+     *
+     * 仅保存引用，只能在同一个完整表达式中使用。
+     */
+    template<typename R, typename F, typename ...Args>
+    class invoke_result_proxy {
+    public:
+        constexpr explicit invoke_result_proxy(F&& func, Args&&... args) noexcept
+            : m_func(std::forward<F>(func)), m_args(std::forward<Args>(args)...) {}
+
+        constexpr operator R() && noexcept(std::is_nothrow_invocable_v<F, Args...>) {
+            return std::apply([this](Args&&... args) -> R {
+                return std::invoke(std::forward<F>(m_func), std::forward<Args>(args)...);
+            }, std::move(m_args));
+        }
+
+    private:
+        F&& m_func;
+        std::tuple<Args&&...> m_args;
+    };
+
+    // 可以由任意类型构造的类型（例如std::any）会直接接收代理本身，不能使用invoke_result_proxy
+    struct invoke_result_probe {};
+
+    template<typename R, typename F, typename ...Args>
+    inline constexpr bool can_elide_invoke_result_v =
+        std::is_same_v<std::invoke_result_t<F, Args...>, R> && std::is_class_v<R> &&
+        !std::is_constructible_v<R, invoke_result_probe>;
+
+    /**
+     * @brief 调用func，得到用于原地构造R的参数。
+     *
+     * 若func的返回值类型恰好是R，返回invoke_result_proxy，使R直接由func的返回值构造；
+     * 否则直接返回调用的结果，由原地构造负责转换。
+     */
+    template<typename R, typename F, typename ...Args>
+    [[nodiscard]] constexpr decltype(auto) invoke_for_construct(F&& func, Args&&... args)
+        noexcept(can_elide_invoke_result_v<R, F, Args...> || std::is_nothrow_invocable_v<F, Args...>) {
+        if constexpr (can_elide_invoke_result_v<R, F, Args...>) {
+            return invoke_result_proxy<R, F, Args...>(std::forward<F>(func), std::forward<Args>(args)...);
+        } else {
+            return std::invoke(std::forward<F>(func), std::forward<Args>(args)...);
+        }
+    }
+
+    /**
+     * @brief X能否使用alloc以uses-allocator方式（见std::uses_allocator）由Args构造
+     *
+     * X不使用Alloc时alloc被忽略，此时与X能否由Args构造相同。
+     */
+    template<typename X, typename Alloc, typename ...Args>
+    concept constructible_using_allocator = (std::uses_allocator_v<std::remove_cv_t<X>, Alloc> ?
+        (std::is_constructible_v<X, std::allocator_arg_t, const Alloc&, Args...> ||
+         std::is_constructible_v<X, Args..., const Alloc&>) :
+        std::is_constructible_v<X, Args...>);
+
+    /**
+     * @brief 能否使用alloc以uses-allocator方式由func的返回值构造R（见invoke_using_allocator）
+     */
+    template<typename R, typename Alloc, typename F, typename ...Args>
+    concept invocable_using_allocator =
+        (std::is_invocable_v<F, Args..., const Alloc&> &&
+            (std::is_same_v<std::invoke_result_t<F, Args..., const Alloc&>, R> ||
+             constructible_using_allocator<R, Alloc, std::invoke_result_t<F, Args..., const Alloc&>>)) ||
+        (!std::is_invocable_v<F, Args..., const Alloc&> && std::is_invocable_v<F, Args...> &&
+             constructible_using_allocator<R, Alloc, std::invoke_result_t<F, Args...>>);
+
+    template<typename R>
+    struct make_using_allocator_fn {
+        template<typename Alloc, typename ...Args>
+        constexpr R operator()(const Alloc& alloc, Args&&... args) const {
+            return std::make_obj_using_allocator<R>(alloc, std::forward<Args>(args)...);
+        }
+    };
+
+    template<typename R>
+    struct invoke_using_allocator_fn {
+        template<typename Alloc, typename F, typename ...Args>
+        constexpr R operator()(const Alloc& alloc, F&& func, Args&&... args) const {
+            if constexpr (!std::is_invocable_v<F, Args..., const Alloc&>) {
+                return std::make_obj_using_allocator<R>(alloc,
+                        std::invoke(std::forward<F>(func), std::forward<Args>(args)...));
+            } else if constexpr (std::is_same_v<std::invoke_result_t<F, Args..., const Alloc&>, R>) {
+                return std::invoke(std::forward<F>(func), std::forward<Args>(args)..., alloc);
+            } else {
+                return std::make_obj_using_allocator<R>(alloc,
+                        std::invoke(std::forward<F>(func), std::forward<Args>(args)..., alloc));
+            }
+        }
+    };
+
+    /**
+     * @brief 使用alloc以uses-allocator方式构造R，与std::make_obj_using_allocator<R>相同
+     *
+     * 与invoke_for_construct一起使用，使R由std::make_obj_using_allocator的返回值尽可能直接构造在最终的存储中（见invoke_result_proxy）。
+     */
+    template<typename R>
+    inline constexpr make_using_allocator_fn<R> make_using_allocator{};
+
+    /**
+     * @brief 调用func并使用alloc构造R
+     *
+     * 若func可以在参数末尾额外接收alloc，则调用func(args..., alloc)，返回值恰好是R时直接返回（由func负责使用alloc），
+     * 否则调用func(args...)，再使用alloc以uses-allocator方式由返回值构造R。
+     */
+    template<typename R>
+    inline constexpr invoke_using_allocator_fn<R> invoke_using_allocator{};
+
 
     /**
      * @brief Rust当中的Result枚举类型，表示有可能成功（返回值）或者失败（返回异常）的类型。
@@ -94,8 +216,10 @@ namespace C163q {
          * @brief 默认构造函数
          *
          * 要求类型T必须是可以默认构造的，即requires: is_default_constructible_v<T>。
+         * 使用紧凑存储并且T()不表示Ok状态时（见result_sentinel_niche）不能默认构造。
          */
-        constexpr Result() noexcept(std::is_nothrow_constructible_v<T>) : m_data() {}
+        constexpr Result() noexcept(std::is_nothrow_constructible_v<T>)
+            requires std::is_default_constructible_v<result_storage_t<T, E>> : m_data() {}
 
         /**
          * @brief 使用T构造Ok所保有的类型T
@@ -109,7 +233,7 @@ namespace C163q {
         template<typename U>
             requires std::constructible_from<T, U>
         constexpr explicit Result(U&& value) noexcept(std::is_nothrow_constructible_v<T, U>)
-            : m_data(std::forward<U>(value)) {}
+            : m_data(std::in_place_index<0>, std::forward<U>(value)) {}
 
         /**
          * @brief 使用E构造Err所保有的类型
@@ -123,7 +247,7 @@ namespace C163q {
         template<typename F>
             requires std::constructible_from<E, F>
         constexpr explicit Result(F&& err) noexcept(std::is_nothrow_constructible_v<E, F>)
-            : m_data(std::forward<F>(err)) {}
+            : m_data(std::in_place_index<1>, std::forward<F>(err)) {}
 
         /**
          * @brief 使用args构造Result类型
@@ -138,15 +262,68 @@ namespace C163q {
             requires ((std::is_same_v<T, U> || std::is_same_v<E, U>) &&
                       std::is_constructible_v<U, Args...> && !std::is_same_v<T, E>)
         constexpr explicit Result(std::in_place_type_t<U>, Args&&... args)
-            : m_data(std::in_place_type<U>, std::forward<Args>(args)...) {}
+            : m_data(std::in_place_index<std::is_same_v<T, U> ? 0 : 1>, std::forward<Args>(args)...) {}
 
 
         template<size_t I, typename ...Args>
             requires ((I == 0 || I == 1) &&
                     std::is_constructible_v<std::conditional_t<I == 0, T, E>, Args...>)
         constexpr explicit Result(std::in_place_index_t<I>, Args&&... args)
+            noexcept(std::is_nothrow_constructible_v<result_storage_t<T, E>, std::in_place_index_t<I>, Args...>)
             : m_data(std::in_place_index<I>, std::forward<Args>(args)...) {}
 
+        /**
+         * @brief 使用alloc以uses-allocator方式构造Result
+         *
+         * T或E使用Alloc（例如std::pmr::string使用std::pmr::polymorphic_allocator<>）时，alloc会被传递给其构造函数，
+         * 否则alloc被忽略，与对应的不带alloc的构造函数相同。T或E使用Alloc时std::uses_allocator<Result<T, E>, Alloc>为真，
+         * 因此std::pmr::vector<Result<T, E>>的元素会使用容器的分配器构造。
+         *
+         * @example
+         * ```cpp
+         * std::pmr::monotonic_buffer_resource arena;
+         * std::pmr::polymorphic_allocator<> alloc(&arena);
+         * C163q::Result<std::pmr::string, int> x(std::allocator_arg, alloc, std::in_place_index<0>, 32, 'x');
+         * assert(x.get<0>().get_allocator() == alloc);
+         * ```
+         */
+        template<typename Alloc>
+            requires constructible_using_allocator<T, Alloc> && std::is_default_constructible_v<result_storage_t<T, E>>
+        constexpr Result(std::allocator_arg_t, const Alloc& alloc)
+            : m_data(std::in_place_index<0>, invoke_for_construct<T>(make_using_allocator<T>, alloc)) {}
+
+        template<typename Alloc, size_t I, typename ...Args>
+            requires ((I == 0 || I == 1) &&
+                    constructible_using_allocator<std::conditional_t<I == 0, T, E>, Alloc, Args...>)
+        constexpr explicit Result(std::allocator_arg_t, const Alloc& alloc, std::in_place_index_t<I>, Args&&... args)
+            : m_data(std::in_place_index<I>, invoke_for_construct<std::conditional_t<I == 0, T, E>>(
+                        make_using_allocator<std::conditional_t<I == 0, T, E>>, alloc, std::forward<Args>(args)...)) {}
+
+        template<typename Alloc, typename U>
+            requires (constructible_using_allocator<T, Alloc, U> && std::constructible_from<T, U> &&
+                    !std::is_same_v<std::remove_cvref_t<U>, Result>)
+        constexpr explicit Result(std::allocator_arg_t, const Alloc& alloc, U&& value)
+            : Result(std::allocator_arg, alloc, std::in_place_index<0>, std::forward<U>(value)) {}
+
+        template<typename Alloc, typename F>
+            requires (constructible_using_allocator<E, Alloc, F> && std::constructible_from<E, F> &&
+                    !std::is_same_v<std::remove_cvref_t<F>, Result>)
+        constexpr explicit Result(std::allocator_arg_t, const Alloc& alloc, F&& err)
+            : Result(std::allocator_arg, alloc, std::in_place_index<1>, std::forward<F>(err)) {}
+
+        template<typename Alloc>
+            requires (constructible_using_allocator<T, Alloc, const T&> &&
+                      constructible_using_allocator<E, Alloc, const E&>)
+        constexpr Result(std::allocator_arg_t, const Alloc& alloc, const Result& other)
+            : m_data(storage_using_allocator(alloc, other)) {}
+
+        template<typename Alloc>
+            requires (constructible_using_allocator<T, Alloc, T&&> &&
+                      constructible_using_allocator<E, Alloc, E&&>)
+        constexpr Result(std::allocator_arg_t, const Alloc& alloc, Result&& other)
+            : m_data(storage_using_allocator(alloc, std::move(other))) {}
+
+        // 复制、移动均为默认，使得T与E是平凡的时候Result<T, E>也是平凡的
         constexpr Result(const Result&) = default;
         constexpr Result(Result&&) noexcept(std::is_nothrow_move_constructible_v<T> &&
                 std::is_nothrow_move_constructible_v<E>) = default;
@@ -199,7 +376,7 @@ namespace C163q {
             requires std::predicate<F, const T&>
         [[nodiscard]] constexpr bool is_ok_and(F&& f)
             const noexcept(std::is_nothrow_invocable_v<F, const T&>) {
-            return !m_data.index() && std::invoke(std::forward<F>(f), const_cast<const T&>(std::get<0>(m_data)));
+            return !m_data.index() && std::invoke(std::forward<F>(f), m_data.template get<0>());
         }
 
         /**
@@ -248,7 +425,7 @@ namespace C163q {
             requires std::predicate<F, const E&>
         [[nodiscard]] constexpr bool is_err_and(F&& f)
             const noexcept(std::is_nothrow_invocable_v<F, const E&>) {
-            return !!m_data.index() && std::invoke(std::forward<F>(f), const_cast<const E&>(std::get<1>(m_data)));
+            return !!m_data.index() && std::invoke(std::forward<F>(f), m_data.template get<1>());
         }
 
         /**
@@ -264,45 +441,75 @@ namespace C163q {
         template<typename U>
             requires ((std::is_same_v<U, T> || std::is_same_v<U, E>) && !std::is_same_v<T, E>)
         [[nodiscard]] constexpr U& get() {
-            try {
-                return std::get<U>(m_data);
-            } catch(...) {
-                panic("Invaild access to Result");
-            }
+            return get<std::is_same_v<U, T> ? 0 : 1>();
         }
 
         template<typename U>
             requires ((std::is_same_v<U, T> || std::is_same_v<U, E>) && !std::is_same_v<T, E>)
         [[nodiscard]] constexpr const U& get() const {
-            try {
-                return std::get<U>(m_data);
-            } catch(...) {
-                panic("Invaild access to Result");
-            }
+            return get<std::is_same_v<U, T> ? 0 : 1>();
         }
 
         template<size_t I>
             requires (I == 0 || I == 1)
         [[nodiscard]] constexpr std::variant_alternative_t<I, std::variant<T, E>>& get() {
-            try {
-                return std::get<I>(m_data);
-            } catch(...) {
-                panic("Invaild access to Result");
-            }
+            if (m_data.index() != I) panic("Invaild access to Result");
+            return m_data.template get<I>();
         }
 
         template<size_t I>
             requires (I == 0 || I == 1)
         [[nodiscard]] constexpr const std::variant_alternative_t<I, std::variant<T, E>>& get() const {
-            try {
-                return std::get<I>(m_data);
-            } catch(...) {
-                panic("Invaild access to Result");
-            }
+            if (m_data.index() != I) panic("Invaild access to Result");
+            return m_data.template get<I>();
         }
 
-        [[nodiscard]] constexpr const std::variant<T, E>& data() const noexcept {
-            return m_data;
+        /**
+         * @brief 不进行检查地访问Result内所保有元素，调用者需要保证Result处于对应的状态，否则行为未定义。
+         *
+         * 默认情况下该前置条件会被告知编译器，可以省去多余的状态检查；
+         * 定义MY_UTILS_HARDENED时会进行检查，并在状态不符时panic，打印调用处的源代码位置（见core/config.hpp）。
+         *
+         * @tparam I 要访问的元素的索引。若为0，访问Ok时所保有的值；若为1，访问Err时所保有的值
+         */
+        template<size_t I>
+            requires (I == 0 || I == 1)
+        [[nodiscard]] constexpr std::variant_alternative_t<I, std::variant<T, E>>& get_uncheck(
+                const std::source_location location = std::source_location::current()) MY_UNCHECKED_NOEXCEPT {
+            MY_UNCHECKED_PRECONDITION(m_data.index() == I, "Invaild access to Result", location);
+            return m_data.template get<I>();
+        }
+
+        template<size_t I>
+            requires (I == 0 || I == 1)
+        [[nodiscard]] constexpr const std::variant_alternative_t<I, std::variant<T, E>>& get_uncheck(
+                const std::source_location location = std::source_location::current()) const MY_UNCHECKED_NOEXCEPT {
+            MY_UNCHECKED_PRECONDITION(m_data.index() == I, "Invaild access to Result", location);
+            return m_data.template get<I>();
+        }
+
+        /**
+         * @brief 以std::variant<T, E>的常引用访问Result内保有的数据
+         *
+         * 使用std::variant存储（C++20，或者C++23下定义了MY_RESULT_VARIANT_STORAGE）时返回常引用；
+         * 其他存储中并不存在std::variant，此时返回复制得到的std::variant，已被弃用，应当改用to_variant()。
+         */
+        [[nodiscard]] constexpr const std::variant<T, E>& data() const noexcept
+            requires std::is_same_v<result_storage_t<T, E>, result_variant_storage<T, E>> {
+            return m_data.variant();
+        }
+
+        [[nodiscard, deprecated("Result does not store a std::variant here, use to_variant()")]]
+        constexpr std::variant<T, E> data() const
+            requires (!std::is_same_v<result_storage_t<T, E>, result_variant_storage<T, E>>) {
+            return m_data.to_variant();
+        }
+
+        /**
+         * @brief 复制保有的值，得到std::variant<T, E>，可用于任何存储
+         */
+        [[nodiscard]] constexpr std::variant<T, E> to_variant() const {
+            return m_data.to_variant();
         }
 
         /**
@@ -326,7 +533,7 @@ namespace C163q {
          */
         [[nodiscard]] constexpr std::optional<T> ok() noexcept(std::is_nothrow_move_constructible_v<T>) {
             if (is_err()) return std::nullopt;
-            return std::optional<T>(std::in_place, std::move(get<0>()));
+            return std::optional<T>(std::in_place, std::move(m_data.template get<0>()));
         }
 
         /**
@@ -348,7 +555,7 @@ namespace C163q {
          */
         [[nodiscard]] constexpr std::optional<E> err() noexcept(std::is_nothrow_move_constructible_v<E>) {
             if (is_ok()) return std::nullopt;
-            return std::optional<E>(std::in_place, std::move(get<1>()));
+            return std::optional<E>(std::in_place, std::move(m_data.template get<1>()));
         }
 
         /**
@@ -391,8 +598,8 @@ namespace C163q {
         [[nodiscard]] constexpr Result<U, E> map(F&& func) const
             noexcept(std::is_nothrow_constructible_v<U, std::invoke_result_t<F, const T&>> &&
                      std::is_nothrow_copy_constructible_v<E> && std::is_nothrow_invocable_v<F, const T&>) {
-            if (is_err()) return Result<U, E>(std::in_place_index<1>, get<1>());
-            return Result<U, E>(std::in_place_index<0>, std::invoke(std::forward<F>(func), get<0>()));
+            if (is_err()) return Result<U, E>(std::in_place_index<1>, m_data.template get<1>());
+            return Result<U, E>(std::in_place_index<0>, invoke_for_construct<U>(std::forward<F>(func), m_data.template get<0>()));
         }
 
         /**
@@ -425,7 +632,7 @@ namespace C163q {
             noexcept(std::is_nothrow_constructible_v<U, std::invoke_result_t<F, const T&>> &&
                      std::is_nothrow_move_constructible_v<U> && std::is_nothrow_invocable_v<F, const T&>) {
             if (is_err()) return default_value;
-            return std::invoke(std::forward<F>(func), get<0>());
+            return std::invoke(std::forward<F>(func), m_data.template get<0>());
         }
 
         /**
@@ -466,8 +673,8 @@ namespace C163q {
                      std::is_nothrow_constructible_v<U, std::invoke_result_t<F, const T&>> &&
                      std::is_nothrow_move_constructible_v<U> && std::is_nothrow_invocable_v<D, const E&> &&
                      std::is_nothrow_invocable_v<F, const T&>) {
-            if (is_err()) return std::invoke(std::forward<D>(fallback), get<1>());
-            return std::invoke(std::forward<F>(func), get<0>());
+            if (is_err()) return std::invoke(std::forward<D>(fallback), m_data.template get<1>());
+            return std::invoke(std::forward<F>(func), m_data.template get<0>());
         }
 
         /**
@@ -502,8 +709,8 @@ namespace C163q {
         [[nodiscard]] constexpr Result<T, F> map_err(O&& op) const
             noexcept(std::is_nothrow_constructible_v<F, std::invoke_result_t<O, const E&>> &&
                      std::is_nothrow_copy_constructible_v<T> && std::is_nothrow_invocable_v<O, const E&>) {
-            if (is_ok()) return Result<T, F>(std::in_place_index<0>, get<0>());
-            return Result<T, F>(std::in_place_index<1>, std::invoke(std::forward<O>(op), get<1>()));
+            if (is_ok()) return Result<T, F>(std::in_place_index<0>, m_data.template get<0>());
+            return Result<T, F>(std::in_place_index<1>, invoke_for_construct<F>(std::forward<O>(op), m_data.template get<1>()));
         }
 
         /**
@@ -541,9 +748,9 @@ namespace C163q {
             noexcept(std::is_nothrow_constructible_v<U, std::invoke_result_t<F, T>> &&
                      std::is_nothrow_move_constructible_v<E> && std::is_nothrow_move_constructible_v<T> &&
                      std::is_nothrow_invocable_v<F, T>) {
-            if (is_err()) return Result<U, E>(std::in_place_index<1>, std::move(get<1>()));
-            return Result<U, E>(std::in_place_index<0>, std::invoke(
-                            std::forward<F>(func), std::move(get<0>())));
+            if (is_err()) return Result<U, E>(std::in_place_index<1>, std::move(m_data.template get<1>()));
+            return Result<U, E>(std::in_place_index<0>, invoke_for_construct<U>(
+                            std::forward<F>(func), std::move(m_data.template get<0>())));
         }
 
         /**
@@ -586,7 +793,7 @@ namespace C163q {
                      std::is_nothrow_move_constructible_v<U> && std::is_nothrow_move_constructible_v<T> &&
                      std::is_nothrow_invocable_v<F, T>) {
             if (is_err()) return default_value;
-            return std::invoke(std::forward<F>(func), std::move(get<0>()));
+            return std::invoke(std::forward<F>(func), std::move(m_data.template get<0>()));
         }
 
         /**
@@ -630,8 +837,8 @@ namespace C163q {
                       std::is_nothrow_move_constructible_v<U> && std::is_nothrow_move_constructible_v<T> &&
                       std::is_nothrow_move_constructible_v<E> && std::is_nothrow_invocable_v<D, E> &&
                       std::is_nothrow_invocable_v<F, T>) {
-            if (is_err()) return std::invoke(std::forward<D>(fallback), std::move(get<1>()));
-            return std::invoke(std::forward<F>(func), std::move(get<0>()));
+            if (is_err()) return std::invoke(std::forward<D>(fallback), std::move(m_data.template get<1>()));
+            return std::invoke(std::forward<F>(func), std::move(m_data.template get<0>()));
         }
 
         /**
@@ -669,9 +876,9 @@ namespace C163q {
             noexcept(std::is_nothrow_constructible_v<F, std::invoke_result_t<O, E>> &&
                      std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_constructible_v<E> &&
                      std::is_nothrow_invocable_v<O, E>) {
-            if (is_ok()) return Result<T, F>(std::in_place_index<0>, std::move(get<0>()));
-            return Result<T, F>(std::in_place_index<1>, std::invoke(
-                            std::forward<O>(op), std::move(get<1>())));
+            if (is_ok()) return Result<T, F>(std::in_place_index<0>, std::move(m_data.template get<0>()));
+            return Result<T, F>(std::in_place_index<1>, invoke_for_construct<F>(
+                            std::forward<O>(op), std::move(m_data.template get<1>())));
         }
 
         /**
@@ -693,12 +900,12 @@ namespace C163q {
          * ```
          */
         [[nodiscard]] constexpr T expect(const std::string_view& msg) {
-            if (is_ok()) return std::move(get<0>());
+            if (is_ok()) return std::move(m_data.template get<0>());
             call_panic_with_TE_uncheck<1>(msg, ": ");
         }
 
         [[nodiscard]] constexpr T expect(const std::string_view& msg) const {
-            if (is_ok()) return get<0>();
+            if (is_ok()) return m_data.template get<0>();
             call_panic_with_TE_uncheck<1>(msg, ": ");
         }
 
@@ -719,12 +926,12 @@ namespace C163q {
          * ```
          */
         [[nodiscard]] constexpr T unwrap() {
-            if (is_ok()) return std::move(get<0>());
+            if (is_ok()) return std::move(m_data.template get<0>());
             call_panic_with_TE_uncheck<1>("", "");
         }
 
         [[nodiscard]] constexpr T unwrap() const {
-            if (is_ok()) return get<0>();
+            if (is_ok()) return m_data.template get<0>();
             call_panic_with_TE_uncheck<1>("", "");
         }
 
@@ -749,15 +956,17 @@ namespace C163q {
          * assert(val2 == 0);
          * ```
          */
-        [[nodiscard]] constexpr T unwrap_or_default()
+        [[nodiscard]] constexpr T unwrap_or_default(MY_INSTRUMENT_PARAM)
             noexcept(std::is_nothrow_move_constructible_v<T> && std::is_nothrow_default_constructible_v<T>) {
-            if (is_ok()) return std::move(get<0>());
+            if (is_ok()) return std::move(m_data.template get<0>());
+            MY_INSTRUMENT(unwrap_or);
             return T();
         }
 
-        [[nodiscard]] constexpr T unwrap_or_default() const
+        [[nodiscard]] constexpr T unwrap_or_default(MY_INSTRUMENT_PARAM) const
             noexcept(std::is_nothrow_copy_constructible_v<T> && std::is_nothrow_default_constructible_v<T>) {
-            if (is_ok()) return get<0>();
+            if (is_ok()) return m_data.template get<0>();
+            MY_INSTRUMENT(unwrap_or);
             return T();
         }
 
@@ -780,12 +989,12 @@ namespace C163q {
          * ```
          */
         [[nodiscard]] constexpr E expect_err(const std::string_view& msg) {
-            if (is_err()) return std::move(get<1>());
+            if (is_err()) return std::move(m_data.template get<1>());
             call_panic_with_TE_uncheck<0>(msg, ": ");
         }
 
         [[nodiscard]] constexpr E expect_err(const std::string_view& msg) const {
-            if (is_err()) return get<1>();
+            if (is_err()) return m_data.template get<1>();
             call_panic_with_TE_uncheck<0>(msg, ": ");
         }
 
@@ -806,15 +1015,45 @@ namespace C163q {
          * ```
          */
         [[nodiscard]] constexpr E unwrap_err() {
-            if (is_err()) return std::move(get<1>());
+            if (is_err()) return std::move(m_data.template get<1>());
             call_panic_with_TE_uncheck<0>("", "");
         }
 
         [[nodiscard]] constexpr E unwrap_err() const {
-            if (is_err()) return get<1>();
+            if (is_err()) return m_data.template get<1>();
             call_panic_with_TE_uncheck<0>("", "");
         }
 
+        /**
+         * @brief 不进行检查地返回存储的Ok值，调用者需要保证处于Ok状态，否则行为未定义。
+         *        非const时移动存储值，const时复制存储值。
+         *
+         * 前置条件的处理与get_uncheck()相同。
+         */
+        [[nodiscard]] constexpr T unwrap_unchecked(
+                const std::source_location location = std::source_location::current()) {
+            return std::move(get_uncheck<0>(location));
+        }
+
+        [[nodiscard]] constexpr T unwrap_unchecked(
+                const std::source_location location = std::source_location::current()) const {
+            return get_uncheck<0>(location);
+        }
+
+        /**
+         * @brief 不进行检查地返回存储的Err值，调用者需要保证处于Err状态，否则行为未定义。
+         *        非const时移动存储值，const时复制存储值。
+         */
+        [[nodiscard]] constexpr E unwrap_err_unchecked(
+                const std::source_location location = std::source_location::current()) {
+            return std::move(get_uncheck<1>(location));
+        }
+
+        [[nodiscard]] constexpr E unwrap_err_unchecked(
+                const std::source_location location = std::source_location::current()) const {
+            return get_uncheck<1>(location);
+        }
+
         /**
          * @brief 如果自身是Ok，则返回res；否则返回自身的Err值。
          *        非const时移动存储值，const时复制存储值。
@@ -852,7 +1091,7 @@ namespace C163q {
                  std::is_nothrow_constructible_v<Result<U, E>, std::in_place_index_t<1>, E&&> &&
                  std::is_nothrow_move_constructible_v<E>) {
             if (is_ok()) return res;
-            return Result<U, E>(std::in_place_index<1>, std::move(get<1>()));
+            return Result<U, E>(std::in_place_index<1>, std::move(m_data.template get<1>()));
         }
 
         template<typename U>
@@ -861,7 +1100,7 @@ namespace C163q {
                  std::is_nothrow_constructible_v<Result<U, E>, std::in_place_index_t<1>, const E&> &&
                  std::is_nothrow_copy_constructible_v<E>) {
             if (is_ok()) return res;
-            return Result<U, E>(std::in_place_index<1>, get<1>());
+            return Result<U, E>(std::in_place_index<1>, m_data.template get<1>());
         }
 
         /**
@@ -901,8 +1140,8 @@ namespace C163q {
                  std::is_nothrow_move_constructible_v<E> &&
                  std::is_nothrow_constructible_v<Result<U, E>, std::in_place_index_t<1>, E&&> &&
                  std::is_nothrow_constructible_v<Result<U, E>, std::invoke_result_t<F, T&&>>) {
-            if (is_ok()) return std::invoke(std::forward<F>(op), std::move(get<0>()));
-            return Result<U, E>(std::in_place_index<1>, std::move(get<1>()));
+            if (is_ok()) return std::invoke(std::forward<F>(op), std::move(m_data.template get<0>()));
+            return Result<U, E>(std::in_place_index<1>, std::move(m_data.template get<1>()));
         }
 
         template<typename U, typename F>
@@ -913,8 +1152,67 @@ namespace C163q {
         noexcept(std::is_nothrow_invocable_v<F, const T&> && std::is_nothrow_copy_constructible_v<E> &&
                  std::is_nothrow_constructible_v<Result<U, E>, std::in_place_index_t<1>, const E&> &&
                  std::is_nothrow_constructible_v<Result<U, E>, std::invoke_result_t<F, const T&>>) {
-            if (is_ok()) return std::invoke(std::forward<F>(op), get<0>());
-            return Result<U, E>(std::in_place_index<1>, get<1>());
+            if (is_ok()) return std::invoke(std::forward<F>(op), m_data.template get<0>());
+            return Result<U, E>(std::in_place_index<1>, m_data.template get<1>());
+        }
+
+        /**
+         * @brief 与map、and_then相同，但使用alloc以uses-allocator方式构造返回的Result
+         *        非const时移动存储值，const时复制存储值。
+         *
+         * 若func可以在参数末尾额外接收alloc，则调用func(value, alloc)，返回值类型恰好是U（and_then时为Result<U, E>）时
+         * 直接构造在返回值中，由func负责使用alloc分配；否则调用func(value)，再使用alloc由返回值构造。Err值同样使用alloc构造。
+         * 这使得整条调用链上的分配都可以来自同一个std::pmr::memory_resource。
+         *
+         * @tparam U     返回的Result的Ok值的类型
+         * @tparam Alloc 分配器的类型
+         * @tparam F     可调用对象的类型
+         *
+         * @example
+         * ```cpp
+         * std::pmr::monotonic_buffer_resource arena;
+         * std::pmr::polymorphic_allocator<> alloc(&arena);
+         * auto x = C163q::Result<std::pmr::string, int>(std::allocator_arg, alloc, std::in_place_index<0>, "abc")
+         *     .map<std::pmr::string>(std::allocator_arg, alloc, [](std::pmr::string&& s, const auto& a) {
+         *         std::pmr::string ret(s, a);
+         *         ret += s;
+         *         return ret;
+         *     })
+         *     .map<std::pmr::string>(std::allocator_arg, alloc, [](std::pmr::string&& s) { return s + "!"; });
+         * assert(x.get<0>() == "abcabc!" && x.get<0>().get_allocator() == alloc);
+         * ```
+         */
+        template<typename U, typename Alloc, typename F>
+            requires (invocable_using_allocator<U, Alloc, F, T&&> && constructible_using_allocator<E, Alloc, E&&>)
+        [[nodiscard]] constexpr Result<U, E> map(std::allocator_arg_t, const Alloc& alloc, F&& func) {
+            if (is_err()) return Result<U, E>(std::allocator_arg, alloc, std::in_place_index<1>, std::move(m_data.template get<1>()));
+            return Result<U, E>(std::in_place_index<0>, invoke_for_construct<U>(
+                        invoke_using_allocator<U>, alloc, std::forward<F>(func), std::move(m_data.template get<0>())));
+        }
+
+        template<typename U, typename Alloc, typename F>
+            requires (invocable_using_allocator<U, Alloc, F, const T&> &&
+                      constructible_using_allocator<E, Alloc, const E&>)
+        [[nodiscard]] constexpr Result<U, E> map(std::allocator_arg_t, const Alloc& alloc, F&& func) const {
+            if (is_err()) return Result<U, E>(std::allocator_arg, alloc, std::in_place_index<1>, m_data.template get<1>());
+            return Result<U, E>(std::in_place_index<0>, invoke_for_construct<U>(
+                        invoke_using_allocator<U>, alloc, std::forward<F>(func), m_data.template get<0>()));
+        }
+
+        template<typename U, typename Alloc, typename F>
+            requires (invocable_using_allocator<Result<U, E>, Alloc, F, T&&> &&
+                      constructible_using_allocator<E, Alloc, E&&>)
+        [[nodiscard]] constexpr Result<U, E> and_then(std::allocator_arg_t, const Alloc& alloc, F&& op) {
+            if (is_ok()) return invoke_using_allocator<Result<U, E>>(alloc, std::forward<F>(op), std::move(m_data.template get<0>()));
+            return Result<U, E>(std::allocator_arg, alloc, std::in_place_index<1>, std::move(m_data.template get<1>()));
+        }
+
+        template<typename U, typename Alloc, typename F>
+            requires (invocable_using_allocator<Result<U, E>, Alloc, F, const T&> &&
+                      constructible_using_allocator<E, Alloc, const E&>)
+        [[nodiscard]] constexpr Result<U, E> and_then(std::allocator_arg_t, const Alloc& alloc, F&& op) const {
+            if (is_ok()) return invoke_using_allocator<Result<U, E>>(alloc, std::forward<F>(op), m_data.template get<0>());
+            return Result<U, E>(std::allocator_arg, alloc, std::in_place_index<1>, m_data.template get<1>());
         }
 
         /**
@@ -947,21 +1245,27 @@ namespace C163q {
          * ```
          */
         template<typename F>
-        [[nodiscard]] constexpr Result<T, F> or_else(Result<T, F> res)
+        [[nodiscard]] constexpr Result<T, F> or_else(Result<T, F> res MY_INSTRUMENT_NEXT_PARAM)
         noexcept(std::is_nothrow_move_constructible_v<Result<T, F>> &&
                  std::is_nothrow_constructible_v<Result<T, F>, std::in_place_index_t<0>, T&&> &&
                  std::is_nothrow_move_constructible_v<T>) {
-            if (is_err()) return res;
-            return Result<T, F>(std::in_place_index<0>, std::move(get<0>()));
+            if (is_err()) {
+                MY_INSTRUMENT(or_else);
+                return res;
+            }
+            return Result<T, F>(std::in_place_index<0>, std::move(m_data.template get<0>()));
         }
 
         template<typename F>
-        [[nodiscard]] constexpr Result<T, F> or_else(Result<T, F> res) const
+        [[nodiscard]] constexpr Result<T, F> or_else(Result<T, F> res MY_INSTRUMENT_NEXT_PARAM) const
         noexcept(std::is_nothrow_move_constructible_v<Result<T, F>> &&
                  std::is_nothrow_constructible_v<Result<T, F>, std::in_place_index_t<0>, const T&> &&
                  std::is_nothrow_copy_constructible_v<T>) {
-            if (is_err()) return res;
-            return Result<T, F>(std::in_place_index<0>, get<0>());
+            if (is_err()) {
+                MY_INSTRUMENT(or_else);
+                return res;
+            }
+            return Result<T, F>(std::in_place_index<0>, m_data.template get<0>());
         }
 
         /**
@@ -991,25 +1295,31 @@ namespace C163q {
             requires (requires (O f, E e) {
                 { std::invoke(f, std::move(e)) } -> std::convertible_to<Result<T, F>>;
             })
-        [[nodiscard]] constexpr Result<T, F> or_else(O&& op)
+        [[nodiscard]] constexpr Result<T, F> or_else(O&& op MY_INSTRUMENT_NEXT_PARAM)
         noexcept(std::is_nothrow_invocable_v<O, E&&> && std::is_nothrow_move_constructible_v<E> &&
                  std::is_nothrow_move_constructible_v<T> &&
                  std::is_nothrow_constructible_v<Result<T, F>, std::in_place_index_t<0>, T&&> &&
                  std::is_nothrow_constructible_v<Result<T, E>, std::invoke_result_t<O, E&&>>) {
-            if (is_err()) return std::invoke(std::forward<O>(op), std::move(get<1>()));
-            return Result<T, F>(std::in_place_index<0>, std::move(get<0>()));
+            if (is_err()) {
+                MY_INSTRUMENT(or_else);
+                return std::invoke(std::forward<O>(op), std::move(m_data.template get<1>()));
+            }
+            return Result<T, F>(std::in_place_index<0>, std::move(m_data.template get<0>()));
         }
 
         template<typename F, typename O>
             requires (requires (O f, const E& e) {
                 { std::invoke(f, e) } -> std::convertible_to<Result<T, F>>;
             })
-        [[nodiscard]] constexpr Result<T, F> or_else(O&& op) const
+        [[nodiscard]] constexpr Result<T, F> or_else(O&& op MY_INSTRUMENT_NEXT_PARAM) const
         noexcept(std::is_nothrow_invocable_v<O, const E&> && std::is_nothrow_copy_constructible_v<T> &&
                  std::is_nothrow_constructible_v<Result<T, F>, std::in_place_index_t<0>, const T&> &&
                  std::is_nothrow_constructible_v<Result<T, F>, std::invoke_result_t<O, const E&>>) {
-            if (is_err()) return std::invoke(std::forward<O>(op), get<1>());
-            return Result<T, F>(std::in_place_index<0>, get<0>());
+            if (is_err()) {
+                MY_INSTRUMENT(or_else);
+                return std::invoke(std::forward<O>(op), m_data.template get<1>());
+            }
+            return Result<T, F>(std::in_place_index<0>, m_data.template get<0>());
         }
 
         /**
@@ -1028,15 +1338,17 @@ namespace C163q {
          * assert(y.unwrap_or(val) == 2);
          * ```
          */
-        [[nodiscard]] constexpr T unwrap_or(T default_value)
+        [[nodiscard]] constexpr T unwrap_or(T default_value MY_INSTRUMENT_NEXT_PARAM)
         noexcept(std::is_nothrow_move_constructible_v<T>) {
-            if (is_ok()) return std::move(get<0>());
+            if (is_ok()) return std::move(m_data.template get<0>());
+            MY_INSTRUMENT(unwrap_or);
             return default_value;
         }
 
-        [[nodiscard]] constexpr T unwrap_or(T default_value) const
+        [[nodiscard]] constexpr T unwrap_or(T default_value MY_INSTRUMENT_NEXT_PARAM) const
         noexcept(std::is_nothrow_move_constructible_v<T> && std::is_nothrow_copy_constructible_v<T>) {
-            if (is_ok()) return get<0>();
+            if (is_ok()) return m_data.template get<0>();
+            MY_INSTRUMENT(unwrap_or);
             return default_value;
         }
 
@@ -1060,23 +1372,25 @@ namespace C163q {
             requires requires (F f, E e) {
                 { std::invoke(f, std::move(e)) } -> std::convertible_to<T>;
             }
-        [[nodiscard]] constexpr T unwrap_or(F&& op)
+        [[nodiscard]] constexpr T unwrap_or(F&& op MY_INSTRUMENT_NEXT_PARAM)
         noexcept(std::is_nothrow_invocable_v<F, E&&> && std::is_nothrow_move_constructible_v<T> &&
                  std::is_nothrow_move_constructible_v<E> &&
                  std::is_nothrow_constructible_v<T, std::invoke_result_t<F, E&&>>) {
-            if (is_ok()) return std::move(get<0>());
-            return std::invoke(std::forward<F>(op), std::move(get<1>()));
+            if (is_ok()) return std::move(m_data.template get<0>());
+            MY_INSTRUMENT(unwrap_or);
+            return std::invoke(std::forward<F>(op), std::move(m_data.template get<1>()));
         }
 
         template<typename F>
             requires requires (F f, const E& e) {
                 { std::invoke(f, e) } -> std::convertible_to<T>;
             }
-        [[nodiscard]] constexpr T unwrap_or(F&& op) const
+        [[nodiscard]] constexpr T unwrap_or(F&& op MY_INSTRUMENT_NEXT_PARAM) const
         noexcept(std::is_nothrow_invocable_v<F, const E&> && std::is_nothrow_copy_constructible_v<T> &&
                  std::is_nothrow_constructible_v<T, std::invoke_result_t<F, const E&>>) {
-            if (is_ok()) return get<0>();
-            return std::invoke(std::forward<F>(op), get<1>());
+            if (is_ok()) return m_data.template get<0>();
+            MY_INSTRUMENT(unwrap_or);
+            return std::invoke(std::forward<F>(op), m_data.template get<1>());
         }
 
         /**
@@ -1090,16 +1404,16 @@ namespace C163q {
             requires std::is_copy_constructible_v<T> && std::same_as<T, std::reference_wrapper<U>> &&
                      std::is_move_constructible_v<E>
         [[nodiscard]] constexpr Result<U, E> copied() {
-            if (is_err()) return Result<U, E>(std::in_place_index<1>, std::move(get<1>()));
-            return Result<U, E>(std::in_place_index<0>, get<0>().get());
+            if (is_err()) return Result<U, E>(std::in_place_index<1>, std::move(m_data.template get<1>()));
+            return Result<U, E>(std::in_place_index<0>, m_data.template get<0>().get());
         }
 
         template<typename U = my_type<T>::type>
             requires std::is_copy_constructible_v<T> && std::same_as<T, std::reference_wrapper<U>> &&
                      std::is_copy_constructible_v<E>
         [[nodiscard]] constexpr Result<U, E> copied() const {
-            if (is_err()) return Result<U, E>(std::in_place_index<1>, get<1>());
-            return Result<U, E>(std::in_place_index<0>, get<0>().get());
+            if (is_err()) return Result<U, E>(std::in_place_index<1>, m_data.template get<1>());
+            return Result<U, E>(std::in_place_index<0>, m_data.template get<0>().get());
         }
 
         /**
@@ -1107,15 +1421,15 @@ namespace C163q {
          */
         template<typename U, typename F>
         Result<T, E>& assign(const Result<U, F>& other) {
-            if (other.is_ok()) m_data.emplace<0>(other.template get<0>());
-            else m_data.emplace<1>(other.template get<1>());
+            if (other.is_ok()) m_data.template emplace<0>(other.template get_uncheck<0>());
+            else m_data.template emplace<1>(other.template get_uncheck<1>());
             return *this;
         }
 
         template<typename U, typename F>
         Result<T, E>& assign(Result<U, F>&& other) {
-            if (other.is_ok()) m_data.emplace<0>(std::move(other.template get<0>()));
-            else m_data.emplace<1>(std::move(other.template get<1>()));
+            if (other.is_ok()) m_data.template emplace<0>(std::move(other.template get_uncheck<0>()));
+            else m_data.template emplace<1>(std::move(other.template get_uncheck<1>()));
             return *this;
         }
 
@@ -1135,13 +1449,13 @@ namespace C163q {
          * @warning 注意保存元素的生命周期！
          */
         [[nodiscard]] constexpr as_cref_t as_ref() const noexcept {
-            if (is_ok()) return as_cref_t(std::in_place_index<0>, std::cref(get<0>()));
-            return as_cref_t(std::in_place_index<1>, std::cref(get<1>()));
+            if (is_ok()) return as_cref_t(std::in_place_index<0>, std::cref(m_data.template get<0>()));
+            return as_cref_t(std::in_place_index<1>, std::cref(m_data.template get<1>()));
         }
 
         [[nodiscard]] constexpr as_ref_t as_ref() noexcept {
-            if (is_ok()) return as_ref_t(std::in_place_index<0>, std::ref(get<0>()));
-            return as_ref_t(std::in_place_index<1>, std::ref(get<1>()));
+            if (is_ok()) return as_ref_t(std::in_place_index<0>, std::ref(m_data.template get<0>()));
+            return as_ref_t(std::in_place_index<1>, std::ref(m_data.template get<1>()));
         }
 
     private:
@@ -1151,28 +1465,32 @@ namespace C163q {
          */
         template<size_t I>
             requires (I == 0 || I == 1)
-        [[noreturn]] constexpr void call_panic_with_TE_uncheck(const std::string_view& msg, const std::string_view& sep) const {
+        MY_COLD [[noreturn]] constexpr void call_panic_with_TE_uncheck(const std::string_view& msg, const std::string_view& sep) const {
             using U = std::conditional_t<I == 0, T, E>;
-            if constexpr (
-#ifdef MY_CXX23
-                std::formattable<U, char>
-#else // C++23 ^^^ /  vvv C++20
-                requires (std::formatter<U>& f, const std::formatter<U>& cf, U&& t,
-                    std::format_parse_context& p, std::format_context& fc) {
-                    { f.parse(p) };
-                    { cf.format(t, fc) };
-                }
-#endif
-            ) {
-                auto&& str = std::format("{}{}{}", msg, sep, get<I>());
-                panic(str);
+            if constexpr (panic_pass_by_value_v<U>) {
+                call_panic_format_value_(msg, sep, m_data.template get<I>());
+            } else if constexpr (panic_formattable<U>) {
+                // 格式化在panic.cpp中进行，调用处只需要传递指针
+                call_panic_format_(msg, sep, &panic_format_value_<U>, std::addressof(m_data.template get<I>()));
             } else {
                 panic(msg);
             }
         }
 
+        template<typename Alloc, typename R>
+        static constexpr result_storage_t<T, E> storage_using_allocator(const Alloc& alloc, R&& other) {
+            using value_t = std::conditional_t<std::is_const_v<std::remove_reference_t<R>>, const T&, T&&>;
+            using error_t = std::conditional_t<std::is_const_v<std::remove_reference_t<R>>, const E&, E&&>;
+            if (other.is_ok()) {
+                return result_storage_t<T, E>(std::in_place_index<0>, invoke_for_construct<T>(
+                            make_using_allocator<T>, alloc, static_cast<value_t>(other.template get_uncheck<0>())));
+            }
+            return result_storage_t<T, E>(std::in_place_index<1>, invoke_for_construct<E>(
+                        make_using_allocator<E>, alloc, static_cast<error_t>(other.template get_uncheck<1>())));
+        }
+
     private:
-        std::variant<T, E> m_data;
+        result_storage_t<T, E> m_data;
     };
 
 
@@ -1196,34 +1514,79 @@ namespace C163q {
         using alternative_ref_t = std::conditional_t<I == 0, void,
             std::variant_alternative_t<I, std::variant<std::monostate, E>>&>;
 
+        template<size_t I>
+        using alternative_cref_t = std::conditional_t<I == 0, void,
+            const std::variant_alternative_t<I, std::variant<std::monostate, E>>&>;
+
         template<typename U>
         using ref_t = std::conditional_t<std::is_same_v<U, void>, void, U&>;
 
+        template<typename U>
+        using cref_t = std::conditional_t<std::is_same_v<U, void>, void, const U&>;
+
+    public:
+        using value_type = void;
+        using error_type = E;
+
     public:
         constexpr Result() noexcept : m_data() {}
 
         template<typename F>
             requires std::constructible_from<E, F>
         constexpr explicit Result(F&& err) noexcept(std::is_nothrow_constructible_v<E, F>)
-            : m_data(std::forward<F>(err)) {}
+            : m_data(std::in_place_index<1>, std::forward<F>(err)) {}
 
         template<typename U = E, typename ...Args>
             requires (std::is_same_v<E, U> && std::is_constructible_v<U, Args...> &&
                      !std::is_same_v<std::monostate, E>)
         constexpr explicit Result(std::in_place_type_t<U>, Args&&... args)
-            :m_data(std::in_place_type<U>, std::forward<Args>(args)...) {}
+            :m_data(std::in_place_index<1>, std::forward<Args>(args)...) {}
 
-        constexpr explicit Result<void>(std::in_place_type_t<void>) : m_data() {}
+        constexpr explicit Result(std::in_place_type_t<void>) : m_data() {}
 
         template<size_t I = 1, typename ...Args>
             requires ((I == 1) && std::is_constructible_v<E, Args...>)
         constexpr explicit Result(std::in_place_index_t<I>, Args&&... args)
+            noexcept(std::is_nothrow_constructible_v<result_storage_t<void, E>, std::in_place_index_t<I>, Args...>)
             : m_data(std::in_place_index<I>, std::forward<Args>(args)...) {}
 
-        constexpr explicit Result<0>(std::in_place_index_t<0>) : m_data() {}
+        constexpr explicit Result(std::in_place_index_t<0>)
+            noexcept(std::is_nothrow_default_constructible_v<result_storage_t<void, E>>)
+            : m_data() {}
+
+        /**
+         * @brief 使用alloc以uses-allocator方式构造Result，见Result<T, E>的对应构造函数
+         */
+        template<typename Alloc>
+        constexpr Result(std::allocator_arg_t, const Alloc&) noexcept : m_data() {}
+
+        template<typename Alloc>
+        constexpr explicit Result(std::allocator_arg_t, const Alloc&, std::in_place_index_t<0>) noexcept : m_data() {}
+
+        template<typename Alloc, size_t I = 1, typename ...Args>
+            requires ((I == 1) && constructible_using_allocator<E, Alloc, Args...>)
+        constexpr explicit Result(std::allocator_arg_t, const Alloc& alloc, std::in_place_index_t<I>, Args&&... args)
+            : m_data(std::in_place_index<1>, invoke_for_construct<E>(
+                        make_using_allocator<E>, alloc, std::forward<Args>(args)...)) {}
+
+        template<typename Alloc, typename F>
+            requires (constructible_using_allocator<E, Alloc, F> && std::constructible_from<E, F> &&
+                    !std::is_same_v<std::remove_cvref_t<F>, Result>)
+        constexpr explicit Result(std::allocator_arg_t, const Alloc& alloc, F&& err)
+            : Result(std::allocator_arg, alloc, std::in_place_index<1>, std::forward<F>(err)) {}
+
+        template<typename Alloc>
+            requires constructible_using_allocator<E, Alloc, const E&>
+        constexpr Result(std::allocator_arg_t, const Alloc& alloc, const Result& other)
+            : m_data(storage_using_allocator(alloc, other)) {}
+
+        template<typename Alloc>
+            requires constructible_using_allocator<E, Alloc, E&&>
+        constexpr Result(std::allocator_arg_t, const Alloc& alloc, Result&& other)
+            : m_data(storage_using_allocator(alloc, std::move(other))) {}
 
         constexpr Result(const Result&) = default;
-        constexpr Result(Result&&) noexcept(std::is_nothrow_constructible_v<E>) = default;
+        constexpr Result(Result&&) noexcept(std::is_nothrow_move_constructible_v<E>) = default;
         constexpr Result& operator=(const Result&) = default;
         constexpr Result& operator=(Result&&) noexcept(std::is_nothrow_move_constructible_v<E> &&
                 std::is_nothrow_move_assignable_v<E>) = default;
@@ -1250,72 +1613,72 @@ namespace C163q {
             }
         [[nodiscard]] constexpr bool is_err_and(F&& f)
             const noexcept(std::is_nothrow_invocable_v<F, const E&>) {
-            return !!m_data.index() && std::invoke(std::forward<F>(f), const_cast<const E&>(std::get<1>(m_data)));
+            return !!m_data.index() && std::invoke(std::forward<F>(f), m_data.template get<1>());
         }
 
         template<typename U>
             requires (std::is_same_v<U, void> || std::is_same_v<U, E>)
         [[nodiscard]] constexpr ref_t<U> get() {
-            try {
-                if constexpr (std::is_same_v<U, void>) {
-                    (void) std::get<0>(m_data); // necessary
-                    return;
-                } else {
-                    return std::get<1>(m_data);
-                }
-            } catch(...) {
-                panic("Invaild access to Result");
-            }
+            return get<std::is_same_v<U, void> ? 0 : 1>();
         }
 
         template<typename U>
             requires (std::is_same_v<U, void> || std::is_same_v<U, E>)
-        [[nodiscard]] constexpr const ref_t<U> get() const {
-            try {
-                if constexpr (std::is_same_v<U, void>) {
-                    (void) std::get<0>(m_data); // necessary
-                    return;
-                } else {
-                    return std::get<1>(m_data);
-                }
-            } catch(...) {
-                panic("Invaild access to Result");
-            }
+        [[nodiscard]] constexpr cref_t<U> get() const {
+            return get<std::is_same_v<U, void> ? 0 : 1>();
         }
 
         template<size_t I>
             requires (I == 0 || I == 1)
         [[nodiscard]] constexpr alternative_ref_t<I> get() {
-            try {
-                if constexpr (I == 0) {
-                    (void) std::get<0>(m_data);
-                    return;
-                }
-                else {
-                    return std::get<1>(m_data);
-                }
-            } catch(...) {
-                panic("Invaild access to Result");
-            }
+            if (m_data.index() != I) panic("Invaild access to Result");
+            if constexpr (I == 1) return m_data.template get<1>();
         }
 
         template<size_t I>
             requires (I == 0 || I == 1)
-        [[nodiscard]] constexpr const alternative_ref_t<I> get() const {
-            try {
-                if constexpr (I == 0) {
-                    (void) std::get<0>(m_data);
-                    return;
-                } else {
-                    return std::get<I>(m_data);
-                }
-            } catch(...) {
-                panic("Invaild access to Result");
-            }
+        [[nodiscard]] constexpr alternative_cref_t<I> get() const {
+            if (m_data.index() != I) panic("Invaild access to Result");
+            if constexpr (I == 1) return m_data.template get<1>();
         }
 
-        [[nodiscard]] constexpr const std::variant<std::monostate, E>& data() const noexcept {
-            return m_data;
+        template<size_t I>
+            requires (I == 0 || I == 1)
+        [[nodiscard]] constexpr alternative_ref_t<I> get_uncheck(
+                const std::source_location location = std::source_location::current()) MY_UNCHECKED_NOEXCEPT {
+            MY_UNCHECKED_PRECONDITION(m_data.index() == I, "Invaild access to Result", location);
+            if constexpr (I == 1) return m_data.template get<1>();
+        }
+
+        template<size_t I>
+            requires (I == 0 || I == 1)
+        [[nodiscard]] constexpr alternative_cref_t<I> get_uncheck(
+                const std::source_location location = std::source_location::current()) const MY_UNCHECKED_NOEXCEPT {
+            MY_UNCHECKED_PRECONDITION(m_data.index() == I, "Invaild access to Result", location);
+            if constexpr (I == 1) return m_data.template get<1>();
+        }
+
+        /**
+         * @brief 以std::variant<std::monostate, E>的常引用访问Result内保有的数据
+         *
+         * 与Result<T, E>::data()相同，不使用std::variant存储时返回复制得到的std::variant，已被弃用。
+         */
+        [[nodiscard]] constexpr const std::variant<std::monostate, E>& data() const noexcept
+            requires std::is_same_v<result_storage_t<void, E>, result_variant_storage<void, E>> {
+            return m_data.variant();
+        }
+
+        [[nodiscard, deprecated("Result does not store a std::variant here, use to_variant()")]]
+        constexpr std::variant<std::monostate, E> data() const
+            requires (!std::is_same_v<result_storage_t<void, E>, result_variant_storage<void, E>>) {
+            return m_data.to_variant();
+        }
+
+        /**
+         * @brief 复制保有的错误值，得到std::variant<std::monostate, E>，可用于任何存储
+         */
+        [[nodiscard]] constexpr std::variant<std::monostate, E> to_variant() const {
+            return m_data.to_variant();
         }
 
 
@@ -1326,7 +1689,7 @@ namespace C163q {
 
         [[nodiscard]] constexpr std::optional<E> err() noexcept(std::is_nothrow_move_constructible_v<E>) {
             if (is_ok()) return std::nullopt;
-            return std::optional<E>(std::in_place, std::move(get<1>()));
+            return std::optional<E>(std::in_place, std::move(m_data.template get<1>()));
         }
 
         template<typename U, typename F>
@@ -1336,8 +1699,8 @@ namespace C163q {
         [[nodiscard]] constexpr Result<U, E> map(F&& func) const
             noexcept(std::is_nothrow_constructible_v<U, std::invoke_result_t<F>> &&
                      std::is_nothrow_copy_constructible_v<E> && std::is_nothrow_invocable_v<F>) {
-            if (is_err()) return Result<U, E>(std::in_place_index<1>, get<1>());
-            return Result<U, E>(std::in_place_index<0>, std::invoke(std::forward<F>(func)));
+            if (is_err()) return Result<U, E>(std::in_place_index<1>, m_data.template get<1>());
+            return Result<U, E>(std::in_place_index<0>, invoke_for_construct<U>(std::forward<F>(func)));
         }
 
         // 非const同下
@@ -1362,7 +1725,7 @@ namespace C163q {
                      std::is_nothrow_constructible_v<U, std::invoke_result_t<F>> &&
                      std::is_nothrow_move_constructible_v<U> && std::is_nothrow_invocable_v<D, const E&> &&
                      std::is_nothrow_invocable_v<F>) {
-            if (is_err()) return std::invoke(std::forward<D>(fallback), get<1>());
+            if (is_err()) return std::invoke(std::forward<D>(fallback), m_data.template get<1>());
             return std::invoke(std::forward<F>(func));
         }
 
@@ -1374,7 +1737,7 @@ namespace C163q {
             noexcept(std::is_nothrow_constructible_v<F, std::invoke_result_t<O, const E&>> &&
                      std::is_nothrow_invocable_v<O, const E&>) {
             if (is_ok()) return Result<void, F>();
-            return Result<void, F>(std::in_place_index<1>, std::invoke(std::forward<O>(op), get<1>()));
+            return Result<void, F>(std::in_place_index<1>, invoke_for_construct<F>(std::forward<O>(op), m_data.template get<1>()));
         }
 
         template<typename U, typename F>
@@ -1385,8 +1748,8 @@ namespace C163q {
             noexcept(std::is_nothrow_constructible_v<U, std::invoke_result_t<F>> &&
                      std::is_nothrow_move_constructible_v<E> &&
                      std::is_nothrow_invocable_v<F>) {
-            if (is_err()) return Result<U, E>(std::in_place_index<1>, std::move(get<1>()));
-            return Result<U, E>(std::in_place_index<0>, std::invoke(std::forward<F>(func)));
+            if (is_err()) return Result<U, E>(std::in_place_index<1>, std::move(m_data.template get<1>()));
+            return Result<U, E>(std::in_place_index<0>, invoke_for_construct<U>(std::forward<F>(func)));
         }
 
         template<typename U, typename D, typename F>
@@ -1399,7 +1762,7 @@ namespace C163q {
                       std::is_nothrow_constructible_v<U, std::invoke_result_t<F>> &&
                       std::is_nothrow_move_constructible_v<U> && std::is_nothrow_move_constructible_v<E> &&
                       std::is_nothrow_invocable_v<D, E> && std::is_nothrow_invocable_v<F>) {
-            if (is_err()) return std::invoke(std::forward<D>(fallback), std::move(get<1>()));
+            if (is_err()) return std::invoke(std::forward<D>(fallback), std::move(m_data.template get<1>()));
             return std::invoke(std::forward<F>(func));
         }
 
@@ -1411,8 +1774,8 @@ namespace C163q {
             noexcept(std::is_nothrow_constructible_v<F, std::invoke_result_t<O, E>> &&
                      std::is_nothrow_move_constructible_v<E> && std::is_nothrow_invocable_v<O, E>) {
             if (is_ok()) return Result<void, F>();
-            return Result<void, F>(std::in_place_index<1>, std::invoke(
-                            std::forward<O>(op), std::move(get<1>())));
+            return Result<void, F>(std::in_place_index<1>, invoke_for_construct<F>(
+                            std::forward<O>(op), std::move(m_data.template get<1>())));
         }
 
         // 非const同下
@@ -1431,32 +1794,47 @@ namespace C163q {
         }
 
         [[nodiscard]] constexpr E expect_err(const std::string_view& msg) {
-            if (is_err()) return std::move(get<1>());
+            if (is_err()) return std::move(m_data.template get<1>());
             call_panic_with_TE_uncheck<0>(msg, ": ");
         }
 
         [[nodiscard]] constexpr E expect_err(const std::string_view& msg) const {
-            if (is_err()) return get<1>();
+            if (is_err()) return m_data.template get<1>();
             call_panic_with_TE_uncheck<0>(msg, ": ");
         }
 
         [[nodiscard]] constexpr E unwrap_err() {
-            if (is_err()) return std::move(get<1>());
+            if (is_err()) return std::move(m_data.template get<1>());
             call_panic_with_TE_uncheck<0>("", "");
         }
 
         [[nodiscard]] constexpr E unwrap_err() const {
-            if (is_err()) return get<1>();
+            if (is_err()) return m_data.template get<1>();
             call_panic_with_TE_uncheck<0>("", "");
         }
 
+        constexpr void unwrap_unchecked(
+                const std::source_location location = std::source_location::current()) const {
+            MY_UNCHECKED_PRECONDITION(is_ok(), "Invaild access to Result", location);
+        }
+
+        [[nodiscard]] constexpr E unwrap_err_unchecked(
+                const std::source_location location = std::source_location::current()) {
+            return std::move(get_uncheck<1>(location));
+        }
+
+        [[nodiscard]] constexpr E unwrap_err_unchecked(
+                const std::source_location location = std::source_location::current()) const {
+            return get_uncheck<1>(location);
+        }
+
         template<typename U>
         [[nodiscard]] constexpr Result<U, E> and_then(Result<U, E> res)
         noexcept(std::is_nothrow_move_constructible_v<Result<U, E>> &&
                  std::is_nothrow_constructible_v<Result<U, E>, std::in_place_index_t<1>, E&&> &&
                  std::is_nothrow_move_constructible_v<E>) {
             if (is_ok()) return res;
-            return Result<U, E>(std::in_place_index<1>, std::move(get<1>()));
+            return Result<U, E>(std::in_place_index<1>, std::move(m_data.template get<1>()));
         }
 
         template<typename U>
@@ -1465,7 +1843,7 @@ namespace C163q {
                  std::is_nothrow_constructible_v<Result<U, E>, std::in_place_index_t<1>, const E&> &&
                  std::is_nothrow_copy_constructible_v<E>) {
             if (is_ok()) return res;
-            return Result<U, E>(std::in_place_index<1>, get<1>());
+            return Result<U, E>(std::in_place_index<1>, m_data.template get<1>());
         }
 
         template<typename U, typename F>
@@ -1476,8 +1854,8 @@ namespace C163q {
         noexcept(std::is_nothrow_invocable_v<F> && std::is_nothrow_move_constructible_v<E> &&
                  std::is_nothrow_constructible_v<Result<U, E>, std::in_place_index_t<1>, E&&> &&
                  std::is_nothrow_constructible_v<Result<U, E>, std::invoke_result_t<F>>) {
-            if (is_ok()) return std::invoke(std::forward<F>(op), std::move(get<0>()));
-            return Result<U, E>();
+            if (is_ok()) return std::invoke(std::forward<F>(op));
+            return Result<U, E>(std::in_place_index<1>, std::move(m_data.template get<1>()));
         }
 
         template<typename U, typename F>
@@ -1489,13 +1867,16 @@ namespace C163q {
                  std::is_nothrow_constructible_v<Result<U, E>, std::in_place_index_t<1>, const E&> &&
                  std::is_nothrow_constructible_v<Result<U, E>, std::invoke_result_t<F>>) {
             if (is_ok()) return std::invoke(std::forward<F>(op));
-            return Result<U, E>(std::in_place_index<1>, get<1>());
+            return Result<U, E>(std::in_place_index<1>, m_data.template get<1>());
         }
 
         template<typename F>
-        [[nodiscard]] constexpr Result<void, F> or_else(Result<void, F> res) const
+        [[nodiscard]] constexpr Result<void, F> or_else(Result<void, F> res MY_INSTRUMENT_NEXT_PARAM) const
         noexcept(std::is_nothrow_move_constructible_v<Result<void, F>>) {
-            if (is_err()) return res;
+            if (is_err()) {
+                MY_INSTRUMENT(or_else);
+                return res;
+            }
             return Result<void, F>();
         }
 
@@ -1503,10 +1884,13 @@ namespace C163q {
             requires (requires (O f, E e) {
                 { std::invoke(f, std::move(e)) } -> std::convertible_to<Result<void, F>>;
             })
-        [[nodiscard]] constexpr Result<void, F> or_else(O&& op)
+        [[nodiscard]] constexpr Result<void, F> or_else(O&& op MY_INSTRUMENT_NEXT_PARAM)
         noexcept(std::is_nothrow_invocable_v<O, E&&> && std::is_nothrow_move_constructible_v<E> &&
                  std::is_nothrow_constructible_v<Result<void, E>, std::invoke_result_t<O, E&&>>) {
-            if (is_err()) return std::invoke(std::forward<O>(op), std::move(get<1>()));
+            if (is_err()) {
+                MY_INSTRUMENT(or_else);
+                return std::invoke(std::forward<O>(op), std::move(m_data.template get<1>()));
+            }
             return Result<void, F>();
         }
 
@@ -1514,10 +1898,13 @@ namespace C163q {
             requires (requires (O f, const E& e) {
                 { std::invoke(f, e) } -> std::convertible_to<Result<void, F>>;
             })
-        [[nodiscard]] constexpr Result<void, F> or_else(O&& op) const
+        [[nodiscard]] constexpr Result<void, F> or_else(O&& op MY_INSTRUMENT_NEXT_PARAM) const
         noexcept(std::is_nothrow_invocable_v<O, const E&> &&
                  std::is_nothrow_constructible_v<Result<void, F>, std::invoke_result_t<O, const E&>>) {
-            if (is_err()) return std::invoke(std::forward<O>(op), get<1>());
+            if (is_err()) {
+                MY_INSTRUMENT(or_else);
+                return std::invoke(std::forward<O>(op), m_data.template get<1>());
+            }
             return Result<void, F>();
         }
 
@@ -1530,10 +1917,11 @@ namespace C163q {
             requires requires (F f, E e) {
                 { std::invoke(f, std::move(e)) };
             }
-        constexpr void unwrap_or(F&& op)
+        constexpr void unwrap_or(F&& op MY_INSTRUMENT_NEXT_PARAM)
         noexcept(std::is_nothrow_invocable_v<F, E&&> && std::is_nothrow_move_constructible_v<E>) {
             if (is_ok()) return;
-            std::invoke(std::forward<F>(op), std::move(get<1>()));
+            MY_INSTRUMENT(unwrap_or);
+            std::invoke(std::forward<F>(op), std::move(m_data.template get<1>()));
             return;
         }
 
@@ -1541,10 +1929,11 @@ namespace C163q {
             requires requires (F f, const E& e) {
                 { std::invoke(f, e) };
             }
-        constexpr void unwrap_or(F&& op) const
+        constexpr void unwrap_or(F&& op MY_INSTRUMENT_NEXT_PARAM) const
         noexcept(std::is_nothrow_invocable_v<F, const E&>) {
             if (is_ok()) return;
-            std::invoke(std::forward<F>(op), get<1>());
+            MY_INSTRUMENT(unwrap_or);
+            std::invoke(std::forward<F>(op), m_data.template get<1>());
             return;
         }
 
@@ -1556,14 +1945,14 @@ namespace C163q {
         template<typename U, typename F>
         [[nodiscard]] Result<void, E>& assign(const Result<U, F>& other) {
             if (other.is_ok()) m_data.template emplace<0>();
-            else m_data.emplace<1>(other.template get<1>());
+            else m_data.template emplace<1>(other.template get_uncheck<1>());
             return *this;
         }
 
         template<typename U, typename F>
         [[nodiscard]] Result<void, E>& assign(Result<U, F>&& other) {
             if (other.is_ok()) m_data.template emplace<0>();
-            else m_data.emplace<1>(std::move(other.template get<1>()));
+            else m_data.template emplace<1>(std::move(other.template get_uncheck<1>()));
             return *this;
         }
 
@@ -1577,12 +1966,12 @@ namespace C163q {
 
         [[nodiscard]] constexpr as_cref_t as_ref() const noexcept {
             if (is_ok()) return as_cref_t();
-            return as_cref_t(std::in_place_index<1>, std::cref(get<1>()));
+            return as_cref_t(std::in_place_index<1>, std::cref(m_data.template get<1>()));
         }
 
         [[nodiscard]] constexpr as_ref_t as_ref() noexcept {
             if (is_ok()) return as_ref_t();
-            return as_ref_t(std::in_place_index<1>, std::ref(get<1>()));
+            return as_ref_t(std::in_place_index<1>, std::ref(m_data.template get<1>()));
         }
 
     private:
@@ -1591,28 +1980,27 @@ namespace C163q {
          */
         template<size_t I>
             requires (I == 0 || I == 1)
-        [[noreturn]] constexpr void call_panic_with_TE_uncheck(const std::string_view& msg, const std::string_view& sep) const {
+        MY_COLD [[noreturn]] constexpr void call_panic_with_TE_uncheck(const std::string_view& msg, const std::string_view& sep) const {
             using U = E;
-            if constexpr (
-#ifdef MY_CXX23
-                (std::formattable<U, char>)
-#else // C++23 ^^^ /  vvv C++20
-                (requires (std::formatter<U>& f, const std::formatter<U>& cf, U&& t,
-                    std::format_parse_context& p, std::format_context& fc) {
-                    { f.parse(p) };
-                    { cf.format(t, fc) };
-                })
-#endif
-            && I == 1) {
-                auto&& str = std::format("{}{}{}", msg, sep, get<I>());
-                panic(str);
+            if constexpr (panic_pass_by_value_v<U> && I == 1) {
+                call_panic_format_value_(msg, sep, m_data.template get<I>());
+            } else if constexpr (panic_formattable<U> && I == 1) {
+                call_panic_format_(msg, sep, &panic_format_value_<U>, std::addressof(m_data.template get<I>()));
             } else {
                 panic(msg);
             }
         }
 
+        template<typename Alloc, typename R>
+        static constexpr result_storage_t<void, E> storage_using_allocator(const Alloc& alloc, R&& other) {
+            using error_t = std::conditional_t<std::is_const_v<std::remove_reference_t<R>>, const E&, E&&>;
+            if (other.is_ok()) return result_storage_t<void, E>();
+            return result_storage_t<void, E>(std::in_place_index<1>, invoke_for_construct<E>(
+                        make_using_allocator<E>, alloc, static_cast<error_t>(other.template get_uncheck<1>())));
+        }
+
     private:
-        std::variant<std::monostate, E> m_data;
+        result_storage_t<void, E> m_data;
     };
 
 
@@ -1621,13 +2009,18 @@ namespace C163q {
     constexpr std::common_comparison_category_t<
         std::compare_three_way_result_t<T>, std::compare_three_way_result_t<E>>
         operator<=>(const Result<T, E>& lhs, const Result<T, E>& rhs) {
-        return lhs.data() <=> rhs.data();
+        // 与std::variant一致：先比较状态（Ok < Err），状态相同时再比较保有的值
+        if (lhs.is_ok() != rhs.is_ok()) return lhs.is_err() <=> rhs.is_err();
+        if (lhs.is_ok()) return lhs.template get_uncheck<0>() <=> rhs.template get_uncheck<0>();
+        return lhs.template get_uncheck<1>() <=> rhs.template get_uncheck<1>();
     }
 
     template<typename T, typename E>
         requires (std::equality_comparable<T> && std::equality_comparable<E>)
     constexpr bool operator==(const Result<T, E>& lhs, const Result<T, E>& rhs) {
-        return lhs.data() == rhs.data();
+        if (lhs.is_ok() != rhs.is_ok()) return false;
+        if (lhs.is_ok()) return lhs.template get_uncheck<0>() == rhs.template get_uncheck<0>();
+        return lhs.template get_uncheck<1>() == rhs.template get_uncheck<1>();
     }
 
     
@@ -1670,8 +2063,9 @@ namespace C163q {
      */
     template<typename E, typename T>
         requires std::move_constructible<result_transform_t<T>>
-    [[nodiscard]] constexpr Result<result_transform_t<T>, result_transform_t<E>> Ok(T&& value)
+    [[nodiscard]] constexpr Result<result_transform_t<T>, result_transform_t<E>> Ok(T&& value MY_INSTRUMENT_NEXT_PARAM)
         noexcept(std::is_nothrow_constructible_v<result_transform_t<T>, T>) {
+        MY_INSTRUMENT(ok);
         return Result<result_transform_t<T>, result_transform_t<E>>(std::in_place_index<0>, std::forward<T>(value));
     }
 
@@ -1696,12 +2090,56 @@ namespace C163q {
      * ```
      */
     template<typename E, typename T, typename ...Args>
-        requires std::constructible_from<result_transform_t<T>, Args...>
+        requires (std::constructible_from<result_transform_t<T>, Args...> && MY_INSTRUMENT_VARIADIC_ARITY(Args))
     [[nodiscard]] constexpr Result<result_transform_t<T>, result_transform_t<E>> Ok(Args&&... args)
         noexcept(std::is_nothrow_constructible_v<result_transform_t<T>, Args...>) {
         return Result<result_transform_t<T>, result_transform_t<E>>(std::in_place_index<0>, std::forward<Args>(args)...);
     }
 
+#ifdef MY_UTILS_INSTRUMENT
+    // 统计时参数包版本只接受4个以上的参数（见MY_INSTRUMENT_VARIADIC_ARITY），这里为0至4个参数分别提供重载。
+    // 可以转换为T&&的单个参数交给上面按值构造的重载，避免两者之间的歧义。
+    template<typename E, typename T>
+        requires std::constructible_from<result_transform_t<T>>
+    [[nodiscard]] constexpr Result<result_transform_t<T>, result_transform_t<E>> Ok(MY_INSTRUMENT_PARAM)
+        noexcept(std::is_nothrow_constructible_v<result_transform_t<T>>) {
+        MY_INSTRUMENT(ok);
+        return Result<result_transform_t<T>, result_transform_t<E>>(std::in_place_index<0>);
+    }
+
+    template<typename E, typename T, typename A0>
+        requires (std::constructible_from<result_transform_t<T>, A0> && !std::is_convertible_v<A0, T&&>)
+    [[nodiscard]] constexpr Result<result_transform_t<T>, result_transform_t<E>> Ok(A0&& a0 MY_INSTRUMENT_NEXT_PARAM)
+        noexcept(std::is_nothrow_constructible_v<result_transform_t<T>, A0>) {
+        MY_INSTRUMENT(ok);
+        return Result<result_transform_t<T>, result_transform_t<E>>(std::in_place_index<0>, std::forward<A0>(a0));
+    }
+
+    template<typename E, typename T, typename A0, typename A1>
+        requires std::constructible_from<result_transform_t<T>, A0, A1>
+    [[nodiscard]] constexpr Result<result_transform_t<T>, result_transform_t<E>> Ok(A0&& a0, A1&& a1 MY_INSTRUMENT_NEXT_PARAM)
+        noexcept(std::is_nothrow_constructible_v<result_transform_t<T>, A0, A1>) {
+        MY_INSTRUMENT(ok);
+        return Result<result_transform_t<T>, result_transform_t<E>>(std::in_place_index<0>, std::forward<A0>(a0), std::forward<A1>(a1));
+    }
+
+    template<typename E, typename T, typename A0, typename A1, typename A2>
+        requires std::constructible_from<result_transform_t<T>, A0, A1, A2>
+    [[nodiscard]] constexpr Result<result_transform_t<T>, result_transform_t<E>> Ok(A0&& a0, A1&& a1, A2&& a2 MY_INSTRUMENT_NEXT_PARAM)
+        noexcept(std::is_nothrow_constructible_v<result_transform_t<T>, A0, A1, A2>) {
+        MY_INSTRUMENT(ok);
+        return Result<result_transform_t<T>, result_transform_t<E>>(std::in_place_index<0>, std::forward<A0>(a0), std::forward<A1>(a1), std::forward<A2>(a2));
+    }
+
+    template<typename E, typename T, typename A0, typename A1, typename A2, typename A3>
+        requires std::constructible_from<result_transform_t<T>, A0, A1, A2, A3>
+    [[nodiscard]] constexpr Result<result_transform_t<T>, result_transform_t<E>> Ok(A0&& a0, A1&& a1, A2&& a2, A3&& a3 MY_INSTRUMENT_NEXT_PARAM)
+        noexcept(std::is_nothrow_constructible_v<result_transform_t<T>, A0, A1, A2, A3>) {
+        MY_INSTRUMENT(ok);
+        return Result<result_transform_t<T>, result_transform_t<E>>(std::in_place_index<0>, std::forward<A0>(a0), std::forward<A1>(a1), std::forward<A2>(a2), std::forward<A3>(a3));
+    }
+#endif // MY_UTILS_INSTRUMENT
+
     /**
      * @brief Result对象的工厂函数。
      *
@@ -1722,8 +2160,9 @@ namespace C163q {
      */
     template<typename T, typename E>
         requires std::move_constructible<result_transform_t<E>>
-    [[nodiscard]] constexpr Result<result_transform_t<T>, result_transform_t<E>> Err(E&& err)
+    [[nodiscard]] constexpr Result<result_transform_t<T>, result_transform_t<E>> Err(E&& err MY_INSTRUMENT_NEXT_PARAM)
         noexcept(std::is_nothrow_constructible_v<result_transform_t<E>, E>) {
+        MY_INSTRUMENT(err);
         return Result<result_transform_t<T>, result_transform_t<E>>(std::in_place_index<1>, std::forward<E>(err));
     }
 
@@ -1746,13 +2185,56 @@ namespace C163q {
      * ```
      */
     template<typename T, typename E, typename ...Args>
-        requires std::constructible_from<result_transform_t<E>, Args...>
+        requires (std::constructible_from<result_transform_t<E>, Args...> && MY_INSTRUMENT_VARIADIC_ARITY(Args))
     [[nodiscard]] constexpr Result<result_transform_t<T>, result_transform_t<E>> Err(Args&&... args)
         noexcept(std::is_nothrow_constructible_v<result_transform_t<E>, Args...>) {
         return Result<result_transform_t<T>, result_transform_t<E>>(
                 std::in_place_index<1>, std::forward<Args>(args)...);
     }
 
+#ifdef MY_UTILS_INSTRUMENT
+    // 与Ok()相同，为0至4个参数分别提供被统计的重载
+    template<typename T, typename E>
+        requires std::constructible_from<result_transform_t<E>>
+    [[nodiscard]] constexpr Result<result_transform_t<T>, result_transform_t<E>> Err(MY_INSTRUMENT_PARAM)
+        noexcept(std::is_nothrow_constructible_v<result_transform_t<E>>) {
+        MY_INSTRUMENT(err);
+        return Result<result_transform_t<T>, result_transform_t<E>>(std::in_place_index<1>);
+    }
+
+    template<typename T, typename E, typename A0>
+        requires (std::constructible_from<result_transform_t<E>, A0> && !std::is_convertible_v<A0, E&&>)
+    [[nodiscard]] constexpr Result<result_transform_t<T>, result_transform_t<E>> Err(A0&& a0 MY_INSTRUMENT_NEXT_PARAM)
+        noexcept(std::is_nothrow_constructible_v<result_transform_t<E>, A0>) {
+        MY_INSTRUMENT(err);
+        return Result<result_transform_t<T>, result_transform_t<E>>(std::in_place_index<1>, std::forward<A0>(a0));
+    }
+
+    template<typename T, typename E, typename A0, typename A1>
+        requires std::constructible_from<result_transform_t<E>, A0, A1>
+    [[nodiscard]] constexpr Result<result_transform_t<T>, result_transform_t<E>> Err(A0&& a0, A1&& a1 MY_INSTRUMENT_NEXT_PARAM)
+        noexcept(std::is_nothrow_constructible_v<result_transform_t<E>, A0, A1>) {
+        MY_INSTRUMENT(err);
+        return Result<result_transform_t<T>, result_transform_t<E>>(std::in_place_index<1>, std::forward<A0>(a0), std::forward<A1>(a1));
+    }
+
+    template<typename T, typename E, typename A0, typename A1, typename A2>
+        requires std::constructible_from<result_transform_t<E>, A0, A1, A2>
+    [[nodiscard]] constexpr Result<result_transform_t<T>, result_transform_t<E>> Err(A0&& a0, A1&& a1, A2&& a2 MY_INSTRUMENT_NEXT_PARAM)
+        noexcept(std::is_nothrow_constructible_v<result_transform_t<E>, A0, A1, A2>) {
+        MY_INSTRUMENT(err);
+        return Result<result_transform_t<T>, result_transform_t<E>>(std::in_place_index<1>, std::forward<A0>(a0), std::forward<A1>(a1), std::forward<A2>(a2));
+    }
+
+    template<typename T, typename E, typename A0, typename A1, typename A2, typename A3>
+        requires std::constructible_from<result_transform_t<E>, A0, A1, A2, A3>
+    [[nodiscard]] constexpr Result<result_transform_t<T>, result_transform_t<E>> Err(A0&& a0, A1&& a1, A2&& a2, A3&& a3 MY_INSTRUMENT_NEXT_PARAM)
+        noexcept(std::is_nothrow_constructible_v<result_transform_t<E>, A0, A1, A2, A3>) {
+        MY_INSTRUMENT(err);
+        return Result<result_transform_t<T>, result_transform_t<E>>(std::in_place_index<1>, std::forward<A0>(a0), std::forward<A1>(a1), std::forward<A2>(a2), std::forward<A3>(a3));
+    }
+#endif // MY_UTILS_INSTRUMENT
+
     /**
      * @brief 代理调用函数，正常返回值或捕获异常值都会存储在Result中。
      *
@@ -1782,37 +2264,163 @@ namespace C163q {
                   std::reference_wrapper<std::remove_reference_t<Ret_t<F, Args...>>>,
                   std::remove_reference_t<Ret_t<F, Args...>>>;
 
+        /**
+         * @brief 调用f并将返回值作为Ok值构造Result，f返回void时构造Result<void, E>
+         */
+        template<typename R, typename F, typename ...Args>
+        static constexpr R invoke_ok(F&& f, Args&&... args)
+            noexcept(std::is_nothrow_invocable_v<F, Args...> &&
+                    (std::is_void_v<Ret_t<F, Args...>> ||
+                     std::is_nothrow_constructible_v<R, std::in_place_index_t<0>, Ret_t<F, Args...>>)) {
+            if constexpr (std::is_void_v<Ret_t<F, Args...>>) {
+                ::std::invoke(std::forward<F>(f), std::forward<Args>(args)...);
+                return R(std::in_place_index<0>);
+            } else {
+                return R(std::in_place_index<0>, invoke_for_construct<typename R::value_type>(
+                            std::forward<F>(f), std::forward<Args>(args)...));
+            }
+        }
+
+        /**
+         * @brief f调用以及Ok值的构造都不会抛出异常时为true，此时不需要try/catch
+         */
+        template<typename F, typename ...Args>
+        static constexpr bool is_nothrow_v = noexcept(invoke_ok<Result<T<F, Args...>, E>>(
+                    std::declval<F>(), std::declval<Args>()...));
+
         template<typename F, typename ...Args>
             requires std::invocable<F, Args...>
-        static Result<T<F, Args...>, E> invoke(F&& f, Args&&... args) {
+        static constexpr Result<T<F, Args...>, E> invoke(F&& f, Args&&... args)
+            noexcept(is_nothrow_v<F, Args...>) {
             using Type = T<F, Args...>;
-            try {
-                return Result<Type, E>(std::in_place_index<0>,
-                        ::std::invoke(std::forward<F>(f), std::forward<Args>(args)...));
-            } catch (E& e) {
-                return Result<Type, E>(std::in_place_index<1>, std::move(e));
+            if constexpr (is_nothrow_v<F, Args...>) {
+                // 不会抛出异常，直接构造Ok值，不会产生异常处理代码
+                return invoke_ok<Result<Type, E>>(std::forward<F>(f), std::forward<Args>(args)...);
+            } else {
+                try {
+                    return invoke_ok<Result<Type, E>>(std::forward<F>(f), std::forward<Args>(args)...);
+                } catch (E& e) {
+                    return Result<Type, E>(std::in_place_index<1>, std::move(e));
+                }
             }
         }
 
         template<typename F, typename ...Args>
             requires std::invocable<F, Args...>
-        static Result<T<F, Args...>, E> invoke_else_panic(F&& f, Args&&... args) {
+        static constexpr Result<T<F, Args...>, E> invoke_else_panic(F&& f, Args&&... args)
+            noexcept(is_nothrow_v<F, Args...>) {
             using Type = T<F, Args...>;
+            if constexpr (is_nothrow_v<F, Args...>) {
+                return invoke_ok<Result<Type, E>>(std::forward<F>(f), std::forward<Args>(args)...);
+            } else {
+                try {
+                    return invoke_ok<Result<Type, E>>(std::forward<F>(f), std::forward<Args>(args)...);
+                } catch (E& e) {
+                    return Result<Type, E>(std::in_place_index<1>, std::move(e));
+                } catch (const panic_error&) {
+                    throw;
+                } catch (...) {
+                    panic("panics after call `result_helper::invoke_else_panic`");
+                }
+            }
+        }
+    };
+
+    /**
+     * @brief 代理调用函数，捕获任意异常并以std::exception_ptr的形式存储在Result中。
+     *
+     * 异常只会被捕获一次，之后只需要移动std::exception_ptr（一个引用计数的指针），
+     * 适合将工作线程中抛出的异常传递到其他线程，在需要时再使用std::rethrow_exception重新抛出。
+     * f不会抛出异常时与result_helper::invoke相同，不会产生异常处理代码。
+     * panic_strategy::unwind下抛出的panic_error不会被捕获。
+     *
+     * @example
+     * ```
+     * auto r = C163q::try_invoke([] { return std::stoi("foo"); });
+     * assert(r.is_err());
+     * try {
+     *     std::rethrow_exception(r.unwrap_err());
+     * } catch (const std::invalid_argument&) {}
+     * ```
+     */
+    template<typename F, typename ...Args>
+        requires std::invocable<F, Args...>
+    [[nodiscard]] constexpr auto try_invoke(F&& f, Args&&... args)
+        noexcept(result_helper<std::exception_ptr>::is_nothrow_v<F, Args...>) {
+        using helper = result_helper<std::exception_ptr>;
+        using R = Result<helper::T<F, Args...>, std::exception_ptr>;
+        if constexpr (helper::is_nothrow_v<F, Args...>) {
+            return helper::invoke_ok<R>(std::forward<F>(f), std::forward<Args>(args)...);
+        } else {
             try {
-                return Result<Type, E>(std::in_place_index<0>,
-                        ::std::invoke(std::forward<F>(f), std::forward<Args>(args)...));
-            } catch (E& e) {
-                return Result<Type, E>(std::in_place_index<1>, std::move(e));
+                return helper::invoke_ok<R>(std::forward<F>(f), std::forward<Args>(args)...);
+            } catch (const panic_error&) {
+                // panic不是普通的错误，需要继续展开到任务的边界
+                throw;
             } catch (...) {
-                panic("panics after call `result_helper::invoke_else_panic`");
+                return R(std::in_place_index<1>, std::current_exception());
             }
         }
-    };
+    }
+
+
+    template<typename R>
+    struct is_result : std::false_type {};
 
+    template<typename T, typename E>
+    struct is_result<Result<T, E>> : std::true_type {};
+
+    template<typename R>
+    inline constexpr bool is_result_v = is_result<R>::value;
+
+    /**
+     * @brief 对Result进行match，Ok时以Ok值调用on_ok，Err时以Err值调用on_err。
+     *
+     * 与rust中`match result { Ok(v) => ..., Err(e) => ... }`相同，按位置而不是按类型匹配，
+     * 因此T与E相同时也可以使用。保有的值按照result的值类别被完美转发，
+     * Result<void, E>为Ok时on_ok不接受参数。
+     *
+     * @example
+     * ```cpp
+     * auto r = C163q::Ok<int>(std::string("hello"));
+     * std::string s = C163q::match(std::move(r),
+     *         [] (std::string&& s) { return std::move(s); },   // 移动而不是复制
+     *         [] (int e) { return std::to_string(e); });
+     * assert(s == "hello");
+     * ```
+     */
+    template<typename R, typename FOk, typename FErr>
+        requires is_result_v<std::remove_cvref_t<R>>
+    constexpr decltype(auto) match(R&& result, FOk&& on_ok, FErr&& on_err) {
+        using T = std::remove_cvref_t<R>::value_type;
+        constexpr bool is_lvalue = std::is_lvalue_reference_v<R>;
+        auto&& err = [&]() -> decltype(auto) {
+            if constexpr (is_lvalue) return result.template get_uncheck<1>();
+            else return std::move(result.template get_uncheck<1>());
+        };
+        if constexpr (std::is_void_v<T>) {
+            using Ret = std::invoke_result_t<FOk>;
+            if (result.is_ok()) return static_cast<Ret>(std::invoke(std::forward<FOk>(on_ok)));
+            return static_cast<Ret>(std::invoke(std::forward<FErr>(on_err), err()));
+        } else {
+            auto&& ok = [&]() -> decltype(auto) {
+                if constexpr (is_lvalue) return result.template get_uncheck<0>();
+                else return std::move(result.template get_uncheck<0>());
+            };
+            using Ret = std::invoke_result_t<FOk, decltype(ok())>;
+            if (result.is_ok()) return static_cast<Ret>(std::invoke(std::forward<FOk>(on_ok), ok()));
+            return static_cast<Ret>(std::invoke(std::forward<FErr>(on_err), err()));
+        }
+    }
 }
 
 namespace std {
 
+    // T或E使用Alloc时，Result<T, E>提供带std::allocator_arg_t的构造函数，从而可以被容器以uses-allocator方式构造
+    template<typename T, typename E, typename Alloc>
+    struct uses_allocator<C163q::Result<T, E>, Alloc>
+        : bool_constant<uses_allocator_v<T, Alloc> || uses_allocator_v<E, Alloc>> {};
+
     /**
      * @brief 访问Result内所保有元素
      *
@@ -1,7 +1,10 @@
 /*!
- * @file rs/result.hpp
+ * @file rs/result23.hpp
  * @brief 在C++中实现rust当中的Result类
  *
+ * C++23下Result默认使用std::expected<T, E>存储（见rs/result_storage.hpp），
+ * API与result20.hpp完全相同，此外还提供与std::expected之间的相互转换。
+ *
  * 至少需要C++23
  *
  * @since Aug 4, 2025
@@ -15,9 +18,50 @@
     static_assert(false, "Require C++23!");
 #else
 
-// TODO: 实现使用std::expect的Result
-
+#include<expected>
+#include<type_traits>
+#include<utility>
 #include"result20.hpp"
 
+namespace C163q {
+
+    /**
+     * @brief 将std::expected<T, E>转换为Result<T, E>，保有的值会被移动。
+     *
+     * @example
+     * ```cpp
+     * std::expected<int, const char*> e(1);
+     * assert(C163q::from_expected(std::move(e)).unwrap() == 1);
+     * ```
+     */
+    template<typename T, typename E>
+    [[nodiscard]] constexpr Result<T, E> from_expected(std::expected<T, E> value)
+        noexcept(std::is_nothrow_move_constructible_v<E> &&
+                (std::is_void_v<T> || std::is_nothrow_move_constructible_v<T>)) {
+        if (!value.has_value()) return Result<T, E>(std::in_place_index<1>, std::move(value.error()));
+        if constexpr (std::is_void_v<T>) return Result<T, E>(std::in_place_index<0>);
+        else return Result<T, E>(std::in_place_index<0>, std::move(*value));
+    }
+
+    /**
+     * @brief 将Result<T, E>转换为std::expected<T, E>，保有的值会被移动。
+     *
+     * @example
+     * ```cpp
+     * auto x = C163q::Err<int>("error");
+     * assert(C163q::to_expected(std::move(x)).error() == std::string_view("error"));
+     * ```
+     */
+    template<typename T, typename E>
+    [[nodiscard]] constexpr std::expected<T, E> to_expected(Result<T, E> value)
+        noexcept(std::is_nothrow_move_constructible_v<E> &&
+                (std::is_void_v<T> || std::is_nothrow_move_constructible_v<T>)) {
+        if (value.is_err()) return std::expected<T, E>(std::unexpect, std::move(value.template get<1>()));
+        if constexpr (std::is_void_v<T>) return std::expected<T, E>();
+        else return std::expected<T, E>(std::in_place, std::move(value.template get<0>()));
+    }
+
+}
+
 #endif // MY_CXX23
 #endif // C163Q_MY_CPP_UTILS_RS_RESULT23_HPP
@@ -0,0 +1,335 @@
+/*!
+ * @file rs/result_storage.hpp
+ * @brief Result的底层存储
+ *
+ * Result只关心自身处于Ok还是Err状态以及如何访问保有的值，
+ * 具体的存储方式由这里的存储类型决定：
+ * - C++20下默认使用std::variant<T, E>；
+ * - C++23下默认使用std::expected<T, E>（定义MY_RESULT_VARIANT_STORAGE可以强制使用std::variant，
+ *   该宏必须在整个程序中保持一致）；
+ * - 若result_niche_traits<T, E>::enable为true，则使用其提供的紧凑存储（见rs/niche.hpp）。
+ *
+ * 所有存储类型都提供相同的接口：index()、get<I>()、emplace<I>(args...)以及按值返回std::variant的to_variant()，
+ * 其中get<I>()不进行检查，由Result负责保证访问的正确性。
+ * 只有result_variant_storage另外提供返回常引用的variant()，Result::data()只在使用该存储时可用。
+ *
+ * 至少需要C++20
+ *
+ * @since Oct 14, 2026
+ */
+
+#ifndef C163Q_MY_CPP_UTILS_RS_RESULT_STORAGE_HPP
+#define C163Q_MY_CPP_UTILS_RS_RESULT_STORAGE_HPP
+
+#include"../core/config.hpp"
+#ifndef MY_CXX20
+    static_assert(false, "Require C++20!");
+#else
+
+#include<cstddef>
+#include<memory>
+#include<type_traits>
+#include<utility>
+#include<variant>
+#include"niche.hpp"
+#ifdef MY_CXX23
+#include<expected>
+#endif // MY_CXX23
+
+namespace C163q {
+
+    /**
+     * @brief 使用std::variant<T, E>的存储，T为void时使用std::monostate代替。
+     */
+    template<typename T, typename E>
+    class result_variant_storage {
+    public:
+        using ok_type = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+        using variant_type = std::variant<ok_type, E>;
+
+        template<size_t I>
+        using alternative_t = std::variant_alternative_t<I, variant_type>;
+
+    public:
+        constexpr result_variant_storage() noexcept(std::is_nothrow_default_constructible_v<ok_type>)
+            : m_data() {}
+
+        template<size_t I, typename ...Args>
+        constexpr explicit result_variant_storage(std::in_place_index_t<I>, Args&&... args)
+            noexcept(std::is_nothrow_constructible_v<alternative_t<I>, Args...>)
+            : m_data(std::in_place_index<I>, std::forward<Args>(args)...) {}
+
+        [[nodiscard]] constexpr size_t index() const noexcept {
+            return m_data.index();
+        }
+
+        // 调用者保证index() == I，告知编译器之后std::get_if不再需要检查空指针
+        template<size_t I>
+        [[nodiscard]] constexpr alternative_t<I>& get() noexcept {
+            MY_ASSUME(m_data.index() == I);
+            return *std::get_if<I>(&m_data);
+        }
+
+        template<size_t I>
+        [[nodiscard]] constexpr const alternative_t<I>& get() const noexcept {
+            MY_ASSUME(m_data.index() == I);
+            return *std::get_if<I>(&m_data);
+        }
+
+        template<size_t I, typename ...Args>
+        constexpr void emplace(Args&&... args) {
+            m_data.template emplace<I>(std::forward<Args>(args)...);
+        }
+
+        [[nodiscard]] constexpr const variant_type& variant() const noexcept {
+            return m_data;
+        }
+
+        [[nodiscard]] constexpr variant_type to_variant() const {
+            return m_data;
+        }
+
+    private:
+        variant_type m_data;
+    };
+
+#ifdef MY_CXX23
+    /**
+     * @brief 使用std::expected<T, E>的存储
+     *
+     * 当T与E都是平凡可复制的时候，std::expected<T, E>也是平凡可复制的，
+     * 且不存在std::variant的valueless_by_exception状态，访问时也不需要经过std::visit/std::get。
+     */
+    template<typename T, typename E>
+    class result_expected_storage {
+    public:
+        using ok_type = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+        using variant_type = std::variant<ok_type, E>;
+        using expected_type = std::expected<T, E>;
+
+        template<size_t I>
+        using alternative_t = std::variant_alternative_t<I, variant_type>;
+
+    private:
+        template<size_t I>
+        static constexpr auto tag = [] {
+            if constexpr (I == 0) return std::in_place;
+            else return std::unexpect;
+        }();
+
+    public:
+        constexpr result_expected_storage() noexcept(std::is_nothrow_default_constructible_v<expected_type>)
+            : m_data() {}
+
+        template<size_t I, typename ...Args>
+        constexpr explicit result_expected_storage(std::in_place_index_t<I>, Args&&... args)
+            noexcept(std::is_nothrow_constructible_v<expected_type, decltype(tag<I>), Args...>)
+            : m_data(tag<I>, std::forward<Args>(args)...) {}
+
+        [[nodiscard]] constexpr size_t index() const noexcept {
+            return !m_data.has_value();
+        }
+
+        template<size_t I>
+            requires (I == 1 || !std::is_void_v<T>)
+        [[nodiscard]] constexpr alternative_t<I>& get() noexcept {
+            if constexpr (I == 0) return *m_data;
+            else return m_data.error();
+        }
+
+        template<size_t I>
+            requires (I == 1 || !std::is_void_v<T>)
+        [[nodiscard]] constexpr const alternative_t<I>& get() const noexcept {
+            if constexpr (I == 0) return *m_data;
+            else return m_data.error();
+        }
+
+        template<size_t I, typename ...Args>
+        constexpr void emplace(Args&&... args) {
+            if constexpr (std::is_nothrow_constructible_v<expected_type, decltype(tag<I>), Args...>) {
+                // 构造不会抛出异常时直接原地重建，避免经过std::expected的赋值运算符
+                std::destroy_at(std::addressof(m_data));
+                std::construct_at(std::addressof(m_data), tag<I>, std::forward<Args>(args)...);
+            } else {
+                m_data = expected_type(tag<I>, std::forward<Args>(args)...);
+            }
+        }
+
+        /**
+         * @brief 按值返回std::variant形式的数据
+         */
+        [[nodiscard]] constexpr variant_type to_variant() const {
+            if constexpr (std::is_void_v<T>) {
+                if (index() == 0) return variant_type(std::in_place_index<0>);
+            } else {
+                if (index() == 0) return variant_type(std::in_place_index<0>, get<0>());
+            }
+            return variant_type(std::in_place_index<1>, get<1>());
+        }
+
+    private:
+        expected_type m_data;
+    };
+
+    /**
+     * @brief T与E都是平凡可复制时的特化
+     *
+     * std::expected的复制/移动赋值运算符不是平凡的，因此std::expected<int, int>并不是平凡可复制的。
+     * 这里使用与std::expected相同的布局（联合体加上一个状态标记），但所有的特殊成员函数都是平凡的，
+     * 从而使Result<T, E>可以通过寄存器传递、被memcpy以及用于std::atomic。
+     */
+    template<typename T, typename E>
+        requires (std::is_trivially_copyable_v<std::conditional_t<std::is_void_v<T>, std::monostate, T>> &&
+                  std::is_trivially_copyable_v<E> && std::is_trivially_destructible_v<E> &&
+                  std::is_trivially_destructible_v<std::conditional_t<std::is_void_v<T>, std::monostate, T>>)
+    class result_expected_storage<T, E> {
+    public:
+        using ok_type = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+        using variant_type = std::variant<ok_type, E>;
+
+        template<size_t I>
+        using alternative_t = std::variant_alternative_t<I, variant_type>;
+
+    public:
+        constexpr result_expected_storage() noexcept(std::is_nothrow_default_constructible_v<ok_type>)
+            : m_ok(), m_is_err(false) {}
+
+        template<typename ...Args>
+        constexpr explicit result_expected_storage(std::in_place_index_t<0>, Args&&... args)
+            noexcept(std::is_nothrow_constructible_v<ok_type, Args...>)
+            : m_ok(std::forward<Args>(args)...), m_is_err(false) {}
+
+        template<typename ...Args>
+        constexpr explicit result_expected_storage(std::in_place_index_t<1>, Args&&... args)
+            noexcept(std::is_nothrow_constructible_v<E, Args...>)
+            : m_err(std::forward<Args>(args)...), m_is_err(true) {}
+
+        [[nodiscard]] constexpr size_t index() const noexcept {
+            return m_is_err;
+        }
+
+        template<size_t I>
+        [[nodiscard]] constexpr alternative_t<I>& get() noexcept {
+            if constexpr (I == 0) return m_ok;
+            else return m_err;
+        }
+
+        template<size_t I>
+        [[nodiscard]] constexpr const alternative_t<I>& get() const noexcept {
+            if constexpr (I == 0) return m_ok;
+            else return m_err;
+        }
+
+        template<size_t I, typename ...Args>
+        constexpr void emplace(Args&&... args) {
+            // 两者都是平凡可析构的，因此无需销毁旧值
+            if constexpr (I == 0) std::construct_at(std::addressof(m_ok), std::forward<Args>(args)...);
+            else std::construct_at(std::addressof(m_err), std::forward<Args>(args)...);
+            m_is_err = I;
+        }
+
+        [[nodiscard]] constexpr variant_type to_variant() const {
+            if (index() == 0) return variant_type(std::in_place_index<0>, m_ok);
+            return variant_type(std::in_place_index<1>, m_err);
+        }
+
+    private:
+        union {
+            ok_type m_ok;
+            E m_err;
+        };
+        bool m_is_err;
+    };
+#endif // MY_CXX23
+
+    /**
+     * @brief 使用result_niche_traits<T, E>的紧凑存储
+     */
+    template<typename T, typename E>
+    class result_niche_storage {
+    private:
+        using traits = result_niche_traits<T, E>;
+        using storage_type = typename traits::storage_type;
+
+    public:
+        using ok_type = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+        using variant_type = std::variant<ok_type, E>;
+
+        template<size_t I>
+        using alternative_t = std::variant_alternative_t<I, variant_type>;
+
+    public:
+        // traits::default_ok为false时，默认构造的T并不表示Ok状态
+        constexpr result_niche_storage() requires (!requires { traits::default_ok; } || traits::default_ok)
+            : m_data() {
+            traits::emplace_ok(m_data);
+        }
+
+        template<size_t I, typename ...Args>
+        constexpr explicit result_niche_storage(std::in_place_index_t<I>, Args&&... args) : m_data() {
+            emplace<I>(std::forward<Args>(args)...);
+        }
+
+        [[nodiscard]] constexpr size_t index() const noexcept {
+            return !traits::is_ok(m_data);
+        }
+
+        template<size_t I>
+            requires (I == 1 || !std::is_void_v<T>)
+        [[nodiscard]] constexpr alternative_t<I>& get() noexcept {
+            if constexpr (I == 0) return traits::get_ok(m_data);
+            else return traits::get_err(m_data);
+        }
+
+        template<size_t I>
+            requires (I == 1 || !std::is_void_v<T>)
+        [[nodiscard]] constexpr const alternative_t<I>& get() const noexcept {
+            if constexpr (I == 0) return traits::get_ok(m_data);
+            else return traits::get_err(m_data);
+        }
+
+        template<size_t I, typename ...Args>
+        constexpr void emplace(Args&&... args) {
+            if constexpr (I == 0) {
+                if constexpr (std::is_void_v<T>) traits::emplace_ok(m_data);
+                else traits::emplace_ok(m_data, std::forward<Args>(args)...);
+            } else {
+                traits::emplace_err(m_data, std::forward<Args>(args)...);
+            }
+        }
+
+        /**
+         * @brief 紧凑存储中并不存在std::variant，因此按值返回
+         */
+        [[nodiscard]] constexpr variant_type to_variant() const {
+            if constexpr (std::is_void_v<T>) {
+                if (index() == 0) return variant_type(std::in_place_index<0>);
+            } else {
+                if (index() == 0) return variant_type(std::in_place_index<0>, get<0>());
+            }
+            return variant_type(std::in_place_index<1>, get<1>());
+        }
+
+    private:
+        storage_type m_data;
+    };
+
+#if defined(MY_CXX23) && !defined(MY_RESULT_VARIANT_STORAGE)
+    template<typename T, typename E>
+    using result_default_storage_t = result_expected_storage<T, E>;
+#else
+    template<typename T, typename E>
+    using result_default_storage_t = result_variant_storage<T, E>;
+#endif
+
+    /**
+     * @brief 选择Result<T, E>所使用的存储类型
+     */
+    template<typename T, typename E>
+    using result_storage_t = std::conditional_t<result_niche_traits<T, E>::enable,
+          result_niche_storage<T, E>, result_default_storage_t<T, E>>;
+
+}
+
+#endif // MY_CXX20
+#endif // !C163Q_MY_CPP_UTILS_RS_RESULT_STORAGE_HPP
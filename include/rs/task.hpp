@@ -0,0 +1,647 @@
+/*!
+ * @file rs/task.hpp
+ * @brief 惰性启动的协程task<T>，以及sync_wait与when_all
+ *
+ * task<T>在被co_await（或者sync_wait）之前不会开始运行，结束时通过对称转移恢复等待它的协程。
+ * 搭配thread_pool（见rs/thread_pool.hpp）使用时，co_await pool.schedule()之后的代码在线程池中运行。
+ *
+ * task<Result<T, E>>中co_await一个Result时与rs/coroutine.hpp中的Result协程相同：若为Err则立即以该Err作为
+ * task的结果，恢复等待者。此时task的协程帧停留在该co_await处，其中的局部变量在task对象析构时销毁。
+ *
+ * 任务边界：task中未捕获的异常（包括panic_strategy::unwind时panic抛出的panic_error）被保存下来，
+ * 在co_await该task处重新抛出，不会影响运行它的工作线程以及其他任务。
+ *
+ * 取消是协作式的：每个task持有一个std::stop_token，通过co_await C163q::current_stop_token()获得，
+ * co_await子task时子task继承该令牌。when_all中任意一个子任务为Err时，请求其他子任务停止，
+ * 尚未开始运行的子任务不再运行。
+ *
+ * 至少需要C++20
+ *
+ * @since Oct 14, 2026
+ *
+ * @example
+ * ```cpp
+ * C163q::thread_pool pool;
+ *
+ * C163q::task<C163q::Result<int, std::string>> load(int id) {
+ *     std::stop_token stop = co_await C163q::current_stop_token();
+ *     if (stop.stop_requested()) co_return C163q::Err<int>(std::string("cancelled"));
+ *     int x = co_await fetch(id);         // fetch返回Result<int, std::string>，为Err时load直接返回该Err
+ *     co_return x * 2;
+ * }
+ *
+ * C163q::task<C163q::Result<int, std::string>> total() {
+ *     co_await pool.schedule();
+ *     auto [a, b] = co_await co_await C163q::when_all(load(1), load(2));
+ *     co_return a + b;
+ * }
+ *
+ * auto r = C163q::sync_wait(total());
+ * ```
+ */
+
+#ifndef C163Q_MY_CPP_UTILS_RS_TASK_HPP
+#define C163Q_MY_CPP_UTILS_RS_TASK_HPP
+
+#include"../core/config.hpp"
+#ifndef MY_CXX20
+    static_assert(false, "Require C++20!");
+#else
+
+#include<array>
+#include<atomic>
+#include<concepts>
+#include<condition_variable>
+#include<coroutine>
+#include<cstddef>
+#include<exception>
+#include<mutex>
+#include<optional>
+#include<stop_token>
+#include<tuple>
+#include<type_traits>
+#include<utility>
+#include<variant>
+#include"coroutine.hpp"
+#include"result.hpp"
+#include"thread_pool.hpp"
+
+namespace C163q {
+
+    template<typename T = void>
+    class task;
+
+    namespace detail {
+
+        struct stop_token_request {};
+
+        template<typename T>
+        struct is_result_type : std::false_type {};
+
+        template<typename T, typename E>
+        struct is_result_type<Result<T, E>> : std::true_type {};
+
+        // task<T>中co_await R时可以像?运算符一样提前返回：T与R都是Result，并且R的Err值可以构造T的Err值
+        template<typename T, typename R>
+        concept task_short_circuit = is_result_type<T>::value && is_result_type<std::remove_cvref_t<R>>::value
+            && std::constructible_from<typename T::error_type,
+                    std::conditional_t<std::is_lvalue_reference_v<R>,
+                        decltype(std::declval<R>().template get_uncheck<1>()),
+                        typename std::remove_cvref_t<R>::error_type&&>>;
+
+        // 保存task的结果
+        template<typename T>
+        class task_value {
+        public:
+            template<typename U = T>
+                requires std::constructible_from<T, U>
+            void return_value(U&& value) {
+                m_value.emplace(std::forward<U>(value));
+            }
+
+        protected:
+            std::optional<T> m_value;
+        };
+
+        template<typename T, typename E>
+        class task_value<Result<T, E>> {
+        public:
+            void return_value(Result<T, E> result) {
+                m_value.emplace(std::move(result));
+            }
+
+            template<typename U = T>
+                requires (std::constructible_from<T, U> && !std::is_same_v<std::remove_cvref_t<U>, Result<T, E>>)
+            void return_value(U&& value) {
+                m_value.emplace(std::in_place_index<0>, std::forward<U>(value));
+            }
+
+        protected:
+            std::optional<Result<T, E>> m_value;
+        };
+
+        template<typename E>
+        class task_value<Result<void, E>> {
+        public:
+            void return_void() {
+                m_value.emplace();
+            }
+
+        protected:
+            std::optional<Result<void, E>> m_value;
+        };
+
+        template<>
+        class task_value<void> {
+        public:
+            void return_void() noexcept {}
+        };
+
+
+        // co_await current_stop_token()
+        class stop_token_awaiter {
+        public:
+            explicit stop_token_awaiter(std::stop_token token) noexcept : m_token(std::move(token)) {}
+
+            [[nodiscard]] bool await_ready() const noexcept { return true; }
+            void await_suspend(std::coroutine_handle<>) const noexcept {}
+            [[nodiscard]] std::stop_token await_resume() noexcept { return std::move(m_token); }
+
+        private:
+            std::stop_token m_token;
+        };
+
+
+        template<typename T>
+        class task_promise : public frame_allocation, public task_value<T> {
+        public:
+            class final_awaiter {
+            public:
+                [[nodiscard]] bool await_ready() const noexcept { return false; }
+
+                [[nodiscard]] std::coroutine_handle<> await_suspend(std::coroutine_handle<task_promise> handle) noexcept {
+                    return handle.promise().m_continuation;
+                }
+
+                void await_resume() const noexcept {}
+            };
+
+            // co_await Result时使用的awaiter，为Err时写入task的结果并恢复等待者
+            template<typename R>
+            class result_awaiter {
+                using result_type = std::remove_cvref_t<R>;
+                using value_type = typename result_type::value_type;
+
+            public:
+                explicit result_awaiter(R&& result) noexcept : m_result(std::forward<R>(result)) {}
+
+                [[nodiscard]] bool await_ready() const noexcept {
+                    return m_result.is_ok();
+                }
+
+                [[nodiscard]] std::coroutine_handle<> await_suspend(std::coroutine_handle<task_promise> handle) {
+                    task_promise& promise = handle.promise();
+                    if constexpr (std::is_lvalue_reference_v<R>) {
+                        promise.m_value.emplace(std::in_place_index<1>, m_result.template get_uncheck<1>());
+                    } else {
+                        promise.m_value.emplace(std::in_place_index<1>, std::move(m_result.template get_uncheck<1>()));
+                    }
+                    return promise.m_continuation;
+                }
+
+                decltype(auto) await_resume() {
+                    if constexpr (std::is_void_v<value_type>) {
+                        return;
+                    } else if constexpr (std::is_lvalue_reference_v<R>) {
+                        return m_result.template get_uncheck<0>();
+                    } else {
+                        return value_type(std::move(m_result.template get_uncheck<0>()));
+                    }
+                }
+
+            private:
+                R&& m_result;
+            };
+
+            [[nodiscard]] task<T> get_return_object() noexcept;
+
+            [[nodiscard]] std::suspend_always initial_suspend() const noexcept { return {}; }
+            [[nodiscard]] final_awaiter final_suspend() const noexcept { return {}; }
+
+            void unhandled_exception() noexcept {
+                m_exception = std::current_exception();
+            }
+
+            template<typename A>
+            [[nodiscard]] A&& await_transform(A&& awaitable) noexcept {
+                return std::forward<A>(awaitable);
+            }
+
+            [[nodiscard]] stop_token_awaiter await_transform(stop_token_request) noexcept {
+                return stop_token_awaiter(m_stop);
+            }
+
+            // 子task继承停止令牌
+            template<typename U>
+            [[nodiscard]] auto await_transform(task<U>&& child) noexcept {
+                child.set_stop_token(m_stop);
+                return std::move(child).operator co_await();
+            }
+
+            template<typename R>
+                requires task_short_circuit<T, R>
+            [[nodiscard]] result_awaiter<R> await_transform(R&& result) noexcept {
+                return result_awaiter<R>(std::forward<R>(result));
+            }
+
+            void set_continuation(std::coroutine_handle<> continuation) noexcept {
+                m_continuation = continuation;
+            }
+
+            void set_stop_token(std::stop_token token) noexcept {
+                m_stop = std::move(token);
+            }
+
+            // 重新抛出任务中的异常，或者取出结果
+            T result() {
+                if (m_exception) std::rethrow_exception(m_exception);
+                if constexpr (!std::is_void_v<T>) return std::move(*this->m_value);
+            }
+
+        private:
+            std::coroutine_handle<> m_continuation = std::noop_coroutine();
+            std::exception_ptr m_exception;
+            std::stop_token m_stop;
+        };
+
+    }
+
+
+    /**
+     * @brief co_await得到当前task的停止令牌
+     *
+     * task没有被when_all启动（并且也没有从这样的task继承令牌）时，得到的令牌永远不会被请求停止。
+     */
+    [[nodiscard]] constexpr detail::stop_token_request current_stop_token() noexcept {
+        return {};
+    }
+
+
+    /**
+     * @brief 惰性启动的协程，只能被co_await一次（右值）
+     *
+     * 协程帧的分配与Result协程相同（见rs/coroutine.hpp）。task对象析构时销毁协程帧，
+     * 因此必须在task完成（或者因Err提前返回）之后才能析构。
+     *
+     * @tparam T co_await该task得到的值的类型
+     */
+    template<typename T>
+    class [[nodiscard]] task {
+    public:
+        using promise_type = detail::task_promise<T>;
+        using value_type = T;
+
+        class awaiter {
+        public:
+            explicit awaiter(std::coroutine_handle<promise_type> handle) noexcept : m_handle(handle) {}
+
+            [[nodiscard]] bool await_ready() const noexcept { return false; }
+
+            [[nodiscard]] std::coroutine_handle<> await_suspend(std::coroutine_handle<> continuation) noexcept {
+                m_handle.promise().set_continuation(continuation);
+                return m_handle;
+            }
+
+            T await_resume() {
+                return m_handle.promise().result();
+            }
+
+        private:
+            std::coroutine_handle<promise_type> m_handle;
+        };
+
+        task(task&& other) noexcept : m_handle(std::exchange(other.m_handle, nullptr)) {}
+
+        task& operator=(task&& other) noexcept {
+            if (this != &other) {
+                if (m_handle) m_handle.destroy();
+                m_handle = std::exchange(other.m_handle, nullptr);
+            }
+            return *this;
+        }
+
+        ~task() {
+            if (m_handle) m_handle.destroy();
+        }
+
+        [[nodiscard]] awaiter operator co_await() && noexcept {
+            return awaiter(m_handle);
+        }
+
+        /**
+         * @brief 在task开始运行之前设置其停止令牌
+         */
+        void set_stop_token(std::stop_token token) noexcept {
+            m_handle.promise().set_stop_token(std::move(token));
+        }
+
+    private:
+        friend promise_type;
+
+        explicit task(std::coroutine_handle<promise_type> handle) noexcept : m_handle(handle) {}
+
+        std::coroutine_handle<promise_type> m_handle;
+    };
+
+    template<typename T>
+    task<T> detail::task_promise<T>::get_return_object() noexcept {
+        return task<T>(std::coroutine_handle<task_promise>::from_promise(*this));
+    }
+
+
+    namespace detail {
+
+        struct sync_wait_state {
+            std::mutex mutex;
+            std::condition_variable cv;
+            bool done = false;
+
+            // 在锁内通知，使等待的线程返回（并销毁该对象）时通知已经结束
+            void notify() {
+                std::lock_guard lock(mutex);
+                done = true;
+                cv.notify_one();
+            }
+
+            void wait() {
+                std::unique_lock lock(mutex);
+                cv.wait(lock, [this] { return done; });
+            }
+        };
+
+        class sync_wait_task {
+        public:
+            class promise_type : public frame_allocation {
+            public:
+                class final_awaiter {
+                public:
+                    [[nodiscard]] bool await_ready() const noexcept { return false; }
+
+                    void await_suspend(std::coroutine_handle<promise_type> handle) const noexcept {
+                        handle.promise().m_state->notify();
+                    }
+
+                    void await_resume() const noexcept {}
+                };
+
+                [[nodiscard]] sync_wait_task get_return_object() noexcept {
+                    return sync_wait_task(std::coroutine_handle<promise_type>::from_promise(*this));
+                }
+
+                [[nodiscard]] std::suspend_always initial_suspend() const noexcept { return {}; }
+                [[nodiscard]] final_awaiter final_suspend() const noexcept { return {}; }
+                void return_void() const noexcept {}
+
+                // 协程体捕获了所有异常
+                [[noreturn]] void unhandled_exception() const noexcept {
+                    std::terminate();
+                }
+
+            private:
+                friend sync_wait_task;
+
+                sync_wait_state* m_state = nullptr;
+            };
+
+            sync_wait_task(const sync_wait_task&) = delete;
+            sync_wait_task& operator=(const sync_wait_task&) = delete;
+
+            ~sync_wait_task() {
+                m_handle.destroy();
+            }
+
+            void run() {
+                sync_wait_state state;
+                m_handle.promise().m_state = &state;
+                m_handle.resume();
+                state.wait();
+            }
+
+        private:
+            explicit sync_wait_task(std::coroutine_handle<promise_type> handle) noexcept : m_handle(handle) {}
+
+            std::coroutine_handle<promise_type> m_handle;
+        };
+
+        template<typename T>
+        struct sync_wait_result {
+            std::optional<std::conditional_t<std::is_void_v<T>, std::monostate, T>> value;
+            std::exception_ptr exception;
+        };
+
+        template<typename T>
+        sync_wait_task make_sync_wait_task(thread_pool* pool, task<T>& t, sync_wait_result<T>& out) {
+            try {
+                if (pool) co_await pool->schedule();
+                if constexpr (std::is_void_v<T>) {
+                    co_await std::move(t);
+                    out.value.emplace();
+                } else {
+                    out.value.emplace(co_await std::move(t));
+                }
+            } catch (...) {
+                out.exception = std::current_exception();
+            }
+        }
+
+        template<typename T>
+        T sync_wait_impl(thread_pool* pool, task<T>& t) {
+            sync_wait_result<T> out;
+            make_sync_wait_task(pool, t, out).run();
+            if (out.exception) std::rethrow_exception(out.exception);
+            if constexpr (!std::is_void_v<T>) return std::move(*out.value);
+        }
+
+    }
+
+
+    /**
+     * @brief 在当前线程中启动t，阻塞直到其完成，返回其结果或重新抛出其中的异常
+     *
+     * t在co_await pool.schedule()等处转移到其他线程后，当前线程会一直等待到t完成。
+     */
+    template<typename T>
+    T sync_wait(task<T> t) {
+        return detail::sync_wait_impl<T>(nullptr, t);
+    }
+
+    /**
+     * @brief 在pool中启动t，阻塞直到其完成，返回其结果或重新抛出其中的异常
+     *
+     * 不能在pool的工作线程中调用，否则可能因为所有工作线程都在等待而死锁。
+     */
+    template<typename T>
+    T sync_wait(thread_pool& pool, task<T> t) {
+        return detail::sync_wait_impl<T>(&pool, t);
+    }
+
+
+    namespace detail {
+
+        template<typename E, typename ...T>
+        struct when_all_state {
+            std::tuple<std::optional<T>...> values;
+            std::optional<E> error;
+            std::exception_ptr exception;
+            std::atomic<bool> failed = false;
+            std::atomic<std::size_t> remaining = 0;
+            std::stop_source stop;
+            std::coroutine_handle<> parent;
+
+            // 只有第一个失败的子任务会写入error或exception
+            void fail(E&& err) {
+                if (!failed.exchange(true, std::memory_order_acq_rel)) error.emplace(std::move(err));
+                stop.request_stop();
+            }
+
+            void fail(std::exception_ptr ex) noexcept {
+                if (!failed.exchange(true, std::memory_order_acq_rel)) exception = std::move(ex);
+                stop.request_stop();
+            }
+
+            // 子任务结束时调用，最后一个结束的子任务恢复when_all
+            [[nodiscard]] std::coroutine_handle<> arrive() noexcept {
+                if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) return parent;
+                return std::noop_coroutine();
+            }
+        };
+
+        // when_all的子任务，结束时自行销毁协程帧
+        template<typename State>
+        class when_all_child {
+        public:
+            class promise_type : public frame_allocation {
+            public:
+                class final_awaiter {
+                public:
+                    [[nodiscard]] bool await_ready() const noexcept { return false; }
+
+                    [[nodiscard]] std::coroutine_handle<> await_suspend(
+                            std::coroutine_handle<promise_type> handle) const noexcept {
+                        State* state = handle.promise().m_state;
+                        handle.destroy();
+                        return state->arrive();
+                    }
+
+                    void await_resume() const noexcept {}
+                };
+
+                template<typename ...Args>
+                explicit promise_type(State& state, const Args&...) noexcept : m_state(&state) {}
+
+                [[nodiscard]] when_all_child get_return_object() noexcept {
+                    return when_all_child(std::coroutine_handle<promise_type>::from_promise(*this));
+                }
+
+                [[nodiscard]] std::suspend_always initial_suspend() const noexcept { return {}; }
+                [[nodiscard]] final_awaiter final_suspend() const noexcept { return {}; }
+                void return_void() const noexcept {}
+
+                // 协程体捕获了所有异常
+                [[noreturn]] void unhandled_exception() const noexcept {
+                    std::terminate();
+                }
+
+            private:
+                State* m_state;
+            };
+
+            when_all_child(when_all_child&& other) noexcept : m_handle(std::exchange(other.m_handle, nullptr)) {}
+            when_all_child& operator=(when_all_child&&) = delete;
+
+            ~when_all_child() {
+                if (m_handle) m_handle.destroy();
+            }
+
+            // 放入pool或者在当前线程中开始运行，之后由子任务自己负责销毁；
+            // pool->post抛出异常时协程帧仍然由*this持有
+            void start(thread_pool* pool) {
+                if (pool) {
+                    pool->post(m_handle);
+                    m_handle = nullptr;
+                } else {
+                    std::exchange(m_handle, nullptr).resume();
+                }
+            }
+
+        private:
+            explicit when_all_child(std::coroutine_handle<promise_type> handle) noexcept : m_handle(handle) {}
+
+            std::coroutine_handle<promise_type> m_handle;
+        };
+
+        template<std::size_t I, typename State, typename U, typename E>
+        when_all_child<State> when_all_run(State& state, task<Result<U, E>> child) {
+            // 已经有子任务失败时不再开始运行
+            if (state.stop.stop_requested()) co_return;
+            try {
+                child.set_stop_token(state.stop.get_token());
+                Result<U, E> result = co_await std::move(child);
+                if (result.is_ok()) std::get<I>(state.values).emplace(std::move(result.template get_uncheck<0>()));
+                else state.fail(std::move(result.template get_uncheck<1>()));
+            } catch (...) {
+                state.fail(std::current_exception());
+            }
+        }
+
+        template<typename State, std::size_t N>
+        class when_all_awaiter {
+        public:
+            when_all_awaiter(State& state, std::array<when_all_child<State>, N> children) noexcept
+                : m_state(state), m_children(std::move(children)) {}
+
+            [[nodiscard]] bool await_ready() const noexcept { return N == 0; }
+
+            // 在当前线程池中运行子任务（最后一个在当前线程中直接运行），不在线程池中时依次运行
+            [[nodiscard]] bool await_suspend(std::coroutine_handle<> parent) {
+                m_state.parent = parent;
+                m_state.remaining.store(N + 1, std::memory_order_relaxed);
+                thread_pool* pool = thread_pool::current();
+                for (std::size_t i = 0; i + 1 < N; ++i) {
+                    try {
+                        m_children[i].start(pool);
+                    } catch (...) {
+                        // 已经提交的子任务仍在使用m_state，不能让异常离开这里。将异常作为when_all的结果，
+                        // 请求停止后剩下的子任务在当前线程中运行，它们不会开始child而是直接结束
+                        m_state.fail(std::current_exception());
+                        pool = nullptr;
+                        m_children[i].start(nullptr);
+                    }
+                }
+                m_children[N - 1].start(nullptr);
+                return m_state.remaining.fetch_sub(1, std::memory_order_acq_rel) != 1;
+            }
+
+            void await_resume() const noexcept {}
+
+        private:
+            State& m_state;
+            std::array<when_all_child<State>, N> m_children;
+        };
+
+    }
+
+
+    /**
+     * @brief 并发运行所有tasks，全部为Ok时得到各个Ok值组成的元组，否则得到第一个Err
+     *
+     * 在线程池中被co_await时子任务被提交到该线程池中运行，否则在当前线程中依次运行。
+     * 一个子任务得到Err（或者抛出异常）时，请求其他子任务停止，尚未开始的子任务不再运行；
+     * when_all在所有已开始的子任务结束后才完成，异常在co_await when_all处重新抛出。
+     * 向线程池提交子任务失败（例如std::bad_alloc）时同样如此，尚未提交的子任务不再运行。
+     * when_all自身的停止令牌被请求停止时，同样会请求所有子任务停止。
+     *
+     * @tparam E 各个子任务共同的Err类型
+     * @tparam T 各个子任务的Ok类型
+     */
+    template<typename E, typename ...T>
+        requires (sizeof...(T) > 0 && (std::is_object_v<T> && ...))
+    task<Result<std::tuple<T...>, E>> when_all(task<Result<T, E>>... tasks) {
+        using state_type = detail::when_all_state<E, T...>;
+        state_type state;
+        std::stop_callback link(co_await current_stop_token(), [&state]() noexcept { state.stop.request_stop(); });
+
+        co_await [&]<std::size_t... I>(std::index_sequence<I...>) {
+            return detail::when_all_awaiter<state_type, sizeof...(T)>(state,
+                    { detail::when_all_run<I>(state, std::move(tasks))... });
+        }(std::index_sequence_for<T...>{});
+
+        if (state.exception) std::rethrow_exception(state.exception);
+        if (state.error) co_return Result<std::tuple<T...>, E>(std::in_place_index<1>, std::move(*state.error));
+        co_return std::apply([](auto&... values) { return std::tuple<T...>(std::move(*values)...); }, state.values);
+    }
+
+}
+
+#endif // MY_CXX20
+#endif // !C163Q_MY_CPP_UTILS_RS_TASK_HPP
@@ -0,0 +1,253 @@
+/*!
+ * @file rs/thread_pool.hpp
+ * @brief 运行协程的工作窃取线程池
+ *
+ * 每个工作线程拥有一个Chase-Lev双端队列：工作线程自己提交的协程压入自己队列的底部并从底部取出（后进先出，缓存友好），
+ * 空闲的工作线程从其他队列的顶部窃取（先进先出）。非工作线程提交的协程轮流放入各个工作线程的收件箱，
+ * 每个收件箱有自己的锁，因此不存在所有线程共享的全局队列或锁。没有任务时工作线程在原子变量上等待。
+ *
+ * 实现位于src/rs/thread_pool.cpp。
+ *
+ * 至少需要C++20
+ *
+ * @since Oct 14, 2026
+ */
+
+#ifndef C163Q_MY_CPP_UTILS_RS_THREAD_POOL_HPP
+#define C163Q_MY_CPP_UTILS_RS_THREAD_POOL_HPP
+
+#include"../core/config.hpp"
+#ifndef MY_CXX20
+    static_assert(false, "Require C++20!");
+#else
+
+#include<atomic>
+#include<coroutine>
+#include<cstddef>
+#include<cstdint>
+#include<memory>
+#include<optional>
+#include<thread>
+#include<type_traits>
+#include<vector>
+
+namespace C163q {
+
+    /**
+     * @brief 用于避免伪共享的缓存行大小
+     */
+    inline constexpr size_t cache_line_size = 64;
+
+    /**
+     * @brief Chase-Lev工作窃取双端队列
+     *
+     * 只有所属线程可以调用push与pop（在底部进行），其他任意线程可以调用steal（从顶部进行）。
+     * 实现见Lê, Pop, Cohen, Zappa Nardelli, "Correct and Efficient Work-Stealing for Weak Memory Models"（PPoPP 2013）。
+     * 队列满时所属线程将环形缓冲区扩大一倍，旧的缓冲区保留到队列析构，使正在窃取的线程不会访问已释放的内存。
+     *
+     * @tparam T 元素的类型，std::atomic<T>必须总是无锁的（例如指针）
+     */
+    template<typename T>
+        requires std::is_trivially_copyable_v<T> && std::atomic<T>::is_always_lock_free
+    class chase_lev_deque {
+    public:
+        /**
+         * @param capacity 初始容量，会被向上取整为2的幂
+         */
+        explicit chase_lev_deque(size_t capacity = 256) {
+            size_t n = 2;
+            while (n < capacity) n *= 2;
+            m_rings.push_back(std::make_unique<ring>(n));
+            m_ring.store(m_rings.back().get(), std::memory_order_relaxed);
+        }
+
+        chase_lev_deque(const chase_lev_deque&) = delete;
+        chase_lev_deque& operator=(const chase_lev_deque&) = delete;
+
+        /**
+         * @brief 将value压入底部，只能由所属线程调用
+         */
+        void push(T value) {
+            std::int64_t b = m_bottom.load(std::memory_order_relaxed);
+            std::int64_t t = m_top.load(std::memory_order_acquire);
+            ring* r = m_ring.load(std::memory_order_relaxed);
+            if (b - t > std::int64_t(r->mask)) [[unlikely]] {
+                m_rings.push_back(r->grow(t, b));
+                r = m_rings.back().get();
+                m_ring.store(r, std::memory_order_release);
+            }
+            r->put(b, value);
+            // 原文为release栅栏加relaxed写，二者等价，但release写可以被ThreadSanitizer识别
+            m_bottom.store(b + 1, std::memory_order_release);
+        }
+
+        /**
+         * @brief 从底部取出，只能由所属线程调用
+         */
+        [[nodiscard]] std::optional<T> pop() {
+            std::int64_t b = m_bottom.load(std::memory_order_relaxed) - 1;
+            ring* r = m_ring.load(std::memory_order_relaxed);
+            m_bottom.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            std::int64_t t = m_top.load(std::memory_order_relaxed);
+            if (t > b) {
+                m_bottom.store(b + 1, std::memory_order_relaxed);
+                return std::nullopt;
+            }
+            T value = r->get(b);
+            if (t == b) {
+                // 只剩最后一个元素，与窃取者竞争
+                bool won = m_top.compare_exchange_strong(t, t + 1,
+                        std::memory_order_seq_cst, std::memory_order_relaxed);
+                m_bottom.store(b + 1, std::memory_order_relaxed);
+                if (!won) return std::nullopt;
+            }
+            return value;
+        }
+
+        /**
+         * @brief 从顶部窃取，可以由任意线程调用。与其他窃取者竞争失败时也返回空。
+         */
+        [[nodiscard]] std::optional<T> steal() {
+            std::int64_t t = m_top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            std::int64_t b = m_bottom.load(std::memory_order_acquire);
+            if (t >= b) return std::nullopt;
+            T value = m_ring.load(std::memory_order_acquire)->get(t);
+            if (!m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                return std::nullopt;
+            }
+            return value;
+        }
+
+        /**
+         * @brief 队列中元素的个数，在并发访问时只是近似值
+         */
+        [[nodiscard]] size_t size() const noexcept {
+            std::int64_t b = m_bottom.load(std::memory_order_relaxed);
+            std::int64_t t = m_top.load(std::memory_order_relaxed);
+            return b > t ? size_t(b - t) : 0;
+        }
+
+        [[nodiscard]] bool empty() const noexcept {
+            return size() == 0;
+        }
+
+    private:
+        struct ring {
+            explicit ring(size_t capacity) : mask(capacity - 1), data(new std::atomic<T>[capacity]) {}
+
+            [[nodiscard]] T get(std::int64_t i) const noexcept {
+                return data[size_t(i) & mask].load(std::memory_order_relaxed);
+            }
+
+            void put(std::int64_t i, T value) noexcept {
+                data[size_t(i) & mask].store(value, std::memory_order_relaxed);
+            }
+
+            [[nodiscard]] std::unique_ptr<ring> grow(std::int64_t top, std::int64_t bottom) const {
+                auto ret = std::make_unique<ring>(2 * (mask + 1));
+                for (std::int64_t i = top; i < bottom; ++i) ret->put(i, get(i));
+                return ret;
+            }
+
+            size_t mask;
+            std::unique_ptr<std::atomic<T>[]> data;
+        };
+
+        alignas(cache_line_size) std::atomic<std::int64_t> m_top = 0;
+        alignas(cache_line_size) std::atomic<std::int64_t> m_bottom = 0;
+        std::atomic<ring*> m_ring = nullptr;
+        // 只由所属线程访问，包括当前的以及所有旧的缓冲区
+        std::vector<std::unique_ptr<ring>> m_rings;
+    };
+
+
+    /**
+     * @brief 运行协程的工作窃取线程池
+     *
+     * 线程池析构时会等待已提交的协程全部运行完毕（或者挂起）后再结束工作线程，
+     * 因此析构之前应当确保所有任务均已完成（例如使用sync_wait）。
+     *
+     * @example
+     * ```cpp
+     * C163q::thread_pool pool(4);
+     * auto job = [&]() -> C163q::task<int> {
+     *     co_await pool.schedule();       // 之后的代码在线程池中运行
+     *     co_return 42;
+     * };
+     * assert(C163q::sync_wait(job()) == 42);
+     * ```
+     */
+    class thread_pool {
+    public:
+        /**
+         * @brief co_await thread_pool::schedule()使当前协程转移到线程池中继续运行
+         */
+        class schedule_awaiter {
+        public:
+            explicit schedule_awaiter(thread_pool& pool) noexcept : m_pool(&pool) {}
+
+            [[nodiscard]] bool await_ready() const noexcept { return false; }
+
+            void await_suspend(std::coroutine_handle<> handle) const {
+                m_pool->post(handle);
+            }
+
+            void await_resume() const noexcept {}
+
+        private:
+            thread_pool* m_pool;
+        };
+
+        /**
+         * @param threads 工作线程的个数，为0时使用std::thread::hardware_concurrency()
+         */
+        explicit thread_pool(size_t threads = 0);
+        thread_pool(const thread_pool&) = delete;
+        thread_pool& operator=(const thread_pool&) = delete;
+        ~thread_pool();
+
+        /**
+         * @brief 提交一个挂起的协程，由某个工作线程恢复
+         *
+         * 在该线程池的工作线程中调用时压入当前线程的队列，否则放入某个工作线程的收件箱。
+         */
+        void post(std::coroutine_handle<> handle);
+
+        [[nodiscard]] schedule_awaiter schedule() noexcept {
+            return schedule_awaiter(*this);
+        }
+
+        /**
+         * @brief 工作线程的个数
+         */
+        [[nodiscard]] size_t size() const noexcept;
+
+        /**
+         * @brief 当前线程所属的线程池，不是任何线程池的工作线程时返回nullptr
+         */
+        [[nodiscard]] static thread_pool* current() noexcept;
+
+    private:
+        struct worker;
+
+        void run(size_t index);
+        [[nodiscard]] void* find_work(size_t index);
+        void wake_one() noexcept;
+
+        std::vector<std::unique_ptr<worker>> m_workers;
+        alignas(cache_line_size) std::atomic<std::uint32_t> m_epoch = 0;
+        std::atomic<std::uint32_t> m_sleeping = 0;
+        std::atomic<size_t> m_next_inbox = 0;
+        std::atomic<bool> m_stop = false;
+    };
+
+    /**
+     * @brief 进程内共享的线程池，第一次调用时创建，工作线程数为std::thread::hardware_concurrency()
+     */
+    [[nodiscard]] thread_pool& default_thread_pool();
+}
+
+#endif // MY_CXX20
+#endif // !C163Q_MY_CPP_UTILS_RS_THREAD_POOL_HPP
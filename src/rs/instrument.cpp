@@ -0,0 +1,149 @@
+#include<algorithm>
+#include<atomic>
+#include<cstddef>
+#include<cstdint>
+#include<new>
+#include<source_location>
+#include<string_view>
+#include<tuple>
+#include<vector>
+#include"../../include/rs/instrument.hpp"
+
+namespace C163q {
+
+    std::string_view instrument_event_name(instrument_event event) noexcept {
+        switch (event) {
+        case instrument_event::ok: return "Ok";
+        case instrument_event::err: return "Err";
+        case instrument_event::or_else: return "or_else";
+        case instrument_event::unwrap_or: return "unwrap_or";
+        }
+        return "unknown";
+    }
+
+    namespace {
+        // 每个线程的计数表的大小，必须是2的幂
+        constexpr size_t table_size = 1024;
+        // 线性探测的最大次数，超过后计入dropped
+        constexpr size_t max_probes = 32;
+
+        // 只有所属线程会写入，其他线程只会读取（以及instrument_reset()清零count）
+        struct cell {
+            std::atomic<bool> used{false};
+            instrument_event event{};
+            std::source_location location;
+            std::atomic<std::uint64_t> count{0};
+        };
+
+        struct thread_table {
+            cell cells[table_size];
+            std::atomic<std::uint64_t> dropped{0};
+            thread_table* next = nullptr;
+        };
+
+        // 所有线程的计数表组成的链表，表只会被加入而不会被释放，使线程退出后其计数依然可以被汇总
+        std::atomic<thread_table*> all_tables = nullptr;
+        // 分配失败的次数（此时当前线程没有计数表）
+        std::atomic<std::uint64_t> orphan_dropped = 0;
+
+        thread_local thread_table* local_table = nullptr;
+
+        thread_table* register_table() noexcept {
+            auto* table = new (std::nothrow) thread_table;
+            if (!table) return nullptr;
+            table->next = all_tables.load(std::memory_order_relaxed);
+            while (!all_tables.compare_exchange_weak(table->next, table,
+                        std::memory_order_release, std::memory_order_relaxed)) {}
+            return table;
+        }
+
+        // 只有所属线程会修改，不需要原子的读-改-写
+        void increase(std::atomic<std::uint64_t>& counter) noexcept {
+            counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+
+        size_t hash(instrument_event event, const std::source_location& location) noexcept {
+            std::uint64_t h = std::uint64_t(reinterpret_cast<std::uintptr_t>(location.file_name()));
+            h ^= (std::uint64_t(location.line()) << 20) ^ (std::uint64_t(location.column()) << 8) ^
+                std::uint64_t(event);
+            h *= 0x9E3779B97F4A7C15ull;
+            return size_t(h >> 32);
+        }
+
+        // 同一个头文件中的同一个调用处在不同的翻译单元中可能有不同的file_name()指针，
+        // 记录时按指针区分，汇总时再按内容合并
+        bool same_site(const cell& c, instrument_event event, const std::source_location& location) noexcept {
+            return c.event == event && c.location.line() == location.line() &&
+                c.location.column() == location.column() && c.location.file_name() == location.file_name();
+        }
+    }
+
+    void instrument_record_(instrument_event event, const std::source_location& location) noexcept {
+        thread_table* table = local_table;
+        if (!table) [[unlikely]] {
+            table = local_table = register_table();
+            if (!table) {
+                orphan_dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+        }
+        size_t index = hash(event, location);
+        for (size_t probe = 0; probe < max_probes; ++probe, ++index) {
+            cell& c = table->cells[index & (table_size - 1)];
+            if (!c.used.load(std::memory_order_relaxed)) {
+                c.event = event;
+                c.location = location;
+                c.count.store(1, std::memory_order_relaxed);
+                c.used.store(true, std::memory_order_release);
+                return;
+            }
+            if (same_site(c, event, location)) {
+                increase(c.count);
+                return;
+            }
+        }
+        increase(table->dropped);
+    }
+
+    std::vector<instrument_record> instrument_snapshot() {
+        std::vector<instrument_record> records;
+        for (auto* table = all_tables.load(std::memory_order_acquire); table; table = table->next) {
+            for (const cell& c : table->cells) {
+                if (!c.used.load(std::memory_order_acquire)) continue;
+                records.push_back({ c.location, c.event, c.count.load(std::memory_order_relaxed) });
+            }
+        }
+
+        auto key = [](const instrument_record& r) {
+            return std::tuple(std::string_view(r.location.file_name()), r.location.line(),
+                    r.location.column(), r.event);
+        };
+        std::sort(records.begin(), records.end(), [&](const auto& a, const auto& b) { return key(a) < key(b); });
+        // 合并不同线程以及不同翻译单元中的同一个调用处
+        size_t n = 0;
+        for (size_t i = 0; i < records.size(); ++i) {
+            if (n != 0 && key(records[n - 1]) == key(records[i])) records[n - 1].count += records[i].count;
+            else records[n++] = records[i];
+        }
+        records.resize(n);
+        std::stable_sort(records.begin(), records.end(),
+                [](const auto& a, const auto& b) { return a.count > b.count; });
+        return records;
+    }
+
+    std::uint64_t instrument_dropped() noexcept {
+        std::uint64_t dropped = orphan_dropped.load(std::memory_order_relaxed);
+        for (auto* table = all_tables.load(std::memory_order_acquire); table; table = table->next) {
+            dropped += table->dropped.load(std::memory_order_relaxed);
+        }
+        return dropped;
+    }
+
+    void instrument_reset() noexcept {
+        orphan_dropped.store(0, std::memory_order_relaxed);
+        for (auto* table = all_tables.load(std::memory_order_acquire); table; table = table->next) {
+            for (cell& c : table->cells) c.count.store(0, std::memory_order_relaxed);
+            table->dropped.store(0, std::memory_order_relaxed);
+        }
+    }
+}
@@ -1,46 +1,296 @@
+#include<atomic>
+#include<cerrno>
+#include<charconv>
+#include<cstddef>
+#include<cstdint>
 #include<cstdio>
 #include<cstdlib>
+#include<cstring>
 #include<source_location>
 #include<string_view>
 #include"../../include/rs/panic.hpp"
 #include"../../include/core/config.hpp"
 #ifdef MY_CXX23
-#include<print>
 #include<stacktrace>
+#include<string>
+#endif
+#if __has_include(<unistd.h>)
+#include<unistd.h>
+#define MY_PANIC_HAS_WRITE
 #else
-#include<iostream>
+#include<thread>
+#endif
+#if __has_include(<execinfo.h>) && __has_include(<link.h>)
+#include<execinfo.h>
+#include<link.h>
+#define MY_PANIC_HAS_RAW_TRACEBACK
 #endif
 
 namespace C163q {
     bool enable_traceback = false;
+    panic_traceback traceback_style = panic_traceback::symbolized;
 
-#ifdef MY_CXX23
-    [[noreturn]] void call_panic_(const std::string_view& message,
-            const std::source_location location) noexcept {
-        if (location.function_name())
-            println(stderr, "panicked at {} in function {}:{}:{}:\n{}", location.file_name(),
-                    location.function_name(), location.line(), location.column(), message);
-        else
-            println(stderr, "panicked at {}:{}:{}:\n{}", location.file_name(),
-                    location.line(), location.column(), message);
-        if (enable_traceback) {
-            println("{}", std::stacktrace::current());
+    int write_fd(int fd, std::string_view data) noexcept {
+#ifdef MY_PANIC_HAS_WRITE
+        while (!data.empty()) {
+            auto n = ::write(fd, data.data(), data.size());
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                return errno;
+            }
+            data.remove_prefix(size_t(n));
         }
+        return 0;
 #else
-    [[noreturn]] void call_panic_(const std::string_view& message,
-            const std::source_location location) noexcept {
-        if (location.function_name())
-            std::cerr << "panicked at " << location.file_name() << " in function "
-                << location.function_name() << ":" << location.line() << ":"
-                << location.column() << ":\n" << message << std::endl;
-        else
-            std::cerr << "panicked at " << location.file_name() << ":"
-                << location.line() << ":" << location.column() << ":\n"
-                << message << std::endl;
-#endif
-        abort();
+        std::FILE* stream = fd == 1 ? stdout : fd == 2 ? stderr : nullptr;
+        if (!stream) return EBADF;
+        bool ok = std::fwrite(data.data(), 1, data.size(), stream) == data.size();
+        ok = std::fflush(stream) == 0 && ok;
+        return ok ? 0 : EIO;
+#endif
     }
-}
 
+    void panic_format_string_(panic_writer& writer, const void* value) noexcept {
+        writer.write(*static_cast<const std::string_view*>(value));
+    }
+
+    namespace {
+        // 不超过PIPE_BUF，使得输出到管道时一次write(2)是原子的
+        constexpr size_t panic_buffer_size = 4096;
+        constexpr size_t max_frames = 64;
+
+        // 每个线程各自的缓冲区，使多个线程可以同时格式化而不需要加锁
+        thread_local char panic_buffer[panic_buffer_size];
+        // 当前线程是否正在panic，用于检测格式化过程中再次panic
+        thread_local bool panicking = false;
+        // 第一个panic的线程获得输出的权利
+        std::atomic_flag panic_claimed = ATOMIC_FLAG_INIT;
+
+        std::atomic<panic_hook> current_hook = nullptr;
+#ifdef MY_PANIC_UNWIND
+        std::atomic<panic_strategy> current_strategy = panic_strategy::unwind;
+#else
+        std::atomic<panic_strategy> current_strategy = panic_strategy::abort;
+#endif
 
+        void write_all(std::string_view str) noexcept {
+            (void) write_fd(2, str);
+        }
 
+        [[noreturn]] void wait_forever() noexcept {
+            for (;;) {
+#ifdef MY_PANIC_HAS_WRITE
+                ::pause();
+#else
+                std::this_thread::yield();
+#endif
+            }
+        }
+
+        void write_number(panic_writer& writer, unsigned long value) noexcept {
+            char buf[24];
+            auto result = std::to_chars(buf, buf + sizeof(buf), value);
+            writer.write(std::string_view(buf, result.ptr));
+        }
+
+        void write_hex(panic_writer& writer, std::uintptr_t value) noexcept {
+            char buf[2 + sizeof(value) * 2] = { '0', 'x' };
+            auto result = std::to_chars(buf + 2, buf + sizeof(buf), value, 16);
+            writer.write(std::string_view(buf, result.ptr));
+        }
+
+        void write_location(panic_writer& writer, const std::source_location& location) noexcept {
+            writer.write("panicked at ");
+            writer.write(location.file_name());
+            if (location.function_name() && *location.function_name()) {
+                writer.write(" in function ");
+                writer.write(location.function_name());
+            }
+            writer.put(':');
+            write_number(writer, location.line());
+            writer.put(':');
+            write_number(writer, location.column());
+            writer.write(":\n");
+        }
+
+#ifdef MY_PANIC_HAS_RAW_TRACEBACK
+        void write_build_id(panic_writer& writer, const dl_phdr_info* info) noexcept {
+            for (ElfW(Half) i = 0; i < info->dlpi_phnum; ++i) {
+                const auto& phdr = info->dlpi_phdr[i];
+                if (phdr.p_type != PT_NOTE) continue;
+                auto p = reinterpret_cast<const unsigned char*>(info->dlpi_addr + phdr.p_vaddr);
+                auto end = p + phdr.p_memsz;
+                while (p + sizeof(ElfW(Nhdr)) <= end) {
+                    auto note = reinterpret_cast<const ElfW(Nhdr)*>(p);
+                    auto name = p + sizeof(ElfW(Nhdr));
+                    auto desc = name + ((note->n_namesz + 3) & ~3u);
+                    if (note->n_type == NT_GNU_BUILD_ID && note->n_namesz == 4 &&
+                            std::memcmp(name, "GNU", 4) == 0) {
+                        constexpr char digits[] = "0123456789abcdef";
+                        writer.write(" build-id=");
+                        for (ElfW(Word) j = 0; j < note->n_descsz; ++j) {
+                            writer.put(digits[desc[j] >> 4]);
+                            writer.put(digits[desc[j] & 0xf]);
+                        }
+                        return;
+                    }
+                    p = desc + ((note->n_descsz + 3) & ~3u);
+                }
+            }
+        }
+
+        /**
+         * @brief 打印原始地址以及已加载模块的基址与build-id，可以离线解析为符号
+         */
+        void write_raw_traceback(panic_writer& writer) noexcept {
+            void* frames[max_frames];
+            int n = ::backtrace(frames, int(max_frames));
+            writer.write("stack backtrace (raw):\n");
+            for (int i = 0; i < n; ++i) {
+                writer.write("  ");
+                write_number(writer, unsigned(i));
+                writer.write(": ");
+                write_hex(writer, reinterpret_cast<std::uintptr_t>(frames[i]));
+                writer.put('\n');
+            }
+            writer.write("loaded modules:\n");
+            ::dl_iterate_phdr([](dl_phdr_info* info, size_t, void* data) noexcept -> int {
+                auto& out = *static_cast<panic_writer*>(data);
+                out.write("  ");
+                write_hex(out, info->dlpi_addr);
+                out.put(' ');
+                out.write(info->dlpi_name && *info->dlpi_name ? info->dlpi_name : "<main>");
+                write_build_id(out, info);
+                out.put('\n');
+                return 0;
+            }, &writer);
+        }
+#endif
+
+        void write_traceback() noexcept {
+#ifdef MY_CXX23
+            if (traceback_style == panic_traceback::symbolized) {
+                try {
+                    write_all(std::to_string(std::stacktrace::current()));
+                    write_all("\n");
+                } catch (...) {}
+                return;
+            }
+#endif
+#ifdef MY_PANIC_HAS_RAW_TRACEBACK
+            panic_writer writer(panic_buffer, panic_buffer_size);
+            write_raw_traceback(writer);
+            write_all(writer.view());
+#endif
+        }
+
+        /**
+         * @brief 进入panic，同一线程在panic过程中再次panic时直接终止程序
+         */
+        void enter_panic() noexcept {
+            if (panicking) {
+                write_all("thread panicked while processing panic. aborting.\n");
+                std::abort();
+            }
+            panicking = true;
+        }
+
+        /**
+         * @brief 使用当前线程的缓冲区创建panic_writer，末尾保留空间用于截断标记以及换行符
+         */
+        panic_writer make_writer() noexcept {
+            return panic_writer(panic_buffer, panic_buffer_size - 4);
+        }
+
+        /**
+         * @brief 输出panic信息（或调用钩子），随后按照panic_strategy终止程序或抛出panic_error
+         *
+         * @param writer      已经写入位置信息以及panic信息的缓冲区
+         * @param header_size 位置信息的长度
+         * @param location    panic的位置
+         */
+        [[noreturn]] void finish_panic(panic_writer& writer, size_t header_size,
+                const std::source_location& location) {
+            char* end = panic_buffer + writer.view().size();
+            if (writer.truncated()) {
+                std::memcpy(end, "...", 3);
+                end += 3;
+            }
+            *end = '\n';
+            const panic_info info{ std::string_view(panic_buffer + header_size, end), location };
+
+            const auto strategy = current_strategy.load(std::memory_order_relaxed);
+            // 终止程序时只有第一个panic的线程输出，其余线程等待
+            if (strategy == panic_strategy::abort && panic_claimed.test_and_set(std::memory_order_acq_rel))
+                wait_forever();
+
+            if (auto hook = current_hook.load(std::memory_order_acquire)) {
+                try {
+                    hook(info);
+                } catch (...) {}
+            } else {
+                write_all(std::string_view(panic_buffer, end + 1));
+                if (enable_traceback) write_traceback();
+            }
+
+            if (strategy == panic_strategy::unwind) {
+                // 之后构造panic_error可能抛出std::bad_alloc，先清除标记，使该线程之后还可以正常panic；
+                // panic_buffer是线程局部的，构造完成之前不会被覆盖
+                panicking = false;
+                throw panic_error(info.message, location);
+            }
+            std::abort();
+        }
+    }
+
+    panic_hook set_panic_hook(panic_hook hook) noexcept {
+        return current_hook.exchange(hook, std::memory_order_acq_rel);
+    }
+
+    panic_hook take_panic_hook() noexcept {
+        return set_panic_hook(nullptr);
+    }
+
+    panic_strategy set_panic_strategy(panic_strategy strategy) noexcept {
+        return current_strategy.exchange(strategy, std::memory_order_relaxed);
+    }
+
+    panic_strategy get_panic_strategy() noexcept {
+        return current_strategy.load(std::memory_order_relaxed);
+    }
+
+    void prepare_panic_traceback() noexcept {
+#ifdef MY_PANIC_HAS_RAW_TRACEBACK
+        void* frame;
+        ::backtrace(&frame, 1);
+#endif
+    }
+
+    [[noreturn]] void call_panic_(const std::string_view& message,
+            const std::source_location location) {
+        enter_panic();
+        panic_writer writer = make_writer();
+        write_location(writer, location);
+        const size_t header_size = writer.view().size();
+        writer.write(message);
+        finish_panic(writer, header_size, location);
+    }
+
+    [[noreturn]] void call_panic_format_(std::string_view message, std::string_view sep,
+            panic_format_fn format, const void* value, const std::source_location location) {
+        enter_panic();
+        panic_writer writer = make_writer();
+        write_location(writer, location);
+        const size_t header_size = writer.view().size();
+        writer.write(message);
+        if (format) {
+            writer.write(sep);
+            try {
+                format(writer, value);
+            } catch (...) {
+                writer.write("<exception thrown while formatting>");
+            }
+        }
+        finish_panic(writer, header_size, location);
+    }
+}
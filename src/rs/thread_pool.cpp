@@ -0,0 +1,147 @@
+#include<algorithm>
+#include<atomic>
+#include<coroutine>
+#include<cstddef>
+#include<cstdint>
+#include<memory>
+#include<mutex>
+#include<thread>
+#include<vector>
+#include"../../include/rs/thread_pool.hpp"
+
+namespace C163q {
+
+    namespace {
+        // 进入睡眠之前再尝试寻找任务的次数
+        constexpr int spin_rounds = 64;
+
+        thread_local thread_pool* current_pool = nullptr;
+        thread_local size_t current_index = 0;
+
+        // 选择窃取对象用的xorshift随机数
+        std::uint64_t next_random(std::uint64_t& state) noexcept {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            return state;
+        }
+    }
+
+    struct alignas(cache_line_size) thread_pool::worker {
+        explicit worker(size_t index) noexcept : rng(0x9e3779b97f4a7c15ull * (index + 1)) {}
+
+        // 只由拥有该worker的线程push/pop，其他线程steal
+        chase_lev_deque<void*> deque;
+        // 非工作线程提交的协程，任意线程都可以取出
+        std::mutex inbox_mutex;
+        std::vector<void*> inbox;
+        std::atomic<bool> inbox_nonempty = false;
+        std::uint64_t rng;
+        std::thread thread;
+
+        // 将收件箱中的协程全部移入to的队列，返回第一个
+        void* drain_inbox(chase_lev_deque<void*>& to, bool blocking) {
+            if (!inbox_nonempty.load(std::memory_order_acquire)) return nullptr;
+            std::unique_lock lock(inbox_mutex, std::defer_lock);
+            if (blocking) lock.lock();
+            else if (!lock.try_lock()) return nullptr;
+            if (inbox.empty()) return nullptr;
+            void* first = inbox.front();
+            for (size_t i = 1; i < inbox.size(); ++i) to.push(inbox[i]);
+            inbox.clear();
+            inbox_nonempty.store(false, std::memory_order_relaxed);
+            return first;
+        }
+    };
+
+    thread_pool::thread_pool(size_t threads) {
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        m_workers.reserve(threads);
+        for (size_t i = 0; i < threads; ++i) m_workers.push_back(std::make_unique<worker>(i));
+        for (size_t i = 0; i < threads; ++i) m_workers[i]->thread = std::thread([this, i] { run(i); });
+    }
+
+    thread_pool::~thread_pool() {
+        m_stop.store(true, std::memory_order_release);
+        m_epoch.fetch_add(1, std::memory_order_release);
+        m_epoch.notify_all();
+        for (auto& w : m_workers) w->thread.join();
+    }
+
+    void thread_pool::post(std::coroutine_handle<> handle) {
+        if (current_pool == this) {
+            m_workers[current_index]->deque.push(handle.address());
+        } else {
+            worker& w = *m_workers[m_next_inbox.fetch_add(1, std::memory_order_relaxed) % m_workers.size()];
+            std::lock_guard lock(w.inbox_mutex);
+            w.inbox.push_back(handle.address());
+            w.inbox_nonempty.store(true, std::memory_order_release);
+        }
+        wake_one();
+    }
+
+    size_t thread_pool::size() const noexcept {
+        return m_workers.size();
+    }
+
+    thread_pool* thread_pool::current() noexcept {
+        return current_pool;
+    }
+
+    void thread_pool::wake_one() noexcept {
+        // 与run()中增加m_sleeping之后的再次检查配对，保证不会丢失唤醒
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_sleeping.load(std::memory_order_relaxed) != 0) {
+            m_epoch.fetch_add(1, std::memory_order_release);
+            m_epoch.notify_one();
+        }
+    }
+
+    void* thread_pool::find_work(size_t index) {
+        worker& self = *m_workers[index];
+        if (auto h = self.deque.pop()) return *h;
+        if (void* h = self.drain_inbox(self.deque, true)) return h;
+
+        size_t n = m_workers.size();
+        size_t start = size_t(next_random(self.rng) % n);
+        for (size_t k = 0; k < n; ++k) {
+            size_t victim = (start + k) % n;
+            if (victim == index) continue;
+            worker& other = *m_workers[victim];
+            if (auto h = other.deque.steal()) return *h;
+            // 对方忙于运行长任务时，替它处理收件箱
+            if (void* h = other.drain_inbox(self.deque, false)) return h;
+        }
+        return nullptr;
+    }
+
+    void thread_pool::run(size_t index) {
+        current_pool = this;
+        current_index = index;
+        for (;;) {
+            void* h = nullptr;
+            for (int i = 0; i < spin_rounds && !h; ++i) h = find_work(index);
+            if (!h) {
+                std::uint32_t epoch = m_epoch.load(std::memory_order_acquire);
+                m_sleeping.fetch_add(1, std::memory_order_seq_cst);
+                h = find_work(index);
+                if (!h) {
+                    if (m_stop.load(std::memory_order_acquire)) {
+                        m_sleeping.fetch_sub(1, std::memory_order_relaxed);
+                        break;
+                    }
+                    m_epoch.wait(epoch, std::memory_order_acquire);
+                }
+                m_sleeping.fetch_sub(1, std::memory_order_relaxed);
+                if (!h) continue;
+            }
+            std::coroutine_handle<>::from_address(h).resume();
+        }
+        current_pool = nullptr;
+    }
+
+    thread_pool& default_thread_pool() {
+        static thread_pool pool;
+        return pool;
+    }
+}
@@ -0,0 +1,59 @@
+#!/bin/sh
+# 检查kernels.cpp中每个codegen_X与其手写的等价实现codegen_X_baseline生成的代码：
+# - codegen_X的指令数不超过baseline加上SLACK（默认为2）；
+# - codegen_X的条件跳转数不超过baseline；
+# - codegen_X没有异常表，不调用格式化、异常处理相关的函数（panic只允许在冷代码段中调用）；
+# - baseline没有冷代码段时，codegen_X也不能有。
+#
+# 用法：check.sh kernels.o [SLACK]
+
+obj=$1
+slack=${2:-2}
+
+{
+    # 先输出带有异常表的函数，再输出反汇编
+    objdump -h "$obj" | awk '$2 ~ /^\.gcc_except_table\./ { sub(/^\.gcc_except_table\./, "", $2); print "EXCEPT " $2 }'
+    objdump -d --no-show-raw-insn "$obj"
+} | awk -v slack="$slack" '
+    $1 == "EXCEPT" { except[$2] = 1; next }
+    /^[0-9a-f]+ <.*>:$/ {
+        fn = $2
+        sub(/^</, "", fn)
+        sub(/>:$/, "", fn)
+        seen[fn] = 1
+        next
+    }
+    /^$/ { fn = ""; next }
+    fn != "" && /^ *[0-9a-f]+:\t/ {
+        insn = $0
+        sub(/^ *[0-9a-f]+:\t/, "", insn)
+        op = insn
+        sub(/[ \t].*/, "", op)
+        if (op ~ /^(nop|xchg|data16|cs|int3)/) next     # 对齐填充
+        count[fn]++
+        if (op ~ /^j/ && op !~ /^jmp/) branches[fn]++
+        if (op ~ /^(call|jmp)/ && insn ~ /format|__cxa_|_Unwind_|terminate|bad_variant_access|bad_optional_access|call_panic/ &&
+            fn !~ /\.cold$/) {
+            bad[fn] = bad[fn] " " insn
+        }
+    }
+    END {
+        failed = 0
+        for (fn in seen) {
+            if (fn !~ /^codegen_/ || fn ~ /_baseline$/ || fn ~ /\.cold$/ || fn == "codegen_abort") continue
+            base = fn "_baseline"
+            checked++
+            if (!(base in seen)) { printf "FAIL %s: missing %s\n", fn, base; failed = 1; continue }
+            status = "ok"
+            if (count[fn] > count[base] + slack) status = "FAIL (instructions)"
+            if (branches[fn] + 0 > branches[base] + 0) status = "FAIL (branches)"
+            if (fn in except) status = "FAIL (exception table)"
+            if (fn in bad) status = "FAIL (calls:" bad[fn] ")"
+            if ((fn ".cold") in seen && !((base ".cold") in seen)) status = "FAIL (cold path)"
+            printf "%-28s %3d instr %2d branches | baseline %3d instr %2d branches  %s\n",
+                fn, count[fn], branches[fn], count[base], branches[base], status
+            if (status != "ok") failed = 1
+        }
+        if (checked == 0) { print "FAIL: no kernels found"; failed = 1 }
+        exit failed
+    }'
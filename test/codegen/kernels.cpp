@@ -0,0 +1,126 @@
+#include"../../include/rs/match.hpp"
+#include"../../include/rs/option.hpp"
+#include"../../include/rs/result.hpp"
+#include<cstdint>
+#include<optional>
+#include<utility>
+#include<variant>
+
+// 零开销检查使用的内核：每个codegen_X都有一个手写的等价实现codegen_X_baseline。
+// check.sh在-O2下比较两者的指令数与条件跳转数，
+// 并要求codegen_X不含异常表、不调用格式化/异常处理的函数，且不比baseline多出冷代码段。
+// 新增内核时只需要按相同的命名添加一对函数。
+
+namespace {
+
+    enum class Errc : int { none, too_large };
+
+    using R = C163q::Result<int, Errc>;
+
+    // 与Result<int, Errc>相同大小的手写版本
+    struct raw_result {
+        union {
+            int value;
+            Errc err;
+        };
+        bool is_err;
+    };
+
+    struct A { int v; };
+    struct B { int v; };
+    struct C { int v; };
+    using V = std::variant<A, B, C>;
+
+}
+
+extern "C" {
+
+    [[gnu::cold, noreturn]] void codegen_abort(int code);
+
+    int codegen_result_and_then(R r) {
+        return r.and_then<int>([](int x) {
+            if (x > 1000) return R(std::in_place_index<1>, Errc::too_large);
+            return R(std::in_place_index<0>, x * 2);
+        }).unwrap_or(0);
+    }
+
+    int codegen_result_and_then_baseline(raw_result r) {
+        if (r.is_err || r.value > 1000) return 0;
+        return r.value * 2;
+    }
+
+    int codegen_result_map(R r) {
+        return r.map<int>([](int x) { return x + 1; })
+            .map<int>([](int x) { return x * 3; })
+            .unwrap_or(-1);
+    }
+
+    int codegen_result_map_baseline(raw_result r) {
+        if (r.is_err) return -1;
+        return (r.value + 1) * 3;
+    }
+
+    // 成功路径上只有一次比较，panic（以及格式化错误）只在冷路径上被调用
+    int codegen_result_unwrap(C163q::Result<int, int> r) {
+        return r.unwrap();
+    }
+
+    int codegen_result_unwrap_baseline(raw_result r) {
+        if (r.is_err) codegen_abort(int(r.err));
+        return r.value;
+    }
+
+    std::uint64_t codegen_option_map(C163q::Option<std::uint64_t> o) {
+        return o.map<std::uint64_t>([](std::uint64_t x) { return x * 3 + 1; }).unwrap_or(7);
+    }
+
+    std::uint64_t codegen_option_map_baseline(std::optional<std::uint64_t> o) {
+        return o ? *o * 3 + 1 : 7;
+    }
+
+    std::uint64_t codegen_option_ref(C163q::Option<std::uint64_t&> o) {
+        return o.map<std::uint64_t>([](std::uint64_t& x) { return x + 1; }).unwrap_or(0);
+    }
+
+    std::uint64_t codegen_option_ref_baseline(std::uint64_t* p) {
+        return p ? *p + 1 : 0;
+    }
+
+#ifndef MY_UTILS_HARDENED
+    // get_uncheck()的前置条件被告知编译器，其后的is_some()/is_ok()分支被省去，只剩一次读取
+    int codegen_option_get_uncheck(const C163q::Option<int>& o) {
+        int v = o.get_uncheck();
+        return o.is_some() ? v : -1;
+    }
+
+    int codegen_option_get_uncheck_baseline(const std::optional<int>& o) {
+        return *o;
+    }
+
+    int codegen_result_get_uncheck(const R& r) {
+        int v = r.get_uncheck<0>();
+        return r.is_ok() ? v : -1;
+    }
+
+    int codegen_result_get_uncheck_baseline(const raw_result& r) {
+        return r.value;
+    }
+#endif
+
+    int codegen_match3(const V& v) {
+        return C163q::match(v, C163q::overload{
+            [](const A& a) { return a.v + 1; },
+            [](const B& b) { return b.v * 2; },
+            [](const C& c) { return c.v - 3; },
+        });
+    }
+
+    int codegen_match3_baseline(const V& v) {
+        switch (v.index()) {
+            case 0: return std::get_if<0>(&v)->v + 1;
+            case 1: return std::get_if<1>(&v)->v * 2;
+            default: return std::get_if<2>(&v)->v - 3;
+        }
+    }
+
+}
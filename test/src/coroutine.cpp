@@ -0,0 +1,200 @@
+#include"../../include/rs/coroutine.hpp"
+#include"../../include/rs/result.hpp"
+#include<cassert>
+#include<cstddef>
+#include<cstdlib>
+#include<memory>
+#include<memory_resource>
+#include<new>
+#include<stdexcept>
+#include<string>
+#include<string_view>
+
+// 统计全局operator new的调用次数，用于检查协程帧缓存
+static size_t global_allocations = 0;
+
+void* operator new(size_t size) {
+    ++global_allocations;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+namespace {
+
+    // 记录析构次数，检查Err提前返回时协程中的局部变量被正确销毁
+    struct tracked {
+        static inline int alive = 0;
+        tracked() { ++alive; }
+        tracked(const tracked&) { ++alive; }
+        ~tracked() { --alive; }
+    };
+
+    C163q::Result<int, std::string> parse(std::string_view s) {
+        if (s.empty() || s.size() > 9) return C163q::Err<int>(std::string("bad number"));
+        int value = 0;
+        for (char c : s) {
+            if (c < '0' || c > '9') return C163q::Err<int>(std::string("bad digit"));
+            value = value * 10 + (c - '0');
+        }
+        return C163q::Ok<std::string>(value);
+    }
+
+    int reached = 0;
+
+    C163q::Result<int, std::string> sum(std::string_view a, std::string_view b) {
+        tracked t;
+        int x = co_await parse(a);
+        ++reached;
+        int y = co_await parse(b);
+        ++reached;
+        co_return x + y;
+    }
+
+    // Err值的类型不同时转换为协程的Err类型
+    C163q::Result<size_t, std::string> length(const char* s) {
+        auto checked = s ? C163q::Result<const char*, const char*>(std::in_place_index<0>, s)
+                         : C163q::Result<const char*, const char*>(std::in_place_index<1>, "null pointer");
+        const char* p = co_await checked;     // 左值：返回引用，不移动
+        co_return std::string_view(p).size();
+    }
+
+    C163q::Result<void, std::string> check(std::string_view s) {
+        int x = co_await parse(s);
+        if (x == 0) co_return;
+        co_await C163q::Result<void, std::string>(C163q::Err<int>(std::string("not zero")).unwrap_err());
+    }
+
+    C163q::Result<int, std::string> forward(std::string_view s) {
+        co_await check(s);
+        co_return C163q::Ok<std::string>(-1);      // 直接co_return一个Result
+    }
+
+    C163q::Result<int, std::string> throws() {
+        co_await parse("1");
+        throw std::runtime_error("thrown in coroutine");
+    }
+
+    // 抛出的异常对象不经过operator new，用于检查抛出异常时协程帧被释放
+    C163q::Result<int, std::string> throws_int(std::string_view s) {
+        int x = co_await parse(s);
+        if (x > 0) throw x;
+        co_return x;
+    }
+
+    // 协程帧由alloc分配
+    C163q::Result<int, std::string> with_allocator(std::allocator_arg_t, const std::pmr::polymorphic_allocator<>&,
+            std::string_view s) {
+        co_return 2 * co_await parse(s);
+    }
+
+    C163q::Result<int, std::string> throws_with_allocator(std::allocator_arg_t,
+            const std::pmr::polymorphic_allocator<>&, std::string_view s) {
+        int x = co_await parse(s);
+        if (x > 0) throw x;
+        co_return x;
+    }
+
+    struct service {
+        int base;
+
+        C163q::Result<int, std::string> add(std::allocator_arg_t, const std::pmr::polymorphic_allocator<>&,
+                std::string_view s) const {
+            co_return base + co_await parse(s);
+        }
+    };
+}
+
+int main() {
+    {
+        auto x = sum("12", "30");
+        assert(x.is_ok() && x.get<0>() == 42 && reached == 2);
+        reached = 0;
+        auto y = sum("12", "3x");
+        assert(y.is_err() && y.get<1>() == "bad digit" && reached == 1);
+        reached = 0;
+        auto z = sum("", "30");
+        assert(z.is_err() && z.get<1>() == "bad number" && reached == 0);
+        assert(tracked::alive == 0);
+    }
+    {
+        assert(length("abc").get<0>() == 3);
+        assert(length(nullptr).get<1>() == "null pointer");
+    }
+    {
+        assert(check("0").is_ok());
+        assert(check("1").get<1>() == "not zero");
+        assert(check("?").get<1>() == "bad digit");
+        assert(forward("0").get<0>() == -1);
+        assert(forward("5").get<1>() == "not zero");
+    }
+    {
+        bool caught = false;
+        try {
+            (void) throws();
+        } catch (const std::runtime_error& e) {
+            caught = std::string_view(e.what()) == "thrown in coroutine";
+        }
+        assert(caught);
+    }
+    {
+        // 帧缓存预热之后，成功和失败的路径都不会再调用operator new
+        for (int i = 0; i < 4; ++i) {
+            (void) sum("1", "2");
+            (void) sum("1", "x");
+        }
+        size_t before = global_allocations;
+        for (int i = 0; i < 1000; ++i) {
+            assert(sum("1", "2").is_ok());
+            assert(check("0").is_ok());
+        }
+        assert(global_allocations == before);
+
+        // 异常离开协程时协程帧同样被放回缓存，否则每次调用都需要分配新的协程帧
+        for (int i = 0; i < 1000; ++i) {
+            try {
+                (void) throws_int("1");
+            } catch (int) {}
+        }
+        assert(global_allocations == before);
+    }
+    {
+        struct counting_resource : std::pmr::memory_resource {
+            size_t allocated = 0;
+            size_t outstanding = 0;
+            void* do_allocate(size_t bytes, size_t align) override {
+                ++allocated;
+                ++outstanding;
+                return std::pmr::new_delete_resource()->allocate(bytes, align);
+            }
+            void do_deallocate(void* p, size_t bytes, size_t align) override {
+                --outstanding;
+                std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+            }
+            bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+                return this == &other;
+            }
+        } resource;
+        std::pmr::polymorphic_allocator<> alloc(&resource);
+
+        assert(with_allocator(std::allocator_arg, alloc, "21").get<0>() == 42);
+        assert(with_allocator(std::allocator_arg, alloc, "x").is_err());
+        assert(resource.allocated == 2 && resource.outstanding == 0);
+
+        service svc{ 100 };
+        assert(svc.add(std::allocator_arg, alloc, "5").get<0>() == 105);
+        assert(resource.allocated == 3 && resource.outstanding == 0);
+
+        bool caught = false;
+        try {
+            (void) throws_with_allocator(std::allocator_arg, alloc, "1");
+        } catch (int) {
+            caught = true;
+        }
+        assert(caught && resource.allocated == 4 && resource.outstanding == 0);
+    }
+}
+
+// USAGE: g++ -std=c++20 -o build/coroutine test/src/coroutine.cpp src/rs/panic.cpp
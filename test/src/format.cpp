@@ -1,9 +1,18 @@
 #include "../../include/format/vector.hpp"
 #include "../../include/format/span.hpp"
+#include "../../include/format/array.hpp"
+#include "../../include/format/deque.hpp"
+#include "../../include/format/option.hpp"
+#include "../../include/format/result.hpp"
+#include "../../include/format/spec.hpp"
 #include <array>
 #include <cassert>
+#include <cstdint>
+#include <deque>
 #include <format>
 #include <initializer_list>
+#include <iterator>
+#include <limits>
 #include <span>
 #include <string>
 #include <string_view>
@@ -28,6 +37,78 @@ int main() {
         assert(std::format(L"{}", std::vector{ 'a', 'b', 'c' })
                 == std::wstring_view(L"[a, b, c]"));
     }
+    {
+        // 多段设置不会使之前解析出的边界失效
+        assert(std::format("{:<begin:<v -- v>:end>}", std::vector{ 1, 2, 3 })
+                == std::string_view("begin:1 -- 2 -- 3:end"));
+        assert(std::format("{:<(<>)>}", std::vector<int>{}) == std::string_view("()"));
+        assert(std::format("{:<(<>)>}", std::vector{ 7 }) == std::string_view("(7)"));
+
+        // 超出内联缓冲区容量时引用格式化字符串中的原文，只有其中带有转义时才报告错误
+        assert(std::format("{:v0123456789012345678901234567890123456789v}", std::vector{ 1, 2 })
+                == std::string_view("[101234567890123456789012345678901234567892]"));
+        assert(std::format("{:<0123456789012345678901234567890123456789<v|v>0123456789012345678901234567890123456789>}",
+                std::vector{ 1, 2 }) == std::string_view(
+                "01234567890123456789012345678901234567891|20123456789012345678901234567890123456789"));
+        bool thrown = false;
+        try {
+            std::vector v{ 1, 2 };
+            (void)std::vformat("{:v\\|0123456789012345678901234567890123456789v}", std::make_format_args(v));
+        } catch (const std::format_error&) {
+            thrown = true;
+        }
+        assert(thrown);
+
+        std::vector<double> large(10000, 0.5);
+        std::string expected = "[0.5";
+        for (size_t i = 1; i < large.size(); ++i) expected += ", 0.5";
+        expected += "]";
+        assert(std::format("{}", large) == expected);
+
+        std::string out = "x = ";
+        std::format_to(std::back_inserter(out), "{}", std::vector{ 1, 2, 3 });
+        assert(out == "x = [1, 2, 3]");
+
+        std::vector<char> chars;
+        std::format_to(std::back_inserter(chars), "{:v;v}", std::vector{ 1, 2, 3 });
+        assert(std::string_view(chars.data(), chars.size()) == "[1;2;3]");
+    }
+    {
+        // 默认格式下算术类型的批量格式化与逐个元素使用std::formatter<T>的结果完全相同
+        auto join = [](const auto& range, std::string_view sep) {
+            std::string result = "[";
+            bool first = true;
+            for (const auto& x : range) {
+                if (!first) result += sep;
+                result += std::format("{}", x);
+                first = false;
+            }
+            return result + "]";
+        };
+
+        std::vector<int> ints { 0, -1, 42, std::numeric_limits<int>::min(), std::numeric_limits<int>::max() };
+        assert(std::format("{}", ints) == join(ints, ", "));
+        assert(std::format("{}", std::span<const int>(ints)) == join(ints, ", "));
+
+        std::vector<double> doubles { 0.0, -0.0, 0.1, 1e300, -2.2250738585072014e-308,
+            std::numeric_limits<double>::infinity(), std::numeric_limits<double>::quiet_NaN() };
+        assert(std::format("{}", doubles) == join(doubles, ", "));
+        assert(std::format("{:v\n\tv}", std::span(doubles)) == join(doubles, "\n\t"));
+
+        std::vector<float> floats { 1.5f, 3.4028235e38f, 1e-45f };
+        assert(std::format("{}", floats) == join(floats, ", "));
+        std::vector<unsigned char> bytes { 0, 127, 255 };
+        assert(std::format("{}", bytes) == join(bytes, ", "));
+
+        // 超过内部缓冲区大小的输入
+        std::vector<long long> many(5000);
+        for (size_t i = 0; i < many.size(); ++i) many[i] = (long long)(i * i) * -7919;
+        assert(std::format("{}", many) == join(many, ", "));
+        assert(std::format("{:v | v}", std::span(many)) == join(many, " | "));
+
+        assert(std::format(L"{}", std::vector{ 1, -2, 3 }) == std::wstring_view(L"[1, -2, 3]"));
+        assert(std::format("{:|}", std::vector{ 1, 2 }) == std::string_view("[1, 2]"));
+    }
     {
         std::vector v { 1, 2, 3, 4, 5, 6 };
         assert(std::format("{}", std::span(v))
@@ -50,6 +131,131 @@ int main() {
                 == std::wstring_view(L"[a, b, c]"));
     }
 
+    {
+        assert(std::format("{}", std::array{ 1, 2, 3 }) == std::string_view("[1, 2, 3]"));
+        assert(std::format("{:<(<>)>v; v|.2f}", std::array{ 1.0, 2.0 })
+                == std::string_view("(1.00; 2.00)"));
+        assert(std::format("{}", std::array<int, 0>{}) == std::string_view("[]"));
+        assert(std::format(L"{}", std::array{ 'x', 'y' }) == std::wstring_view(L"[x, y]"));
+
+        std::deque<int> d { 2, 3 };
+        d.push_front(1);
+        assert(std::format("{}", d) == std::string_view("[1, 2, 3]"));
+        assert(std::format("{:v -> v}", std::deque{ 'a', 'b', 'c' })
+                == std::string_view("[a -> b -> c]"));
+        assert(std::format("{:<(<>)>}", std::deque<double>{}) == std::string_view("()"));
+
+        std::deque<int> large;
+        std::string expected = "[";
+        for (int i = 0; i < 2000; ++i) {
+            large.push_back(i);
+            if (i != 0) expected += ", ";
+            expected += std::to_string(i);
+        }
+        assert(std::format("{}", large) == expected + "]");
+    }
+    {
+        std::vector<int> v(100);
+        for (int i = 0; i < 100; ++i) v[size_t(i)] = i + 1;
+
+        assert(std::format("{:h2t2}", v) == std::string_view("[1, 2, ..., 99, 100] (len=100)"));
+        assert(std::format("{:n5}", std::span(v)) == std::string_view("[1, 2, 3, ..., 99, 100] (len=100)"));
+        assert(std::format("{:h3}", v) == std::string_view("[1, 2, 3, ...] (len=100)"));
+        assert(std::format("{:t1v; v}", v) == std::string_view("[...; 100] (len=100)"));
+        assert(std::format("{:n0}", v) == std::string_view("[...] (len=100)"));
+        assert(std::format("{:n1000}", v) == std::format("{}", v));
+        assert(std::format("{:h50t50}", v) == std::format("{}", v));
+        assert(std::format("{:n3|.1f}", std::vector{ 1.0, 2.0, 3.0, 4.0 })
+                == std::string_view("[1.0, 2.0, ..., 4.0] (len=4)"));
+
+        std::deque<int> d(v.begin(), v.end());
+        assert(std::format("{:h2t2}", d) == std::string_view("[1, 2, ..., 99, 100] (len=100)"));
+        assert(std::format(L"{:<(<>)>n2}", std::array{ 1, 2, 3 }) == std::wstring_view(L"(1, ..., 3) (len=3)"));
+
+        // 只访问输出的元素
+        std::vector<std::int8_t> huge(50'000'000, 7);
+        assert(std::format("{:h1t1}", std::span(huge)) == std::string_view("[7, ..., 7] (len=50000000)"));
+
+        bool thrown = false;
+        try {
+            (void)std::format("{:hx}", v);
+        } catch (const std::format_error&) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+    {
+        using C163q::Option;
+        using C163q::Ok;
+        using C163q::Err;
+
+#ifdef __cpp_lib_format_ranges
+        // Option是一个范围，但不使用标准库对范围的格式化
+        static_assert(std::format_kind<Option<int>> == std::range_format::disabled);
+        static_assert(std::format_kind<Option<int&>> == std::range_format::disabled);
+#endif
+        assert(std::format("{}", Option<int>(1)) == std::string_view("Some(1)"));
+        assert(std::format("{}", Option<int>()) == std::string_view("None"));
+        assert(std::format("{:|.2f}", Option<double>(0.5)) == std::string_view("Some(0.50)"));
+        assert(std::format("{:<<>>}", Option<int>(3)) == std::string_view("3"));
+        assert(std::format("{:|v; v}", Option<std::vector<int>>(std::vector{ 1, 2 }))
+                == std::string_view("Some([1; 2])"));
+        int x = 7;
+        assert(std::format("{}", Option<int&>(x)) == std::string_view("Some(7)"));
+        assert(std::format(L"{}", Option<int>()) == std::wstring_view(L"None"));
+
+        assert(std::format("{}", Ok<std::string>(1)) == std::string_view("Ok(1)"));
+        assert(std::format("{}", Err<int>(std::string("bad"))) == std::string_view("Err(bad)"));
+        assert(std::format("{:|.1f}", Ok<int>(2.0)) == std::string_view("Ok(2.0)"));
+        assert(std::format("{:|.1f}", Err<double>(2)) == std::string_view("Err(2)"));
+        assert(std::format("{}", C163q::Result<void, int>(std::in_place_index<0>)) == std::string_view("Ok(())"));
+        assert(std::format("{}", C163q::Result<void, int>(std::in_place_index<1>, 5)) == std::string_view("Err(5)"));
+        assert(std::format(L"{}", Ok<int>(Option<int>(4))) == std::wstring_view(L"Ok(Some(4))"));
+
+        std::vector<Option<int>> options { 1, std::nullopt, 3 };
+        assert(std::format("{}", options) == std::string_view("[Some(1), None, Some(3)]"));
+
+        std::string out;
+        std::format_to(std::back_inserter(out), "{} {}", Ok<int>(1), Option<int>(2));
+        assert(out == "Ok(1) Some(2)");
+
+        // 单个值没有分隔符和元素个数，'v'、'n'、'h'、't'在解析时被拒绝
+        auto rejects = []<typename V>(std::string_view spec) {
+            std::formatter<V, char> f;
+            std::format_parse_context ctx(spec);
+            try {
+                (void)f.parse(ctx);
+            } catch (const std::format_error&) {
+                return true;
+            }
+            return false;
+        };
+        assert(rejects.template operator()<Option<int>>("n2}"));
+        assert(rejects.template operator()<Option<int>>("v; v}"));
+        assert((rejects.template operator()<C163q::Result<int, int>>("h1}")));
+        assert((rejects.template operator()<C163q::Result<void, int>>("t1}")));
+        assert(!rejects.template operator()<Option<int>>("<[<>]>}"));
+        assert(!(rejects.template operator()<C163q::Result<std::vector<int>, int>>("|v; v}")));
+        assert(std::format("{:n2}", options) == std::string_view("[Some(1), ..., Some(3)] (len=3)"));
+    }
+    {
+        static constexpr C163q::format_spec<std::vector<int>> brackets("<\\< <v \\| v> \\>>");
+        static constexpr C163q::format_spec<std::vector<double>> lines("<[\n\t<v\n\tv>\n]>");
+        static constexpr C163q::format_spec<std::span<const int>> head_tail("h1t1");
+        static constexpr C163q::format_spec<C163q::Option<int>, wchar_t> bare(L"<<>>");
+
+        std::vector v { 1, 2, 3 };
+        for (int i = 0; i < 3; ++i) {
+            assert(std::format("{}", C163q::with_spec(brackets, v)) == std::string_view("< 1 | 2 | 3 >"));
+        }
+        assert(C163q::format_with(lines, std::vector{ 1.5, 2.5 }) == "[\n\t1.5\n\t2.5\n]");
+        assert(C163q::format_with(head_tail, std::span<const int>(v)) == "[1, ..., 3] (len=3)");
+        assert(C163q::format_with(bare, C163q::Option<int>(8)) == L"8");
+
+        std::string out;
+        std::format_to(std::back_inserter(out), "a={} b={}", C163q::with_spec(brackets, v), v);
+        assert(out == "a=< 1 | 2 | 3 > b=[1, 2, 3]");
+    }
 }
 
 
@@ -0,0 +1,71 @@
+#define MY_UTILS_HARDENED
+#include"../../include/rs/option.hpp"
+#include"../../include/rs/panic.hpp"
+#include"../../include/rs/result.hpp"
+#include<cassert>
+#include<string>
+#include<string_view>
+#include<type_traits>
+
+// 定义MY_UTILS_HARDENED时，未检查的访问函数在前置条件不满足时panic，并报告调用处的位置
+
+int main() {
+    C163q::set_panic_strategy(C163q::panic_strategy::unwind);
+    static_assert(!noexcept(std::declval<C163q::Option<int>&>().get_uncheck()));
+
+    {
+        auto x = C163q::Some(1);
+        assert(x.get_uncheck() == 1 && x.unwrap_unchecked() == 1);
+        auto y = C163q::None<int>();
+        bool caught = false;
+        unsigned line = 0;
+        try {
+            line = __LINE__; (void) y.get_uncheck();
+        } catch (const C163q::panic_error& e) {
+            caught = true;
+            assert(std::string_view(e.what()) == "Option has no value");
+            assert(e.location().line() == line);
+        }
+        assert(caught);
+    }
+    {
+        int value = 0;
+        C163q::Option<int&> x;
+        bool caught = false;
+        try {
+            (void) x.unwrap_unchecked();
+        } catch (const C163q::panic_error&) {
+            caught = true;
+        }
+        assert(caught);
+        x = C163q::Option<int&>(std::in_place, value);
+        assert(&x.get_uncheck() == &value);
+    }
+    {
+        auto r = C163q::Ok<int>(std::string("ok"));
+        assert(r.get_uncheck<0>() == "ok" && r.as_const().unwrap_unchecked() == "ok");
+        bool caught = false;
+        unsigned line = 0;
+        try {
+            line = __LINE__; (void) r.unwrap_err_unchecked();
+        } catch (const C163q::panic_error& e) {
+            caught = true;
+            assert(std::string_view(e.what()) == "Invaild access to Result");
+            assert(e.location().line() == line);
+        }
+        assert(caught);
+    }
+    {
+        C163q::Result<void, int> r(std::in_place_index<1>, 3);
+        assert(r.unwrap_err_unchecked() == 3);
+        bool caught = false;
+        try {
+            r.unwrap_unchecked();
+        } catch (const C163q::panic_error&) {
+            caught = true;
+        }
+        assert(caught);
+    }
+}
+
+// USAGE: g++ -std=c++20 -o build/hardened test/src/hardened.cpp src/rs/panic.cpp
@@ -0,0 +1,113 @@
+#define MY_UTILS_INSTRUMENT
+#include"../../include/rs/instrument.hpp"
+#include"../../include/rs/result.hpp"
+#include<cassert>
+#include<cstdint>
+#include<string>
+#include<string_view>
+#include<thread>
+#include<utility>
+#include<vector>
+
+// 定义MY_UTILS_INSTRUMENT时，Ok/Err的构造以及or_else、unwrap_or的回退按调用处计数
+
+namespace {
+
+    std::uint64_t count_at(unsigned line, C163q::instrument_event event) {
+        std::uint64_t count = 0;
+        for (const auto& r : C163q::instrument_snapshot()) {
+            if (r.location.line() == line && r.event == event &&
+                std::string_view(r.location.file_name()).ends_with("instrument.cpp")) {
+                count += r.count;
+            }
+        }
+        return count;
+    }
+
+    constexpr unsigned err_line = __LINE__ + 3;
+    constexpr unsigned ok_line = __LINE__ + 3;
+    C163q::Result<int, std::string> parse(int x) {
+        if (x < 0) return C163q::Err<int>(std::string("negative"));
+        return C163q::Ok<std::string>(x);
+    }
+
+    // 常量求值时不计数
+    constexpr int constant() {
+        auto r = C163q::Err<int>(3);
+        return r.unwrap_or(0);
+    }
+}
+
+int main() {
+    using C163q::instrument_event;
+    static_assert(constant() == 0);
+
+    for (int i = -3; i < 7; ++i) (void) parse(i);
+    assert(count_at(err_line, instrument_event::err) == 3);
+    assert(count_at(ok_line, instrument_event::ok) == 7);
+
+    {
+        unsigned line = __LINE__; auto a = parse(-1).unwrap_or(5); auto b = parse(1).unwrap_or(5);
+        assert(a == 5 && b == 1);
+        assert(count_at(line, instrument_event::unwrap_or) == 1);
+
+        line = __LINE__; auto c = parse(-1).unwrap_or([](std::string&& s) { return int(s.size()); });
+        assert(c == 8);
+        assert(count_at(line, instrument_event::unwrap_or) == 1);
+
+        line = __LINE__; auto d = parse(-1).unwrap_or_default();
+        assert(d == 0);
+        assert(count_at(line, instrument_event::unwrap_or) == 1);
+    }
+    {
+        auto recover = [](std::string&&) { return C163q::Result<int, int>(std::in_place_index<0>, 0); };
+        unsigned line = __LINE__;
+        for (int i = -2; i < 2; ++i) (void) parse(i).or_else<int>(recover);
+        assert(count_at(line + 1, instrument_event::or_else) == 2);
+
+        C163q::Result<void, int> v(std::in_place_index<1>, 1);
+        line = __LINE__; (void) v.or_else<int>([](int) { return C163q::Result<void, int>(); });
+        assert(count_at(line, instrument_event::or_else) == 1);
+    }
+    {
+        // 需要转换的参数以及多个参数使用参数包形式的重载，同样被计数
+        unsigned line = __LINE__; auto e = C163q::Err<int, std::string>("bad");
+        assert(e.is_err() && count_at(line, instrument_event::err) == 1);
+
+        line = __LINE__; auto p = C163q::Ok<std::string, std::pair<int, int>>(1, 2);
+        assert(p.is_ok() && count_at(line, instrument_event::ok) == 1);
+
+        line = __LINE__; auto s = C163q::Ok<int, std::string>(size_t(3), 'x');
+        assert(s.get<0>() == "xxx" && count_at(line, instrument_event::ok) == 1);
+
+        line = __LINE__; auto z = C163q::Ok<int, std::vector<int>>();
+        assert(z.is_ok() && count_at(line, instrument_event::ok) == 1);
+
+        std::string lvalue = "lvalue";
+        line = __LINE__; auto l = C163q::Ok<int, std::string>(lvalue);
+        assert(l.get<0>() == "lvalue" && count_at(line, instrument_event::ok) == 1);
+
+        line = __LINE__; auto v = C163q::Err<void, std::string>(size_t(2), 'e');
+        assert(v.is_err() && count_at(line, instrument_event::err) == 1);
+    }
+    {
+        // 多个线程在同一调用处的计数会被汇总，线程退出后依然保留
+        std::vector<std::thread> threads;
+        unsigned line = __LINE__;
+        auto work = [] { for (int i = 0; i < 1000; ++i) (void) C163q::Err<int>(i); };
+        for (int i = 0; i < 4; ++i) threads.emplace_back(work);
+        for (auto& t : threads) t.join();
+        assert(count_at(line + 1, instrument_event::err) == 4000);
+    }
+
+    auto records = C163q::instrument_snapshot();
+    assert(!records.empty());
+    for (size_t i = 1; i < records.size(); ++i) assert(records[i - 1].count >= records[i].count);
+    assert(C163q::instrument_event_name(records.front().event) == "Err");
+    assert(C163q::instrument_dropped() == 0);
+
+    C163q::instrument_reset();
+    for (const auto& r : C163q::instrument_snapshot()) assert(r.count == 0);
+}
+
+// USAGE: g++ -std=c++20 -o build/instrument test/src/instrument.cpp src/rs/panic.cpp src/rs/instrument.cpp
@@ -1,8 +1,37 @@
 #include"../../include/rs/match.hpp"
+#include"../../include/rs/option.hpp"
+#include"../../include/rs/result.hpp"
 #include<cassert>
+#include<cstddef>
+#include<string>
+#include<utility>
 #include<variant>
+#include<vector>
 #include<string_view>
 
+template<std::size_t I>
+struct event {
+    int payload = I;
+};
+
+template<typename Seq>
+struct make_events;
+
+template<std::size_t ...I>
+struct make_events<std::index_sequence<I...>> {
+    using type = std::variant<event<I>...>;
+};
+
+// 40个可选项，超过match_switch_threshold，使用switch分派
+using big_variant = make_events<std::make_index_sequence<40>>::type;
+
+struct move_only {
+    std::string value;
+    move_only(std::string s) : value(std::move(s)) {}
+    move_only(move_only&&) = default;
+    move_only(const move_only&) = delete;
+};
+
 int main() {
     {
         std::variant<int, double, const char*> v { 1.0 };
@@ -21,9 +50,89 @@ int main() {
                 );
         assert(ret == "not int");
     }
+    {
+        static_assert(std::variant_size_v<big_variant> > C163q::match_switch_threshold);
+        for (std::size_t i : { 0, 1, 15, 16, 17, 31, 32, 39 }) {
+            big_variant v;
+            [&]<std::size_t ...I>(std::index_sequence<I...>) {
+                ((i == I ? (void)v.emplace<I>() : (void)0), ...);
+            }(std::make_index_sequence<40>{});
+            int payload = C163q::match(v, [](auto& e) { return e.payload; });
+            assert(payload == int(i));
+            const big_variant& cv = v;
+            std::size_t index = C163q::match(cv,
+                    [](const event<17>&) { return std::size_t(1000); },
+                    [&](const auto&) { return cv.index(); });
+            assert(index == (i == 17 ? 1000 : i));
+        }
+    }
+    {
+        // 右值variant中的值会被移动
+        std::variant<int, move_only> v { std::in_place_index<1>, "hello" };
+        std::string s = C163q::match(std::move(v),
+                [](int) { return std::string(); },
+                [](move_only&& m) { return std::move(m.value); });
+        assert(s == "hello");
+
+        std::variant<int, double> w { 1 };
+        C163q::match(w, [](int& i) { i = 2; }, [](double&) {});
+        assert(std::get<0>(w) == 2);
+    }
+    {
+        auto r = C163q::Ok<int>(std::string("hello"));
+        std::string s = C163q::match(std::move(r),
+                [](std::string&& s) { return std::move(s); },
+                [](int e) { return std::to_string(e); });
+        assert(s == "hello");
+
+        // T与E相同时按位置匹配
+        C163q::Result<int, int> e(std::in_place_index<1>, 3);
+        assert(C163q::match(e, [](int v) { return v; }, [](int v) { return -v; }) == -3);
+
+        C163q::Result<void, int> ok;
+        assert(C163q::match(ok, [] { return 1; }, [](int) { return 2; }) == 1);
+    }
+    {
+        auto x = C163q::Some(2);
+        assert(C163q::match(x, [](int v) { return v * 2; }, [] { return 0; }) == 4);
+        assert(C163q::match(C163q::None<int>(), [](int v) { return v; }, [] { return -1; }) == -1);
+
+        int y = 1;
+        C163q::Option<int&> ref(y);
+        C163q::match(ref, [](int& v) { v = 5; }, [] {});
+        assert(y == 5);
 
+        C163q::Option<void> some_void(std::in_place);
+        assert(C163q::match(some_void, [] { return true; }, [] { return false; }));
+    }
+    {
+        std::vector<std::variant<int, double, std::string>> v { 1, 2.0, std::string("a"), 3, 4.0, std::string("b") };
+        int ints = 0;
+        double doubles = 0;
+        std::string strings;
+        std::vector<int> order;
+        C163q::match_range(v,
+                [&](int i) { ints += i; order.push_back(0); },
+                [&](double d) { doubles += d; order.push_back(1); },
+                [&](std::string& s) { strings += s; s.clear(); order.push_back(2); });
+        assert(ints == 4 && doubles == 6.0 && strings == "ab");
+        assert((order == std::vector<int>{ 0, 0, 1, 1, 2, 2 }));    // 按可选项分桶处理
+        assert(std::get<2>(v[2]).empty());
+
+        order.clear();
+        C163q::match_range<C163q::match_range_policy::in_order>(v,
+                [&](int) { order.push_back(0); },
+                [&](double) { order.push_back(1); },
+                [&](const std::string&) { order.push_back(2); });
+        assert((order == std::vector<int>{ 0, 1, 2, 0, 1, 2 }));
+
+        std::vector<big_variant> empty;
+        C163q::match_range(empty, [](auto&) { assert(false); });
+    }
 }
 
+// USAGE: g++ -std=c++20 -o build/match test/src/match.cpp src/rs/panic.cpp
+
 
 
 
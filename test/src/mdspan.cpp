@@ -0,0 +1,70 @@
+#include"../../include/format/mdspan.hpp"
+#include<array>
+#include<cassert>
+#include<cstddef>
+#include<format>
+#include<mdspan>
+#include<string>
+#include<string_view>
+#include<vector>
+
+int main() {
+    {
+        std::vector v { 1, 2, 3, 4, 5, 6 };
+        std::mdspan m(v.data(), 2, 3);
+        assert(std::format("{}", m) == std::string_view("[[1, 2, 3], [4, 5, 6]]"));
+        assert(std::format("{:d0,\n d}", m) == std::string_view("[[1, 2, 3],\n [4, 5, 6]]"));
+        assert(std::format("{:<(<>)>v v}", m) == std::string_view("((1 2 3) (4 5 6))"));
+        assert(std::format("{:d1;d|.1f}", std::mdspan(std::vector{ 0.5, 1.5 }.data(), 2, 1))
+                == std::string_view("[[0.5], [1.5]]"));
+
+        // 转置：最内层一维的步长不为1
+        std::mdspan<int, std::dextents<size_t, 2>, std::layout_left> t(v.data(), 3, 2);
+        assert(std::format("{}", t) == std::string_view("[[1, 4], [2, 5], [3, 6]]"));
+
+        // 带步长的子视图：每隔一列取一个
+        using strided = std::layout_stride::mapping<std::dextents<size_t, 2>>;
+        std::mdspan<int, std::dextents<size_t, 2>, std::layout_stride> s(v.data(),
+                strided(std::dextents<size_t, 2>(2, 2), std::array<size_t, 2>{ 3, 2 }));
+        assert(std::format("{}", s) == std::string_view("[[1, 3], [4, 6]]"));
+    }
+    {
+        std::vector<float> data(24);
+        for (size_t i = 0; i < data.size(); ++i) data[i] = float(i) / 2;
+        std::mdspan<const float, std::dextents<size_t, 3>> m(data.data(), 2, 3, 4);
+        std::string expected;
+        for (size_t i = 0; i < 2; ++i) {
+            expected += i == 0 ? "[[" : "], [";
+            for (size_t j = 0; j < 3; ++j) {
+                expected += j == 0 ? "[" : "], [";
+                for (size_t k = 0; k < 4; ++k) {
+                    if (k != 0) expected += ", ";
+                    expected += std::format("{}", data[i * 12 + j * 4 + k]);
+                }
+            }
+            expected += "]";
+        }
+        expected += "]]";
+        assert(std::format("{}", m) == expected);
+        assert(std::format(L"{:d2 d}", std::mdspan(std::vector{ 1, 2, 3, 4 }.data(), 1, 2, 2))
+                == std::wstring_view(L"[[[1 2], [3 4]]]"));
+    }
+    {
+        std::vector<int> empty;
+        assert(std::format("{}", std::mdspan(empty.data(), 0, 3)) == std::string_view("[]"));
+        assert(std::format("{}", std::mdspan(empty.data(), 2, 0)) == std::string_view("[[], []]"));
+
+        int x = 42;
+        assert(std::format("{}", std::mdspan<int, std::extents<size_t>>(&x)) == std::string_view("42"));
+
+        bool thrown = false;
+        try {
+            (void)std::format("{:d2,d}", std::mdspan(empty.data(), 0, 0));
+        } catch (const std::format_error&) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+}
+
+// USAGE: g++ -std=c++23 -o build/mdspan test/src/mdspan.cpp
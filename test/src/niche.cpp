@@ -0,0 +1,183 @@
+#include"../../include/rs/niche.hpp"
+#include"../../include/rs/result20.hpp"
+#include"../../include/rs/option.hpp"
+#include<cassert>
+#include<cmath>
+#include<cstddef>
+#include<iostream>
+#include<limits>
+#include<memory>
+#include<optional>
+#include<type_traits>
+#include<variant>
+#include<vector>
+
+namespace {
+    struct Node { int value; };
+    enum class Errc : unsigned char { eof = 1, bad_token = 2 };
+    enum class Status : int { ok = 0, timeout, refused };
+    struct not_found {};
+    enum class Color : unsigned char { red, green, blue, none = 0xff };
+}
+
+template<>
+struct C163q::result_niche_traits<Node*, Errc> : C163q::result_pointer_tag_niche<Node*, Errc> {};
+
+template<>
+struct C163q::result_niche_traits<std::unique_ptr<Node>, not_found>
+    : C163q::result_sentinel_niche<std::unique_ptr<Node>, not_found> {};
+
+template<>
+struct C163q::result_niche_traits<Color, not_found> : C163q::result_sentinel_niche<Color, not_found, Color::none> {};
+
+template<>
+struct C163q::result_niche_traits<void, Status> : C163q::result_sentinel_niche<void, Status, Status::ok> {};
+
+template<>
+struct C163q::option_sentinel_traits<float> : C163q::option_nan_sentinel<float> {};
+
+template<>
+struct C163q::option_sentinel_traits<double> : C163q::option_nan_sentinel<double> {};
+
+template<>
+struct C163q::option_sentinel_traits<std::size_t> : C163q::option_value_sentinel<std::size_t, std::size_t(-1)> {};
+
+template<>
+struct C163q::option_sentinel_traits<Color> : C163q::option_value_sentinel<Color, Color::none> {};
+
+template<>
+struct C163q::option_sentinel_traits<std::unique_ptr<Node>> : C163q::option_value_sentinel<std::unique_ptr<Node>, nullptr> {};
+
+template<>
+struct C163q::option_sentinel_traits<bool> : C163q::option_bool_niche {};
+
+int main() {
+    static_assert(sizeof(C163q::Result<Node*, Errc>) == sizeof(Node*));
+    static_assert(sizeof(C163q::Result<std::unique_ptr<Node>, not_found>) == sizeof(Node*));
+    static_assert(sizeof(C163q::Result<void, Status>) == sizeof(Status));
+    static_assert(sizeof(C163q::Result<int*, Errc>) > sizeof(int*));     // 未启用
+    {
+        Node n{ 42 };
+        auto x = C163q::Ok<Errc>(&n);
+        assert(x.is_ok() && x.get<0>()->value == 42);
+        assert(std::get<0>(x.to_variant()) == &n);
+
+        auto y = C163q::Err<Node*>(Errc::bad_token);
+        assert(y.is_err() && y.get<1>() == Errc::bad_token);
+        assert(y.unwrap_or(&n) == &n);
+
+        auto z = C163q::Ok<Errc, Node*>(nullptr);
+        assert(z.is_ok() && z.get<0>() == nullptr);
+
+        x = y;
+        assert(x == y);
+        x.assign(z);
+        assert(x.is_ok() && x < y);
+        assert(x.map<int>(-1, [](Node* p) { return p ? p->value : 0; }) == 0);
+    }
+    {
+        auto x = C163q::Ok<not_found>(std::make_unique<Node>(Node{ 7 }));
+        assert(x.is_ok() && x.get<0>()->value == 7);
+        auto p = x.unwrap();
+        assert(p->value == 7);
+        assert(x.is_err());     // 被移动之后的std::unique_ptr为空，即Sentinel
+
+        auto y = C163q::Err<std::unique_ptr<Node>>(not_found{});
+        assert(y.is_err());
+        assert(y.map<int>(-1, [](std::unique_ptr<Node> p) { return p->value; }) == -1);
+    }
+    {
+        // T()等于Sentinel时默认构造的Result会是Err，因此不能默认构造
+        static_assert(!std::is_default_constructible_v<C163q::Result<std::unique_ptr<Node>, not_found>>);
+        static_assert(sizeof(C163q::Result<Color, not_found>) == sizeof(Color));
+        constexpr C163q::Result<Color, not_found> c;
+        static_assert(c.is_ok() && c.get<0>() == Color::red);
+    }
+    {
+        constexpr C163q::Result<void, Status> x;
+        static_assert(x.is_ok());
+
+        constexpr auto y = C163q::Result<void, Status>(Status::timeout);
+        static_assert(y.is_err() && y.get<1>() == Status::timeout);
+        assert(y.unwrap_err() == Status::timeout);
+    }
+    static_assert(sizeof(C163q::Option<float>) == sizeof(float));
+    static_assert(sizeof(C163q::Option<double>) == sizeof(double));
+    static_assert(sizeof(C163q::Option<std::size_t>) == sizeof(std::size_t));
+    static_assert(sizeof(C163q::Option<Color>) == sizeof(Color));
+    static_assert(sizeof(C163q::Option<std::unique_ptr<Node>>) == sizeof(Node*));
+    static_assert(sizeof(C163q::Option<bool>) == sizeof(bool));
+    static_assert(sizeof(C163q::Option<int>) > sizeof(int));             // 未启用
+    static_assert(std::is_trivially_copyable_v<C163q::Option<double>>);
+    {
+        constexpr C163q::Option<double> x;
+        static_assert(x.is_none());
+        constexpr auto y = C163q::Some(2.5);
+        static_assert(y.is_some() && y.get() == 2.5);
+
+        // 其他的NaN依然是Some
+        auto z = C163q::Some(std::numeric_limits<double>::quiet_NaN());
+        assert(z.is_some() && std::isnan(z.get()));
+        auto w = C163q::Some(-std::numeric_limits<float>::quiet_NaN());
+        assert(w.is_some());
+
+        std::vector<C163q::Option<float>> v(4);
+        v[1] = C163q::Some(1.0f);
+        (void) v[3].insert(3.0f);
+        float sum = 0;
+        for (const auto& o : v) sum += o.unwrap_or(0.0f);
+        assert(sum == 4.0f && v[0].is_none() && v[2].is_none());
+
+        auto t = v[1].take();
+        assert(t.is_some() && t.get() == 1.0f && v[1].is_none());
+        assert(v[3].replace(5.0f).get() == 3.0f && v[3].get() == 5.0f);
+        std::optional<float> o = static_cast<std::optional<float>>(v[3]);
+        assert(o && *o == 5.0f);
+        assert(static_cast<std::optional<float>>(v[0]) == std::nullopt);
+        C163q::Option<float> back(o);
+        assert(back.is_some() && back.get() == 5.0f);
+        C163q::Option<double> widened(back);
+        assert(widened.is_some() && widened.get() == 5.0);
+    }
+    {
+        constexpr C163q::Option<std::size_t> x;
+        static_assert(x.is_none());
+        constexpr C163q::Option<std::size_t> y(std::size_t(0));
+        static_assert(y.is_some() && y.get() == 0);
+
+        C163q::Option<std::size_t> i;
+        assert(i.get_or_insert([] { return std::size_t(7); }) == 7 && i.get() == 7);
+        i = C163q::None<std::size_t>();
+        assert(i.is_none() && i.map<std::size_t>([](std::size_t n) { return n + 1; }).is_none());
+    }
+    {
+        C163q::Option<Color> c = Color::blue;
+        assert(c.is_some() && c.get() == Color::blue);
+        C163q::Option<Color> d;
+        d = c.take();
+        assert(c.is_none() && d.get() == Color::blue);
+        assert(std::ranges::distance(c) == 0 && std::ranges::distance(d) == 1);
+    }
+    {
+        auto p = C163q::Some(std::make_unique<Node>(Node{ 3 }));
+        assert(p.is_some() && p.get()->value == 3);
+        C163q::Option<std::unique_ptr<Node>> q(std::move(p));
+        assert(q.is_some() && q.get()->value == 3);
+        auto n = std::move(q).unwrap();
+        assert(n->value == 3);
+        assert(C163q::Option<std::unique_ptr<Node>>().is_none());
+    }
+    {
+        C163q::Option<bool> b;
+        assert(b.is_none());
+        b = C163q::Some(false);
+        assert(b.is_some() && !b.get());
+        (void) b.insert(true);
+        assert(b.is_some() && b.get());
+        assert(b.take().get() && b.is_none());
+        assert(b.unwrap_or(false) == false);
+    }
+    std::cout << "PASS!" << std::endl;
+}
+
+// USAGE: g++ -std=c++20 -o build/niche test/src/niche.cpp src/rs/panic.cpp
@@ -1,6 +1,27 @@
-
 #include"../../include/rs/option.hpp"
-#include <tuple>
+#include<atomic>
+#include<cassert>
+#include<cstdint>
+#include<memory>
+#include<memory_resource>
+#include<string>
+#include<string_view>
+#include<tuple>
+#include<type_traits>
+#include<utility>
+
+template<typename T>
+constexpr bool is_trivial_wrapper_v = std::is_trivially_copyable_v<T> &&
+    std::is_trivially_copy_constructible_v<T> && std::is_trivially_move_constructible_v<T> &&
+    std::is_trivially_copy_assignable_v<T> && std::is_trivially_move_assignable_v<T> &&
+    std::is_trivially_destructible_v<T>;
+
+struct counted {
+    static inline int moves = 0;
+    int value;
+    explicit counted(int v) : value(v) {}
+    counted(counted&& other) noexcept : value(other.value) { ++moves; }
+};
 
 int main() {
     C163q::Option<int> a(1);
@@ -10,6 +31,132 @@ int main() {
     C163q::Option<void> c;
 
     b.unzip();
-}
 
+    {
+        static_assert(is_trivial_wrapper_v<C163q::Option<int>>);
+        static_assert(is_trivial_wrapper_v<C163q::Option<double>>);
+        static_assert(is_trivial_wrapper_v<C163q::Option<void>>);
+        static_assert(!std::is_trivially_copyable_v<C163q::Option<std::string>>);
+        static_assert(!std::is_trivially_destructible_v<C163q::Option<std::string>>);
+        static_assert(std::is_nothrow_move_constructible_v<C163q::Option<std::string>>);
+    }
+    {
+        static_assert(sizeof(C163q::Option<int&>) == sizeof(int*));
+        static_assert(is_trivial_wrapper_v<C163q::Option<int&>>);
+        static_assert(is_trivial_wrapper_v<C163q::Option<const std::string&>>);
+        static_assert(!std::is_constructible_v<C163q::Option<const int&>, int&&>);
+
+        std::string s = "hello";
+        C163q::Option<std::string> x(s);
+        auto r = x.as_ref();
+        static_assert(std::is_same_v<decltype(r), C163q::Option<std::string&>>);
+        r.unwrap() += " world";
+        assert(x.get() == "hello world");
+        assert(r.data() == &x.get_uncheck());
+
+        auto cr = std::as_const(x).as_ref();
+        static_assert(std::is_same_v<decltype(cr), C163q::Option<const std::string&>>);
+        assert(cr.copied().unwrap() == "hello world");
+        assert(cr.cloned().is_some_and([](const std::string& v) { return v.size() == 11; }));
+        assert(cr.map<size_t>([](const std::string& v) { return v.size(); }).unwrap() == 11);
+        assert(cr.map(size_t(0), [](const std::string& v) { return v.size(); }) == 11);
+
+        C163q::Option<int&> none;
+        assert(none.is_none() && none.data() == nullptr);
+        assert(none.copied().is_none());
+        int fallback = 3;
+        assert(&none.unwrap_or(fallback) == &fallback);
+        assert(none.or_else(C163q::Option<int&>(fallback)).unwrap() == 3);
+
+        int y = 4;
+        auto old = none.replace(y);
+        assert(old.is_none() && none.unwrap() == 4);
+        assert(&none.take().unwrap() == &y && none.is_none());
+        assert(&none.get_or_insert(fallback) == &fallback);
+        assert(none.ok_or(0).unwrap().get() == 3);
+
+        C163q::Option<const int&> widened = none;
+        assert(widened.data() == &fallback);
+    }
+    {
+        std::atomic<C163q::Option<std::uint32_t>> slot;
+        static_assert(std::atomic<C163q::Option<std::uint32_t>>::is_always_lock_free);
+        assert(slot.load().is_none());
+
+        slot.store(C163q::Some(std::uint32_t(7)));
+        assert(slot.load().unwrap() == 7);
+
+        auto old = slot.exchange(C163q::None<std::uint32_t>());
+        assert(old.unwrap() == 7 && slot.load().is_none());
+    }
+    {
+        // map的返回值可以直接构造在新的Option中（CWG2327，并不保证），最多每一步移动一次
+        counted::moves = 0;
+        auto step = [](counted&& c) { return counted(c.value * 2); };
+        auto x = C163q::Some(1).map<counted>([](int i) { return counted(i); })
+            .map<counted>(step).map<counted>(step);
+        assert(x.unwrap().value == 4);
+        assert(counted::moves >= 1 && counted::moves <= 4);    // unwrap时一定移动
+        auto y = C163q::Some(1).ok_or_else<counted>([] { return counted(0); });
+        assert(y.is_ok());
+    }
+    {
+        // map(default, f)、map(fallback, f)与and_then返回可调用对象的结果
+        auto x = C163q::Some(2);
+        assert(x.as_const().map<int>(0, [](int i) { return i * 3; }) == 6);
+        assert(x.as_const().map<int>([] { return -1; }, [](int i) { return i * 3; }) == 6);
+        assert(x.as_const().and_then<int>([](int i) { return C163q::Some(i + 1); }).unwrap() == 3);
+        assert(C163q::Some(2).map<int>(0, [](int i) { return i * 3; }) == 6);
+        assert(C163q::Some(2).map<int>([] { return -1; }, [](int i) { return i * 3; }) == 6);
+        assert(C163q::Some(2).and_then<int>([](int i) { return C163q::Some(i + 1); }).unwrap() == 3);
+        assert(C163q::Some(2).and_then<int>([](int) { return C163q::None<int>(); }).is_none());
+        assert(C163q::None<int>().map<int>(5, [](int i) { return i * 3; }) == 5);
+        C163q::Option<void> v(std::in_place);
+        assert(v.map<int>(0, [] { return 4; }) == 4);
+        assert(v.map<int>([] { return -1; }, [] { return 4; }) == 4);
+        assert(v.and_then<int>([] { return C163q::Some(4); }).unwrap() == 4);
+    }
+    {
+        // 未检查的访问函数在未定义MY_UTILS_HARDENED时是noexcept的
+        static_assert(noexcept(std::declval<C163q::Option<int>&>().get_uncheck()));
+        static_assert(noexcept(std::declval<const C163q::Option<int&>&>().unwrap_unchecked()));
+        auto x = C163q::Some(std::string("abc"));
+        assert(x.get_uncheck() == "abc");
+        assert(x.as_const().unwrap_unchecked() == "abc");
+        assert(x.unwrap_unchecked() == "abc" && x.get_uncheck().empty());
+    }
+    {
+        // 使用allocator_arg构造以及map/and_then时，payload的分配全部来自arena
+        std::pmr::monotonic_buffer_resource arena;
+        std::pmr::polymorphic_allocator<> alloc(&arena);
+        auto* old_default = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+        static_assert(std::uses_allocator_v<C163q::Option<std::pmr::string>, std::pmr::polymorphic_allocator<>>);
+        static_assert(!std::uses_allocator_v<C163q::Option<int>, std::pmr::polymorphic_allocator<>>);
+
+        C163q::Option<std::pmr::string> x(std::allocator_arg, alloc, std::in_place, 32, 'x');
+        assert(x.get_uncheck().get_allocator() == alloc);
+        C163q::Option<std::pmr::string> y(std::allocator_arg, alloc, x);
+        assert(y.get_uncheck().get_allocator() == alloc);
+        C163q::Option<std::pmr::string> none(std::allocator_arg, alloc, std::nullopt);
+        assert(C163q::Option<std::pmr::string>(std::allocator_arg, alloc, std::move(none)).is_none());
+
+        auto z = C163q::Option<int>(40)
+            .map<std::pmr::string>(std::allocator_arg, alloc, [](int n, const auto& a) {
+                return std::pmr::string(size_t(n), 'z', a);
+            })
+            .and_then<std::pmr::string>(std::allocator_arg, alloc, [](std::pmr::string&& s) {
+                s.back() = '!';
+                return C163q::Option<std::pmr::string>(std::move(s));
+            });
+        assert(z.get_uncheck().get_allocator() == alloc);
+        assert(std::string_view(z.get_uncheck()) == std::string(39, 'z') + "!");
+
+        std::pmr::vector<C163q::Option<std::pmr::string>> vec(alloc);
+        vec.emplace_back(std::in_place, "another long string that does not fit in SSO");
+        vec.push_back(x);
+        assert(vec[0].get_uncheck().get_allocator() == alloc && vec[1].get_uncheck().get_allocator() == alloc);
+        std::pmr::set_default_resource(old_default);
+    }
+}
 
+// USAGE: g++ -std=c++20 -o build/option test/src/option.cpp src/rs/panic.cpp -latomic
@@ -0,0 +1,167 @@
+#include"../../include/rs/option_vector.hpp"
+#include<algorithm>
+#include<cassert>
+#include<cstddef>
+#include<cstdint>
+#include<iostream>
+#include<stdexcept>
+#include<string>
+#include<vector>
+
+namespace {
+    // 默认构造在throw_on_default为true时抛出异常
+    struct fragile {
+        static inline bool throw_on_default = false;
+        int value = 0;
+        fragile() {
+            if (throw_on_default) throw std::runtime_error("fragile");
+        }
+        fragile(int v) : value(v) {}
+    };
+}
+
+// std::vector<bool>不能提供元素的引用，因此不接受bool
+template<typename T>
+concept option_vector_of = requires { typename C163q::option_vector<T>; };
+
+template<typename T, typename E>
+concept result_vector_of = requires { typename C163q::result_vector<T, E>; };
+
+static_assert(option_vector_of<int> && !option_vector_of<bool>);
+static_assert(result_vector_of<int, int> && !result_vector_of<bool, int> && !result_vector_of<int, bool>);
+
+int main() {
+    {
+        C163q::option_vector<int> v;
+        assert(v.empty() && v.count_some() == 0);
+        v.push_back(C163q::Some(1));
+        v.push_back(C163q::None<int>());
+        v.emplace_back(3);
+        v.push_none();
+        assert(v.size() == 4 && v.count_some() == 2 && v.count_none() == 2);
+        assert(v.is_some(0) && v.is_none(1));
+        assert(v[0].get() == 1 && v[1].is_none() && v[2].get() == 3);
+
+        // 通过引用修改
+        v[2].get() = 30;
+        assert(v.values()[2] == 30);
+        const auto& cv = v;
+        assert(cv[2].get() == 30 && cv.at(3).is_none());
+
+        assert((v.unwrap_or(-1) == std::vector<int>{ 1, -1, 30, -1 }));
+        auto doubled = v.filter_map([](int x) { return x > 1 ? C163q::Some(x * 2) : C163q::None<int>(); });
+        assert((doubled == std::vector<int>{ 60 }));
+
+        v.set(1, C163q::Some(2));
+        v.reset(0);
+        assert(v.is_some(1) && v.is_none(0) && v.values()[0] == 0);
+        v.fill_none(7);
+        assert(v.count_none() == 0);
+        assert((v.unwrap_or(-1) == std::vector<int>{ 7, 2, 30, 7 }));
+
+        v.pop_back();
+        assert(v.size() == 3 && v.count_some() == 3);
+    }
+    {
+        // 跨越多个位图字，包括全为1、全为0与部分为1的字
+        constexpr size_t n = 64 * 3 + 5;
+        C163q::option_vector<long> v(n);
+        assert(v.count_none() == n);
+        for (size_t i = 0; i < 64; ++i) v.set(i, C163q::Some(long(i)));
+        for (size_t i = 128; i < n; i += 3) v.set(i, C163q::Some(long(i)));
+        size_t expected = 64 + (n - 128 + 2) / 3;
+        assert(v.count_some() == expected);
+        assert(v.validity()[0] == ~std::uint64_t(0) && v.validity()[1] == 0);
+
+        auto dense = v.unwrap_or(-1);
+        for (size_t i = 0; i < n; ++i) {
+            assert(dense[i] == (v.is_some(i) ? long(i) : -1));
+        }
+        auto indices = v.filter_map([](long x) { return C163q::Some(size_t(x)); });
+        assert(indices.size() == expected);
+        assert(std::is_sorted(indices.begin(), indices.end()));
+
+        v.resize(70);
+        assert(v.size() == 70 && v.count_some() == 64 && v.is_none(64));
+        v.resize(200);
+        assert(v.count_some() == 64 && v.is_none(199));
+        v.clear();
+        assert(v.empty() && v.validity().empty());
+    }
+    {
+        std::vector<C163q::Option<std::string>> src{ C163q::Some(std::string("a")), C163q::None<std::string>() };
+        C163q::option_vector<std::string> v(src);
+        assert(v.size() == 2 && v[0].get() == "a" && v[1].is_none());
+        C163q::option_vector<std::string> w{ C163q::None<std::string>(), C163q::Some(std::string("b")) };
+        v.swap(w);
+        assert(v[1].get() == "b" && w[0].get() == "a");
+        C163q::option_vector<std::string> filled(3, "x");
+        assert(filled.count_some() == 3 && filled[2].get() == "x");
+    }
+    {
+        using result_t = C163q::Result<int, std::string>;
+        C163q::result_vector<int, std::string> v;
+        v.emplace_ok(1);
+        v.emplace_err("bad");
+        v.push_back(result_t(std::in_place_index<0>, 3));
+        v.push_back(result_t(std::in_place_index<1>, "worse"));
+        assert(v.size() == 4 && v.count_ok() == 2 && v.count_err() == 2);
+        assert(v.is_ok(0) && v.is_err(1));
+        assert(v[0].unwrap().get() == 1 && v[1].unwrap_err().get() == "bad");
+        assert(v.errors()[3] == "worse" && v.errors()[0].empty());
+
+        v[2].unwrap().get() = 4;
+        assert((v.unwrap_or(0) == std::vector<int>{ 1, 0, 4, 0 }));
+        auto big = v.filter_map([](int x) { return x > 1 ? C163q::Some(x) : C163q::None<int>(); });
+        assert((big == std::vector<int>{ 4 }));
+
+        v.set(1, result_t(std::in_place_index<0>, 2));
+        assert(v.is_ok(1) && v.errors()[1].empty() && v.count_ok() == 3);
+        v.set(0, result_t(std::in_place_index<1>, "gone"));
+        assert(v.at(0).is_err() && v.values()[0] == 0);
+
+        std::vector<result_t> src{ result_t(std::in_place_index<0>, 5) };
+        C163q::result_vector<int, std::string> w(src);
+        assert(w.size() == 1 && w.count_ok() == 1);
+        w.pop_back();
+        assert(w.empty());
+    }
+    {
+        // 构造另一部分时抛出异常，已经添加的部分被撤销
+        C163q::result_vector<int, fragile> v;
+        v.emplace_ok(1);
+        fragile::throw_on_default = true;
+        bool thrown = false;
+        try {
+            v.emplace_ok(2);
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        assert(thrown && v.size() == 1 && v.errors().size() == 1 && v.count_ok() == 1);
+        fragile::throw_on_default = false;
+        v.emplace_err(3);
+        assert(v.size() == 2 && v.is_err(1) && v[1].unwrap_err().get().value == 3);
+
+        C163q::result_vector<fragile, int> w;
+        fragile::throw_on_default = true;
+        thrown = false;
+        try {
+            w.emplace_err(4);
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        fragile::throw_on_default = false;
+        assert(thrown && w.empty() && w.errors().empty() && w.validity().empty());
+
+        // 逐个添加跨越多个位图字
+        C163q::option_vector<fragile> o;
+        for (int i = 0; i < 200; ++i) {
+            if (i % 2) o.emplace_back(i);
+            else o.push_none();
+        }
+        assert(o.size() == 200 && o.count_some() == 100 && o.validity().size() == 4);
+    }
+    std::cout << "PASS!" << std::endl;
+}
+
+// USAGE: g++ -std=c++20 -o build/option_vector test/src/option_vector.cpp src/rs/panic.cpp
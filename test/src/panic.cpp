@@ -1,20 +1,101 @@
 #include"../../include/rs/panic.hpp"
+#include"../../include/rs/result.hpp"
+#include<cassert>
+#include<exception>
+#include<iostream>
+#include<stdexcept>
+#include<string>
+#include<string_view>
 
-int main() {
-    C163q::enable_traceback = true;
-    panic("Error and abort!");
+namespace {
+    std::string last_message;
+    int hook_calls = 0;
+
+    void recording_hook(const C163q::panic_info& info) {
+        ++hook_calls;
+        last_message = info.message;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string_view(argv[1]) == "abort") {
+        // 默认的panic_strategy::abort：输出panic信息与栈回溯后终止程序
+        C163q::enable_traceback = true;
+        panic("Error and abort!");
+    }
+
+    assert(C163q::get_panic_strategy() == C163q::panic_strategy::abort);
+    assert(C163q::set_panic_strategy(C163q::panic_strategy::unwind) == C163q::panic_strategy::abort);
+    assert(C163q::set_panic_hook(recording_hook) == nullptr);
+
+    {
+        bool caught = false;
+        try {
+            panic("first");
+        } catch (const C163q::panic_error& e) {
+            caught = true;
+            assert(std::string_view(e.what()) == "first");
+            assert(e.location().line() != 0);
+        }
+        assert(caught && hook_calls == 1 && last_message == "first");
+    }
+    {
+        // 同一线程可以再次panic
+        C163q::Result<int, std::string> r(std::in_place_index<1>, "bad");
+        bool caught = false;
+        try {
+            (void)r.expect("expect");
+        } catch (const C163q::panic_error& e) {
+            caught = true;
+            assert(std::string_view(e.what()) == "expect: bad");
+        }
+        assert(caught && hook_calls == 2 && last_message == "expect: bad");
+    }
+    {
+        // panic_error不会被当作普通的错误捕获
+        bool caught = false;
+        try {
+            auto r = C163q::result_helper<std::exception>::invoke([]() -> int { panic("inner"); });
+            (void)r;
+        } catch (const C163q::panic_error& e) {
+            caught = true;
+        }
+        assert(caught);
+
+        caught = false;
+        try {
+            (void)C163q::try_invoke([]() -> int { panic("inner"); });
+        } catch (const C163q::panic_error&) {
+            caught = true;
+        }
+        assert(caught && hook_calls == 4);
+    }
+    {
+        bool caught = false;
+        std::string long_message(10000, 'x');
+        try {
+            panic(long_message);
+        } catch (const C163q::panic_error& e) {
+            caught = true;
+            std::string_view what = e.what();
+            assert(what.size() < long_message.size() && what.ends_with("..."));
+        }
+        assert(caught);
+    }
+
+    assert(C163q::take_panic_hook() == recording_hook);
+    C163q::set_panic_strategy(C163q::panic_strategy::abort);
+    std::cout << "PASS!" << std::endl;
 }
 
-// USAGE: g++ -std=c++23 -o build/panic test/src/panic.cpp src/rs/panic.cpp -lstdc++exp
-// OUTPUT:
-// panicked at test/src/panic.cpp in function int main():5:5:
+// USAGE: g++ -std=c++20 -o build/panic test/src/panic.cpp src/rs/panic.cpp
+// USAGE: g++ -std=c++23 -o build/panic test/src/panic.cpp src/rs/panic.cpp -lstdc++exp && ./build/panic abort
+// OUTPUT (./build/panic abort):
+// panicked at test/src/panic.cpp in function int main(int, char**):24:9:
 // Error and abort!
 //    0# C163q::call_panic_(std::basic_string_view<char, std::char_traits<char> > const&, std::source_location) at :0
 //    1# main at :0
 //    2# __libc_start_call_main at ../sysdeps/nptl/libc_start_call_main.h:58
 //    3# __libc_start_main_impl at ../csu/libc-start.c:360
 //    4# _start at :0
-//    5# 
-
-
-
+//    5#
@@ -0,0 +1,143 @@
+#include"../../include/rs/parallel.hpp"
+#include"../../include/rs/result.hpp"
+#include"../../include/rs/thread_pool.hpp"
+#include<atomic>
+#include<cassert>
+#include<functional>
+#include<numeric>
+#include<ranges>
+#include<stdexcept>
+#include<string>
+#include<vector>
+
+namespace {
+
+    using C163q::Result;
+
+    Result<int, std::string> check(int x) {
+        if (x < 0) return C163q::Err<int>(std::to_string(x));
+        return C163q::Ok<std::string>(x * 2);
+    }
+
+    struct move_only {
+        int value;
+        explicit move_only(int v) : value(v) {}
+        move_only(move_only&&) = default;
+        move_only& operator=(move_only&&) = default;
+    };
+}
+
+int main() {
+    C163q::thread_pool pool(4);
+    const auto par = C163q::execution::par.on(pool).chunked(100);
+    std::vector<int> input(10000);
+    std::iota(input.begin(), input.end(), 0);
+
+    {
+        auto r = C163q::try_transform(par, input, check);
+        assert(r.is_ok() && r.get<0>().size() == input.size());
+        for (size_t i = 0; i < input.size(); ++i) assert(r.get<0>()[i] == int(2 * i));
+        auto s = C163q::try_transform(C163q::execution::seq, input, check);
+        assert(s.get<0>() == r.get<0>());
+        // 使用默认的线程池以及自动的块大小
+        assert(C163q::try_transform(C163q::execution::par, input, check).get<0>() == r.get<0>());
+    }
+    {
+        // first_index总是得到下标最小的Err，并且不会处理更之后的块
+        std::vector<int> bad = input;
+        bad[7777] = -7777;
+        bad[3333] = -3333;
+        bad[9999] = -9999;
+        std::atomic<int> calls = 0;
+        auto counted = [&](int x) { calls.fetch_add(1, std::memory_order_relaxed); return check(x); };
+        for (int i = 0; i < 20; ++i) {
+            auto r = C163q::try_transform(par, bad, counted);
+            assert(r.get<1>() == "-3333");
+        }
+        assert(C163q::try_transform(C163q::execution::seq, bad, check).get<1>() == "-3333");
+
+        // first_in_time得到某一个Err，观察到之后整体停止
+        calls = 0;
+        auto t = C163q::try_transform(par, bad, counted, C163q::error_order::first_in_time);
+        const std::string& e = t.get<1>();
+        assert(e == "-3333" || e == "-7777" || e == "-9999");
+        assert(calls <= int(bad.size()));
+    }
+    {
+        // 串行时第一个Err之后的元素不再被处理
+        std::vector<int> bad { 1, 2, -3, 4, -5 };
+        int calls = 0;
+        auto r = C163q::try_transform(C163q::execution::seq, bad, [&](int x) { ++calls; return check(x); });
+        assert(r.get<1>() == "-3" && calls == 3);
+    }
+    {
+        // Result<void, E>以及只能移动的Ok值
+        auto v = C163q::try_transform(par, input, [](int x) {
+            return x >= 0 ? Result<void, int>() : Result<void, int>(std::in_place_index<1>, x);
+        });
+        assert(v.is_ok());
+        auto m = C163q::try_transform(par, std::views::iota(0, 1000), [](int x) {
+            return Result<move_only, int>(std::in_place_index<0>, x);
+        });
+        assert(m.get<0>().size() == 1000 && m.get<0>()[999].value == 999);
+        auto empty = C163q::try_transform(par, std::vector<int>(), check);
+        assert(empty.is_ok() && empty.get<0>().empty());
+    }
+    {
+        long expected = 0;
+        for (int x : input) expected += 2 * x;
+        auto r = C163q::try_transform_reduce(par, input, 0L, std::plus<>(), check);
+        assert(r.get<0>() == expected);
+        assert(C163q::try_transform_reduce(C163q::execution::seq, input, 0L, std::plus<>(), check).get<0>() == expected);
+
+        // 只要求结合律：字符串的拼接保持下标顺序
+        auto digits = [](int x) { return Result<std::string, int>(std::in_place_index<0>, std::to_string(x % 10)); };
+        auto s = C163q::try_transform_reduce(par, std::views::iota(0, 1000), std::string(">"), std::plus<>(), digits);
+        std::string text = ">";
+        for (int i = 0; i < 1000; ++i) text += std::to_string(i % 10);
+        assert(s.get<0>() == text);
+
+        std::vector<int> bad = input;
+        bad[500] = -1;
+        bad[50] = -2;
+        assert(C163q::try_transform_reduce(par, bad, 0L, std::plus<>(), check).get<1>() == "-2");
+    }
+    {
+        // f抛出的异常在调用处重新抛出，线程池依然可用
+        bool caught = false;
+        try {
+            (void) C163q::try_transform(par, input, [](int x) -> Result<int, int> {
+                if (x == 4321) throw std::runtime_error("bad record");
+                return Result<int, int>(std::in_place_index<0>, x);
+            });
+        } catch (const std::runtime_error&) {
+            caught = true;
+        }
+        assert(caught);
+        assert(C163q::try_transform(par, input, check).is_ok());
+    }
+    {
+        // 在线程池的工作线程中调用时，调用者自己也会处理块，不会死锁
+        C163q::thread_pool single(1);
+        struct job {
+            struct promise_type {
+                job get_return_object() noexcept { return {}; }
+                std::suspend_never initial_suspend() const noexcept { return {}; }
+                std::suspend_never final_suspend() const noexcept { return {}; }
+                void return_void() const noexcept {}
+                void unhandled_exception() const noexcept { std::terminate(); }
+            };
+        };
+        std::atomic<bool> done = false;
+        [](C163q::thread_pool& p, const std::vector<int>& in, std::atomic<bool>& d) -> job {
+            co_await p.schedule();
+            auto r = C163q::try_transform(C163q::execution::par.on(p).chunked(10), in, check);
+            assert(r.is_ok());
+            d.store(true);
+            d.notify_all();
+        }(single, input, done);
+        done.wait(false);
+    }
+}
+
+// USAGE: g++ -std=c++20 -pthread -o build/parallel test/src/parallel.cpp src/rs/panic.cpp src/rs/thread_pool.cpp
@@ -0,0 +1,113 @@
+#include"../../include/format/print.hpp"
+#include"../../include/format/span.hpp"
+#include"../../include/format/vector.hpp"
+#include<cassert>
+#include<cerrno>
+#include<cstddef>
+#include<cstdio>
+#include<format>
+#include<iostream>
+#include<numeric>
+#include<span>
+#include<string>
+#include<string_view>
+#include<vector>
+#if __has_include(<unistd.h>)
+#include<unistd.h>
+#endif
+
+namespace {
+    struct chunks {
+        std::string data;
+        size_t calls = 0;
+        size_t largest = 0;
+    };
+
+    void collect(void* context, std::string_view data) noexcept {
+        auto& c = *static_cast<chunks*>(context);
+        c.data += data;
+        ++c.calls;
+        c.largest = std::max(c.largest, data.size());
+    }
+
+    std::string read_all(std::FILE* stream) {
+        std::string ret;
+        std::rewind(stream);
+        char buf[4096];
+        for (size_t n; (n = std::fread(buf, 1, sizeof(buf), stream)) != 0;) ret.append(buf, n);
+        return ret;
+    }
+}
+
+int main() {
+    {
+        // 提供sink时写满后分块输出而不是截断
+        char buf[8];
+        chunks c;
+        C163q::panic_writer writer(buf, sizeof(buf), &collect, &c);
+        writer.write("hello, ");
+        std::format_to(writer.out(), "{}-{}", std::string(20, 'x'), 42);
+        writer.flush();
+        assert(c.data == "hello, " + std::string(20, 'x') + "-42");
+        assert(c.largest == sizeof(buf) && c.calls == 4 && !writer.truncated());
+
+        // 未提供sink时依然截断
+        C163q::panic_writer bounded(buf, sizeof(buf));
+        bounded.write("0123456789");
+        assert(bounded.view() == "01234567" && bounded.truncated());
+    }
+    std::vector<int> big(200'000);
+    std::iota(big.begin(), big.end(), 0);
+    const std::string expected = std::format("{}", big);
+    assert(expected.size() > 4 * C163q::print_buffer_size);
+    {
+        std::FILE* file = std::tmpfile();
+        assert(file);
+        auto r = C163q::print_range(file, big);
+        assert(r.is_ok() && r.get<0>() == expected.size());
+        assert(read_all(file) == expected);
+        std::fclose(file);
+    }
+    {
+        std::FILE* file = std::tmpfile();
+        assert(file);
+        std::vector<double> v{ 1.0, 2.5 };
+        auto r = C163q::print_range(file, std::span(v), "{:<(<v; v>)>|.2f}\n");
+        assert(r.is_ok());
+        auto s = C163q::format_to_file(file, "{} {}\n", "done", 7);
+        assert(s.is_ok() && s.get<0>() == 7);
+        assert(read_all(file) == "(1.00; 2.50)\ndone 7\n");
+        std::fclose(file);
+    }
+#if __has_include(<unistd.h>)
+    {
+        std::FILE* file = std::tmpfile();
+        assert(file);
+        int fd = ::fileno(file);
+        auto r = C163q::format_to_fd(fd, "{}|{}", big, "end");
+        assert(r.is_ok() && r.get<0>() == expected.size() + 4);
+        assert(read_all(file) == expected + "|end");
+        std::fclose(file);
+
+        auto bad = C163q::print_range(-1, big);
+        assert(bad.is_err() && bad.get<1>() == std::errc::bad_file_descriptor);
+    }
+#endif
+#ifdef __GLIBC__
+    {
+        // 写入失败但没有设置errno的流，此时报告EIO，而不是之前残留的errno
+        cookie_io_functions_t io{};
+        io.write = [](void*, const char*, size_t) -> ssize_t { return -1; };
+        std::FILE* file = ::fopencookie(nullptr, "w", io);
+        assert(file);
+        std::setvbuf(file, nullptr, _IONBF, 0);
+        errno = ENOENT;
+        auto r = C163q::format_to_file(file, "{}", 42);
+        assert(r.is_err() && r.get<1>() == std::errc::io_error);
+        std::fclose(file);
+    }
+#endif
+    std::cout << "PASS!" << std::endl;
+}
+
+// USAGE: g++ -std=c++20 -o build/print test/src/print.cpp src/rs/panic.cpp
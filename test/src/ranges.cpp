@@ -0,0 +1,129 @@
+#include"../../include/rs/ranges.hpp"
+#include<algorithm>
+#include<cassert>
+#include<ranges>
+#include<string>
+#include<string_view>
+#include<utility>
+#include<vector>
+
+namespace {
+
+    // 记录复制与移动次数
+    struct counted {
+        static inline int copies = 0;
+        static inline int moves = 0;
+
+        int value;
+
+        counted(int v) : value(v) {}
+        counted(const counted& other) : value(other.value) { ++copies; }
+        counted(counted&& other) noexcept : value(other.value) { ++moves; }
+        counted& operator=(const counted&) = default;
+        counted& operator=(counted&&) = default;
+
+        static void reset() { copies = moves = 0; }
+    };
+
+    C163q::Result<int, std::string> parse(std::string_view s) {
+        int value = 0;
+        for (char c : s) {
+            if (c < '0' || c > '9') return C163q::Err<int>(std::string(s));
+            value = value * 10 + (c - '0');
+        }
+        return C163q::Ok<std::string>(value);
+    }
+
+}
+
+int main() {
+    {
+        // Option作为范围
+        auto x = C163q::Some(1);
+        static_assert(std::ranges::contiguous_range<C163q::Option<int>>);
+        static_assert(std::ranges::sized_range<C163q::Option<int>>);
+        for (int& i : x) i += 1;
+        assert(x.get() == 2);
+        assert(std::ranges::distance(x) == 1);
+        assert(std::ranges::distance(C163q::None<int>()) == 0);
+
+        int y = 3;
+        C163q::Option<int&> ref(y);
+        static_assert(std::ranges::view<C163q::Option<int&>>);
+        static_assert(std::ranges::borrowed_range<C163q::Option<int&>>);
+        for (int& i : ref) i = 4;
+        assert(y == 4);
+        assert(std::ranges::empty(C163q::Option<int&>()));
+
+        std::vector<C163q::Option<int>> options { 1, std::nullopt, 3, std::nullopt };
+        std::vector<int> flat;
+        for (int i : options | std::views::join) flat.push_back(i);
+        assert((flat == std::vector{ 1, 3 }));
+    }
+    {
+        using R = C163q::Result<int, std::string>;
+        std::vector<R> v { C163q::Ok<std::string>(1), C163q::Err<int>(std::string("a")),
+            C163q::Ok<std::string>(3), C163q::Err<int>(std::string("b")) };
+
+        for (int& i : C163q::ok_view(v)) i *= 10;
+        assert(v[0].get<0>() == 10 && v[2].get<0>() == 30);
+
+        std::vector<std::string> errors;
+        for (const auto& e : C163q::err_view(std::as_const(v))) errors.push_back(e);
+        assert((errors == std::vector<std::string>{ "a", "b" }));
+
+        // 元素为临时的Result时按值取出
+        auto oks = C163q::ok_view(std::vector<std::string_view>{ "1", "x", "23" } | std::views::transform(parse));
+        std::vector<int> parsed(oks.begin(), oks.end());
+        assert((parsed == std::vector{ 1, 23 }));
+    }
+    {
+        std::vector<std::string_view> good { "1", "22", "333" };
+        auto r = C163q::collect_result(good | std::views::transform(parse));
+        assert(r.is_ok());
+        assert((r.get<0>() == std::vector{ 1, 22, 333 }));
+
+        // 遇到第一个Err时立即返回
+        int visited = 0;
+        std::vector<std::string_view> bad { "1", "x", "2", "y" };
+        auto e = C163q::collect_result(bad | std::views::transform([&](std::string_view s) {
+            ++visited;
+            return parse(s);
+        }));
+        assert(e.is_err() && e.get<1>() == "x");
+        assert(visited == 2);
+
+        std::vector<C163q::Result<int, std::string>> empty;
+        auto none = C163q::collect_result(empty);
+        assert(none.is_ok() && none.get<0>().empty());
+    }
+    {
+        // 只分配一次内存，并且右值的容器中的值会被移动而不是复制
+        using R = C163q::Result<counted, int>;
+        std::vector<R> v;
+        v.reserve(100);
+        for (int i = 0; i < 100; ++i) v.emplace_back(std::in_place_index<0>, i);
+
+        counted::reset();
+        auto copied = C163q::collect_result(v);
+        assert(copied.is_ok() && copied.get<0>().size() == 100);
+        assert(copied.get<0>().capacity() == 100);
+        assert(counted::copies == 100);
+
+        counted::reset();
+        auto moved = C163q::collect_result(std::move(v));
+        assert(moved.is_ok() && moved.get<0>()[99].value == 99);
+        assert(counted::copies == 0);
+        assert(moved.get<0>().capacity() == 100);
+    }
+    {
+        std::vector<C163q::Result<void, int>> v(3);
+        assert(C163q::collect_result(v).is_ok());
+        v[1] = C163q::Result<void, int>(std::in_place_index<1>, 7);
+        v[2] = C163q::Result<void, int>(std::in_place_index<1>, 8);
+        auto r = C163q::collect_result(v);
+        assert(r.is_err() && r.get<1>() == 7);
+    }
+}
+
+// USAGE: g++ -std=c++20 -o build/ranges test/src/ranges.cpp src/rs/panic.cpp
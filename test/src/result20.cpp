@@ -9,6 +9,8 @@
 #include<initializer_list>
 #include<iterator>
 #include<iostream>
+#include<memory>
+#include<memory_resource>
 #include<numeric>
 #include<optional>
 #include<stdexcept>
@@ -17,12 +19,39 @@
 #include<tuple>
 #include<type_traits>
 #include<utility>
+#include<variant>
 #include<vector>
 
+template<typename T>
+constexpr bool is_trivial_wrapper_v = std::is_trivially_copyable_v<T> &&
+    std::is_trivially_copy_constructible_v<T> && std::is_trivially_move_constructible_v<T> &&
+    std::is_trivially_copy_assignable_v<T> && std::is_trivially_move_assignable_v<T> &&
+    std::is_trivially_destructible_v<T>;
+
+// 记录移动与复制次数的类型
+struct counted {
+    static inline int moves = 0;
+    static inline int copies = 0;
+    int value;
+    explicit counted(int v) : value(v) {}
+    counted(counted&& other) noexcept : value(other.value) { ++moves; }
+    counted(const counted& other) : value(other.value) { ++copies; }
+    counted& operator=(counted&&) = default;
+    counted& operator=(const counted&) = default;
+};
+
 int main() {
 #ifdef MY_CXX23
     C163q::enable_traceback = true;
 #endif // MY_CXX23
+    {
+        static_assert(is_trivial_wrapper_v<C163q::Result<int, int>>);
+        static_assert(is_trivial_wrapper_v<C163q::Result<void, int>>);
+        static_assert(is_trivial_wrapper_v<C163q::Result<const char*, double>>);
+        static_assert(!std::is_trivially_copyable_v<C163q::Result<std::string, int>>);
+        static_assert(!std::is_trivially_destructible_v<C163q::Result<int, std::string>>);
+        static_assert(std::is_nothrow_move_constructible_v<C163q::Result<std::string, int>>);
+    }
     {
         auto x = C163q::Ok<const char*>(-3);
         assert(x.is_ok() == true);
@@ -204,6 +233,29 @@ int main() {
         auto val2 = C163q::result_helper<std::exception>::invoke(f, s2).unwrap_or_default();
         assert(val2 == 0);
     }
+    {
+        auto g = [](int i) noexcept { return i * 2; };
+        static_assert(noexcept(C163q::result_helper<std::exception>::invoke(g, 1)));
+        static_assert(!noexcept(C163q::result_helper<std::exception>::invoke([](int i) { return i; }, 1)));
+        assert(C163q::result_helper<std::exception>::invoke(g, 21).unwrap() == 42);
+
+        int counter = 0;
+        auto h = [&counter]() noexcept { ++counter; };
+        static_assert(std::is_same_v<decltype(C163q::try_invoke(h)), C163q::Result<void, std::exception_ptr>>);
+        assert(C163q::try_invoke(h).is_ok() && counter == 1);
+
+        auto bad = C163q::try_invoke([](const std::string& s) { return std::stoi(s); }, std::string("foo"));
+        static_assert(std::is_same_v<decltype(bad), C163q::Result<int, std::exception_ptr>>);
+        assert(bad.is_err());
+        bool caught = false;
+        try {
+            std::rethrow_exception(bad.unwrap_err());
+        } catch (const std::invalid_argument&) {
+            caught = true;
+        }
+        assert(caught);
+        assert(C163q::try_invoke([](int i) { return i + 1; }, 1).unwrap() == 2);
+    }
     {
         auto x = C163q::Err<const char*>("likely panic");
         const char* val = x.expect_err("Error");
@@ -327,6 +379,110 @@ int main() {
         x.unwrap();
         x.get<0>();
     }
+    {
+        // 可调用对象返回的值可以直接构造在新的Result中（CWG2327，并不保证），最多每一步移动一次，且不会复制
+        counted::moves = counted::copies = 0;
+        auto step = [](counted&& c) { return counted(c.value + 1); };
+        auto r = C163q::Ok<int>(counted(0))
+            .map<counted>(step).map<counted>(step).map<counted>(step).map<counted>(step);
+        assert(r.get<0>().value == 4);
+        assert(counted::moves <= 5 && counted::copies == 0);
+
+        counted::moves = 0;
+        auto e = C163q::Err<int>(counted(0))
+            .map_err<counted>(step).map_err<counted>(step).map_err<counted>(step);
+        assert(e.get<1>().value == 3);
+        assert(counted::moves <= 4 && counted::copies == 0);
+
+        counted::moves = 0;
+        const auto c = C163q::Ok<int>(1);
+        auto m = c.map<counted>([](int i) { return counted(i); });
+        assert(m.get<0>().value == 1 && counted::moves <= 1);
+
+        // 返回值类型不同时仍然转换构造
+        auto d = C163q::Ok<int>(1).map<double>([](int i) { return i * 1.5f; });
+        assert(d.get<0>() == 1.5);
+    }
+    {
+        static_assert(noexcept(std::declval<C163q::Result<int, int>&>().template get_uncheck<0>()));
+        auto x = C163q::Ok<int>(std::string("abc"));
+        assert(x.get_uncheck<0>() == "abc");
+        assert(x.as_const().unwrap_unchecked() == "abc");
+        assert(x.unwrap_unchecked() == "abc" && x.get<0>().empty());
+        auto y = C163q::Err<int>(std::string("err"));
+        assert(y.unwrap_err_unchecked() == "err");
+        C163q::Result<void, int> z;
+        z.unwrap_unchecked();
+        assert((C163q::Result<void, int>(std::in_place_index<1>, 2).get_uncheck<1>() == 2));
+
+        // Result<void, E>右值的and_then：Ok时不传参数调用，Err时传递Err
+        auto next = [] { return C163q::Result<int, int>(std::in_place_index<0>, 7); };
+        assert((C163q::Result<void, int>().and_then<int>(next).get<0>() == 7));
+        auto failed = C163q::Result<void, int>(std::in_place_index<1>, 3).and_then<int>(next);
+        assert(failed.is_err() && failed.get<1>() == 3);
+    }
+    {
+        // 使用allocator_arg构造以及map/and_then时，payload的分配全部来自arena，默认资源不会被使用
+        std::pmr::monotonic_buffer_resource arena;
+        std::pmr::polymorphic_allocator<> alloc(&arena);
+        auto* old_default = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+        using string_result = C163q::Result<std::pmr::string, std::pmr::string>;
+        static_assert(std::uses_allocator_v<string_result, std::pmr::polymorphic_allocator<>>);
+        static_assert(!std::uses_allocator_v<C163q::Result<int, int>, std::pmr::polymorphic_allocator<>>);
+
+        string_result x(std::allocator_arg, alloc, std::in_place_index<0>, 32, 'x');
+        assert(x.get<0>().get_allocator() == alloc);
+        string_result y(std::allocator_arg, alloc, x);
+        assert(y.get<0>() == x.get<0>() && y.get<0>().get_allocator() == alloc);
+        string_result e(std::allocator_arg, alloc, std::in_place_index<1>, "a long error message that allocates");
+        string_result f(std::allocator_arg, alloc, std::move(e));
+        assert(f.get<1>().get_allocator() == alloc);
+
+        // 可调用对象接收alloc时直接构造，否则由返回值以uses-allocator方式构造
+        auto z = x.as_const()
+            .map<std::pmr::string>(std::allocator_arg, alloc, [](const std::pmr::string& s, const auto& a) {
+                std::pmr::string ret(s, a);
+                ret += s;
+                return ret;
+            })
+            .map<std::pmr::string>(std::allocator_arg, alloc, [](std::pmr::string&& s) {
+                s.resize(40);
+                return std::move(s);
+            })
+            .and_then<std::pmr::string>(std::allocator_arg, alloc, [](std::pmr::string&& s, const auto& a) {
+                return string_result(std::allocator_arg, a, std::in_place_index<0>, s.size(), 'y');
+            });
+        assert(std::string_view(z.get<0>()) == std::string(40, 'y') && z.get<0>().get_allocator() == alloc);
+        auto w = f.map<std::pmr::string>(std::allocator_arg, alloc, [](std::pmr::string&& s) { return s; });
+        assert(w.is_err() && w.get<1>().get_allocator() == alloc);
+
+        // 不使用分配器的类型忽略alloc
+        auto n = C163q::Ok<int>(1).map<int>(std::allocator_arg, alloc, [](int i) { return i + 1; });
+        assert(n.get<0>() == 2);
+
+        C163q::Result<void, std::pmr::string> v(std::allocator_arg, alloc, std::in_place_index<1>, 32, 'e');
+        C163q::Result<void, std::pmr::string> v2(std::allocator_arg, alloc, v);
+        assert(v2.get<1>().get_allocator() == alloc);
+
+        // 容器以uses-allocator方式构造元素
+        std::pmr::vector<string_result> vec(alloc);
+        vec.emplace_back(std::in_place_index<0>, "another long string that does not fit in SSO");
+        vec.push_back(x);
+        assert(vec[0].get<0>().get_allocator() == alloc && vec[1].get<0>().get_allocator() == alloc);
+        std::pmr::set_default_resource(old_default);
+    }
+    {
+        // data()在std::variant存储下返回常引用，to_variant()复制保有的值
+        auto x = C163q::Ok<int>(std::vector{ 1, 2, 3 });
+#if !defined(MY_CXX23) || defined(MY_RESULT_VARIANT_STORAGE)
+        static_assert(std::is_same_v<decltype(x.data()), const std::variant<std::vector<int>, int>&>);
+        assert(&std::get<0>(x.data()) == &x.get<0>());
+#endif
+        auto v = x.to_variant();
+        assert(std::get<0>(v).size() == 3 && x.get<0>().size() == 3);
+        assert((std::get<1>(C163q::Err<std::vector<int>>(4).to_variant()) == 4));
+        assert((C163q::Result<void, int>().to_variant().index() == 0));
+    }
     std::cout << "PASS!" << std::endl;
 }
 
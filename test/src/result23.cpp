@@ -0,0 +1,56 @@
+#include"../../include/rs/result23.hpp"
+#include"../../include/core/config.hpp"
+#include<cassert>
+#include<expected>
+#include<iostream>
+#include<string>
+#include<string_view>
+#include<type_traits>
+#include<utility>
+#include<variant>
+
+int main() {
+#ifndef MY_RESULT_VARIANT_STORAGE
+    // std::expected存储中并不存在std::variant，data()为了兼容依然可用（已弃用），返回复制得到的值
+    static_assert(std::is_same_v<decltype(std::declval<const C163q::Result<std::string, int>&>().to_variant()),
+            std::variant<std::string, int>>);
+    assert(std::get<0>(C163q::Ok<int>(std::string("x")).to_variant()) == "x");
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+    assert(std::get<0>(C163q::Ok<int>(std::string("y")).data()) == "y");
+    assert(std::get<1>(C163q::Result<void, std::string>(std::in_place_index<1>, "e").data()) == "e");
+#pragma GCC diagnostic pop
+#endif
+#ifndef MY_RESULT_VARIANT_STORAGE
+    static_assert(sizeof(C163q::Result<int, int>) == sizeof(std::expected<int, int>));
+    static_assert(sizeof(C163q::Result<void, int>) == sizeof(std::expected<void, int>));
+#endif // !MY_RESULT_VARIANT_STORAGE
+    {
+        constexpr auto x = C163q::Ok<int>(2).map<int>([](int v) { return v * 3; });
+        static_assert(x.is_ok() && x.get<0>() == 6);
+
+        constexpr auto y = C163q::Err<int>(5).and_then<int>([](int v) { return C163q::Ok<int>(v); });
+        static_assert(y.is_err() && y.get<1>() == 5);
+    }
+    {
+        auto x = C163q::Ok<std::string_view>(std::string("foo"));
+        x.assign(C163q::Err<std::string>(std::string_view("bar")));
+        assert(x.is_err() && x.get<1>() == "bar");
+        x.assign(C163q::Ok<std::string_view>(std::string("baz")));
+        assert(x.unwrap() == "baz");
+    }
+    {
+        std::expected<int, const char*> e(1);
+        assert(C163q::from_expected(std::move(e)).unwrap() == 1);
+
+        auto x = C163q::Err<int>("error");
+        assert(C163q::to_expected(std::move(x)).error() == std::string_view("error"));
+
+        auto y = C163q::from_expected(std::expected<void, int>(std::unexpect, 3));
+        assert(y.is_err() && y.get<1>() == 3);
+        assert(C163q::to_expected(C163q::Result<void, int>()).has_value());
+    }
+    std::cout << "PASS!" << std::endl;
+}
+
+// USAGE: g++ -std=c++23 -o build/result23 test/src/result23.cpp src/rs/panic.cpp -lstdc++exp
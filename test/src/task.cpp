@@ -0,0 +1,200 @@
+#include"../../include/rs/task.hpp"
+#include"../../include/rs/panic.hpp"
+#include"../../include/rs/result.hpp"
+#include<atomic>
+#include<cassert>
+#include<chrono>
+#include<stdexcept>
+#include<stop_token>
+#include<string>
+#include<string_view>
+#include<thread>
+#include<tuple>
+
+namespace {
+
+    using C163q::Result;
+    using C163q::task;
+
+    C163q::Result<int, std::string> parse(std::string_view s) {
+        if (s.empty()) return C163q::Err<int>(std::string("empty"));
+        int value = 0;
+        for (char c : s) {
+            if (c < '0' || c > '9') return C163q::Err<int>(std::string("bad digit"));
+            value = value * 10 + (c - '0');
+        }
+        return C163q::Ok<std::string>(value);
+    }
+
+    struct tracked {
+        static inline std::atomic<int> alive = 0;
+        tracked() { ++alive; }
+        ~tracked() { --alive; }
+    };
+
+    task<int> answer() {
+        co_return 42;
+    }
+
+    task<int> twice() {
+        int a = co_await answer();
+        int b = co_await answer();
+        co_return a + b;
+    }
+
+    task<> nothing(int& out) {
+        out = co_await twice();
+    }
+
+    // co_await Result为Err时task直接以该Err结束
+    task<Result<int, std::string>> sum(std::string_view a, std::string_view b) {
+        tracked t;
+        int x = co_await parse(a);
+        int y = co_await parse(b);
+        co_return x + y;
+    }
+
+    task<Result<void, std::string>> check(std::string_view s) {
+        co_await sum(s, "0");           // 得到Result，不会提前返回
+        co_await parse(s);
+    }
+
+    task<int> throws() {
+        co_await answer();
+        throw std::runtime_error("thrown in task");
+    }
+
+    task<int> panics() {
+        co_await answer();
+        panic("panic in task");
+    }
+
+    // 在线程池中运行的子任务
+    task<Result<int, std::string>> work(C163q::thread_pool& pool, int value, std::atomic<int>& ran) {
+        co_await pool.schedule();
+        assert(C163q::thread_pool::current() == &pool);
+        ran.fetch_add(1);
+        if (value < 0) co_return C163q::Err<int>(std::string("negative"));
+        co_return value;
+    }
+
+    // 等待停止请求的子任务，没有停止请求时超时返回Ok
+    task<Result<int, std::string>> waits_for_stop(C163q::thread_pool& pool, std::atomic<int>& cancelled) {
+        co_await pool.schedule();
+        std::stop_token stop = co_await C163q::current_stop_token();
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (!stop.stop_requested() && std::chrono::steady_clock::now() < deadline) std::this_thread::yield();
+        if (stop.stop_requested()) {
+            cancelled.fetch_add(1);
+            co_return C163q::Err<int>(std::string("cancelled"));
+        }
+        co_return 0;
+    }
+
+    task<Result<int, std::string>> fails_later(C163q::thread_pool& pool) {
+        co_await pool.schedule();
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        co_return C163q::Err<int>(std::string("failed"));
+    }
+
+    task<Result<int, std::string>> total(C163q::thread_pool& pool, std::atomic<int>& ran) {
+        auto [a, b, c] = co_await co_await C163q::when_all(work(pool, 1, ran), work(pool, 2, ran), work(pool, 3, ran));
+        co_return a + b + c;
+    }
+
+    // 递归地并行求和，检查工作窃取在大量任务下的正确性
+    task<Result<long, std::string>> range_sum(C163q::thread_pool& pool, long lo, long hi) {
+        if (hi - lo <= 64) {
+            long s = 0;
+            for (long i = lo; i < hi; ++i) s += i;
+            co_return s;
+        }
+        long mid = lo + (hi - lo) / 2;
+        auto [l, r] = co_await co_await C163q::when_all(range_sum(pool, lo, mid), range_sum(pool, mid, hi));
+        co_return l + r;
+    }
+
+    task<Result<long, std::string>> parallel_sum(C163q::thread_pool& pool, long n) {
+        co_await pool.schedule();
+        co_return co_await range_sum(pool, 0, n);
+    }
+}
+
+int main() {
+    {
+        assert(C163q::sync_wait(answer()) == 42);
+        assert(C163q::sync_wait(twice()) == 84);
+        int out = 0;
+        C163q::sync_wait(nothing(out));
+        assert(out == 84);
+    }
+    {
+        assert(C163q::sync_wait(sum("12", "30")).get<0>() == 42);
+        assert(C163q::sync_wait(sum("12", "x")).get<1>() == "bad digit");
+        assert(C163q::sync_wait(sum("", "1")).get<1>() == "empty");
+        assert(tracked::alive == 0);
+        assert(C163q::sync_wait(check("7")).is_ok());
+        assert(C163q::sync_wait(check("?")).get<1>() == "bad digit");
+        // 未运行的task被析构时销毁协程帧
+        { auto t = sum("1", "2"); }
+        assert(tracked::alive == 0);
+    }
+    {
+        bool caught = false;
+        try {
+            (void) C163q::sync_wait(throws());
+        } catch (const std::runtime_error& e) {
+            caught = std::string_view(e.what()) == "thrown in task";
+        }
+        assert(caught);
+    }
+    C163q::thread_pool pool(4);
+    {
+        // 任务中的panic在任务边界被捕获，工作线程不受影响
+        C163q::set_panic_strategy(C163q::panic_strategy::unwind);
+        C163q::set_panic_hook([](const C163q::panic_info&) {});
+        bool caught = false;
+        try {
+            (void) C163q::sync_wait(pool, panics());
+        } catch (const C163q::panic_error&) {
+            caught = true;
+        }
+        assert(caught);
+        assert(C163q::sync_wait(pool, twice()) == 84);
+    }
+    {
+        std::atomic<int> ran = 0;
+        assert(C163q::sync_wait(total(pool, ran)).get<0>() == 6);
+        assert(ran == 3);
+        // 不在线程池中时依次运行
+        ran = 0;
+        auto r = C163q::sync_wait(C163q::when_all(work(pool, 1, ran), work(pool, -1, ran)));
+        assert(r.get<1>() == "negative");
+        assert(ran == 2);
+    }
+    {
+        // 一个子任务失败时，其他正在运行的子任务收到停止请求
+        std::atomic<int> cancelled = 0;
+        auto start = std::chrono::steady_clock::now();
+        auto r = C163q::sync_wait(pool, C163q::when_all(waits_for_stop(pool, cancelled), fails_later(pool),
+                    waits_for_stop(pool, cancelled)));
+        assert(r.get<1>() == "failed");
+        assert(cancelled == 2);
+        assert(std::chrono::steady_clock::now() - start < std::chrono::seconds(5));
+    }
+    {
+        // 当前线程中依次运行时，第一个失败之后的子任务不再开始
+        std::atomic<int> ran = 0;
+        auto inline_fail = []() -> task<Result<int, std::string>> { co_return C163q::Err<int>(std::string("first")); };
+        auto r = C163q::sync_wait(C163q::when_all(inline_fail(), work(pool, 1, ran)));
+        assert(r.get<1>() == "first" && ran == 0);
+    }
+    {
+        constexpr long n = 1 << 16;
+        for (int i = 0; i < 4; ++i) {
+            assert(C163q::sync_wait(parallel_sum(pool, n)).get<0>() == n * (n - 1) / 2);
+        }
+    }
+}
+
+// USAGE: g++ -std=c++20 -pthread -o build/task test/src/task.cpp src/rs/panic.cpp src/rs/thread_pool.cpp
@@ -0,0 +1,98 @@
+#include"../../include/rs/thread_pool.hpp"
+#include<atomic>
+#include<cassert>
+#include<chrono>
+#include<coroutine>
+#include<cstddef>
+#include<optional>
+#include<thread>
+#include<vector>
+
+namespace {
+
+    // 每次被恢复时计数，并检查运行在线程池的工作线程中
+    struct counter_coroutine {
+        struct promise_type {
+            counter_coroutine get_return_object() noexcept { return {}; }
+            std::suspend_never initial_suspend() const noexcept { return {}; }
+            std::suspend_never final_suspend() const noexcept { return {}; }
+            void return_void() const noexcept {}
+            void unhandled_exception() const noexcept { std::terminate(); }
+        };
+    };
+
+    counter_coroutine hop(C163q::thread_pool& pool, std::atomic<int>& done, int depth) {
+        co_await pool.schedule();
+        assert(C163q::thread_pool::current() == &pool);
+        // 在工作线程中提交的协程进入该线程自己的队列，由其他线程窃取
+        if (depth > 0) {
+            hop(pool, done, depth - 1);
+            hop(pool, done, depth - 1);
+        }
+        done.fetch_add(1, std::memory_order_relaxed);
+        done.notify_all();
+    }
+}
+
+int main() {
+    {
+        // 所属线程后进先出，窃取者先进先出
+        C163q::chase_lev_deque<int*> deque(2);
+        int values[10];
+        for (int i = 0; i < 10; ++i) deque.push(&values[i]);      // 需要扩容
+        assert(deque.size() == 10);
+        assert(deque.pop() == &values[9]);
+        assert(deque.steal() == &values[0]);
+        assert(deque.steal() == &values[1]);
+        for (int i = 8; i >= 2; --i) assert(deque.pop() == &values[i]);
+        assert(deque.empty() && !deque.pop() && !deque.steal());
+    }
+    {
+        // 一个所属线程与多个窃取者同时访问时，每个元素恰好被取出一次
+        constexpr int total = 200000;
+        std::vector<int> items(total);
+        std::vector<std::atomic<int>> seen(total);
+        C163q::chase_lev_deque<int*> deque(16);
+        std::atomic<bool> finished = false;
+        std::vector<std::thread> thieves;
+        for (int t = 0; t < 3; ++t) {
+            thieves.emplace_back([&] {
+                while (!finished.load(std::memory_order_acquire) || !deque.empty()) {
+                    if (auto p = deque.steal()) seen[*p - items.data()].fetch_add(1, std::memory_order_relaxed);
+                }
+            });
+        }
+        for (int i = 0; i < total; ++i) {
+            deque.push(&items[i]);
+            if (i % 3 == 0) {
+                if (auto p = deque.pop()) seen[*p - items.data()].fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        while (auto p = deque.pop()) seen[*p - items.data()].fetch_add(1, std::memory_order_relaxed);
+        finished.store(true, std::memory_order_release);
+        for (auto& t : thieves) t.join();
+        for (auto& s : seen) assert(s.load() == 1);
+    }
+    {
+        assert(C163q::thread_pool::current() == nullptr);
+        C163q::thread_pool pool(4);
+        assert(pool.size() == 4);
+        std::atomic<int> done = 0;
+        constexpr int roots = 8, depth = 10;
+        for (int i = 0; i < roots; ++i) hop(pool, done, depth);
+        constexpr int expected = roots * ((1 << (depth + 1)) - 1);
+        for (int n = done.load(); n != expected; n = done.load()) done.wait(n);
+    }
+    {
+        // 没有工作线程空闲等待之后，新提交的协程依然会被运行
+        C163q::thread_pool pool(2);
+        std::atomic<int> done = 0;
+        for (int i = 0; i < 100; ++i) {
+            hop(pool, done, 0);
+            for (int n = done.load(); n != i + 1; n = done.load()) done.wait(n);
+            if (i % 10 == 0) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+}
+
+// USAGE: g++ -std=c++20 -pthread -o build/thread_pool test/src/thread_pool.cpp src/rs/thread_pool.cpp